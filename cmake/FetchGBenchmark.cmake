@@ -0,0 +1,26 @@
+cmake_minimum_required(VERSION 3.11)
+
+#
+# Prefer an installed Google Benchmark; fetch and build it otherwise.
+#
+find_package(benchmark QUIET)
+
+if(NOT benchmark_FOUND)
+  include(FetchContent)
+
+  set(BENCHMARK_ENABLE_TESTING OFF CACHE BOOL "" FORCE)
+  set(BENCHMARK_ENABLE_GTEST_TESTS OFF CACHE BOOL "" FORCE)
+  set(BENCHMARK_ENABLE_INSTALL OFF CACHE BOOL "" FORCE)
+
+  FetchContent_Declare(
+    googlebenchmark
+    GIT_REPOSITORY https://github.com/google/benchmark.git
+    GIT_TAG        v1.8.3
+  )
+
+  FetchContent_GetProperties(googlebenchmark)
+  if(NOT googlebenchmark_POPULATED)
+    FetchContent_Populate(googlebenchmark)
+    add_subdirectory(${googlebenchmark_SOURCE_DIR} ${googlebenchmark_BINARY_DIR})
+  endif()
+endif()
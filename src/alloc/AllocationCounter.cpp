@@ -0,0 +1,121 @@
+#include "AllocationCounter.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#if defined(_MSC_VER)
+#include <malloc.h>
+#endif
+
+namespace
+{
+    std::atomic<bool>     g_counting{false};
+    std::atomic<uint64_t> g_allocationCount{0};
+    std::atomic<uint64_t> g_allocatedBytes{0};
+
+    void Count(size_t size)
+    {
+        if (g_counting.load(std::memory_order_relaxed))
+        {
+            g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+            g_allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+        }
+    }
+
+    void* Allocate(size_t size)
+    {
+        Count(size);
+        return std::malloc(size ? size : 1);
+    }
+
+    void* AllocateAligned(size_t size, std::align_val_t alignment)
+    {
+        Count(size);
+
+        const size_t Alignment{static_cast<size_t>(alignment)};
+#if defined(_MSC_VER)
+        return _aligned_malloc(size ? size : 1, Alignment);
+#else
+        //
+        // aligned_alloc wants the size to be a multiple of the alignment.
+        //
+        const size_t Rounded{(size + Alignment - 1) / Alignment * Alignment};
+        return std::aligned_alloc(Alignment, Rounded ? Rounded : Alignment);
+#endif
+    }
+
+    void FreeAligned(void* p)
+    {
+#if defined(_MSC_VER)
+        _aligned_free(p);
+#else
+        std::free(p);
+#endif
+    }
+}
+
+namespace gol
+{
+    void SetAllocationCounting(bool enabled)
+    {
+        g_counting.store(enabled, std::memory_order_relaxed);
+    }
+
+    uint64_t AllocationCount()
+    {
+        return g_allocationCount.load(std::memory_order_relaxed);
+    }
+
+    uint64_t AllocatedBytes()
+    {
+        return g_allocatedBytes.load(std::memory_order_relaxed);
+    }
+}
+
+void* operator new(size_t size)
+{
+    void* p = Allocate(size);
+    if (!p) { throw std::bad_alloc(); }
+    return p;
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    return Allocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    return Allocate(size);
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+    void* p = AllocateAligned(size, alignment);
+    if (!p) { throw std::bad_alloc(); }
+    return p;
+}
+
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+    return operator new(size, alignment);
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+
+void operator delete(void* p, std::align_val_t) noexcept { FreeAligned(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { FreeAligned(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { FreeAligned(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { FreeAligned(p); }
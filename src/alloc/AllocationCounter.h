@@ -0,0 +1,23 @@
+//
+// Counts heap allocations made through the global operator new, so that
+// programs can report how much memory an operation churns through.
+//
+// Linking this in replaces operator new for the whole program. Counting is
+// off until enabled, which leaves a single relaxed load per allocation.
+//
+
+#pragma once
+
+#include <cstdint>
+
+namespace gol
+{
+    void SetAllocationCounting(bool enabled);
+
+    //
+    // Allocations and bytes requested from operator new while counting was
+    // enabled.
+    //
+    uint64_t AllocationCount();
+    uint64_t AllocatedBytes();
+}
@@ -0,0 +1,306 @@
+//
+// Benchmarks for each engine over the pattern corpus in inputs/.
+//
+// Construction, stepping and dumping the live cells are measured separately.
+// Each reports cells per second and the bytes requested from operator new
+// per iteration. For stepping, a cell is one live cell in one generation.
+//
+
+#include <alloc/AllocationCounter.h>
+#include <lib/ClusteredGrid.h>
+#include <lib/DenseGrid.h>
+#include <lib/GOLGrid.h>
+#include <lib/HashLifeGrid.h>
+#include <lib/LifeParser.h>
+#include <lib/LifeWriter.h>
+#include <lib/TiledGrid.h>
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+    const char* const Corpus[] = {
+        "sample",
+        "clusters",
+        "rpentomino",
+        "acorn",
+        "gosper_gun",
+        "switch_engine",
+        "soup_d10",
+        "soup_d30",
+        "soup_d50",
+    };
+
+    //
+    // Each stepping iteration runs this many generations from the pattern's
+    // starting state, so that growing patterns don't make later iterations
+    // more expensive than earlier ones.
+    //
+    constexpr size_t GenerationsPerStep{100};
+
+#if defined(_WIN32)
+    const char* const NullDevice = "NUL";
+#else
+    const char* const NullDevice = "/dev/null";
+#endif
+
+    //
+    // The dense engine on a bounded board just large enough that nothing can
+    // reach its edges: patterns grow by at most one cell per generation in
+    // each direction.
+    //
+    class PaddedDenseGrid : public gol::DenseGrid
+    {
+    public:
+        PaddedDenseGrid(const std::vector<gol::CellAddress>& cells)
+            : DenseGrid(cells, BoundsOf(cells))
+        {
+        }
+
+    private:
+        static gol::DenseBounds BoundsOf(const std::vector<gol::CellAddress>& cells)
+        {
+            constexpr int64_t Margin{static_cast<int64_t>(GenerationsPerStep) + 1};
+
+            gol::CellAddress min{cells.front()};
+            gol::CellAddress max{cells.front()};
+            for (const auto& Address : cells)
+            {
+                min.first = std::min(min.first, Address.first);
+                min.second = std::min(min.second, Address.second);
+                max.first = std::max(max.first, Address.first);
+                max.second = std::max(max.second, Address.second);
+            }
+
+            gol::DenseBounds bounds;
+            bounds.Origin = gol::CellAddress(min.first - Margin, min.second - Margin);
+            bounds.Width = max.first - min.first + 1 + 2 * Margin;
+            bounds.Height = max.second - min.second + 1 + 2 * Margin;
+            return bounds;
+        }
+    };
+
+    template<typename GridType>
+    size_t CountLiveCells(const GridType& grid)
+    {
+        size_t numLive{0};
+        grid.ForEachLiveCell([&numLive](const gol::CellAddress&) { ++numLive; });
+        return numLive;
+    }
+
+    void ReportAllocations(benchmark::State& state, uint64_t allocatedBytes)
+    {
+        state.counters["bytes_allocated"] = benchmark::Counter(
+            static_cast<double>(allocatedBytes),
+            benchmark::Counter::kAvgIterations);
+    }
+
+    template<typename GridType>
+    void BM_Construct(
+        benchmark::State& state,
+        const std::vector<gol::CellAddress>& cells)
+    {
+        const uint64_t AllocatedBefore{gol::AllocatedBytes()};
+        for (auto _ : state)
+        {
+            GridType grid(cells);
+            benchmark::DoNotOptimize(&grid);
+        }
+
+        state.SetItemsProcessed(state.iterations() * cells.size());
+        ReportAllocations(state, gol::AllocatedBytes() - AllocatedBefore);
+    }
+
+    template<typename GridType>
+    void BM_Step(
+        benchmark::State& state,
+        const std::vector<gol::CellAddress>& cells)
+    {
+        //
+        // Every iteration covers the same generations, so the cell count
+        // only needs working out once.
+        //
+        size_t cellsPerIteration{0};
+        {
+            GridType grid(cells);
+            for (size_t i = 0; i < GenerationsPerStep; ++i)
+            {
+                grid.AdvanceGeneration();
+                cellsPerIteration += CountLiveCells(grid);
+            }
+        }
+
+        uint64_t allocatedBytes{0};
+        for (auto _ : state)
+        {
+            state.PauseTiming();
+            auto pGrid = std::make_unique<GridType>(cells);
+            const uint64_t AllocatedBefore{gol::AllocatedBytes()};
+            state.ResumeTiming();
+
+            for (size_t i = 0; i < GenerationsPerStep; ++i)
+            {
+                pGrid->AdvanceGeneration();
+            }
+
+            state.PauseTiming();
+            allocatedBytes += gol::AllocatedBytes() - AllocatedBefore;
+            pGrid.reset();
+            state.ResumeTiming();
+        }
+
+        state.SetItemsProcessed(state.iterations() * cellsPerIteration);
+        ReportAllocations(state, allocatedBytes);
+    }
+
+    template<typename GridType>
+    void BM_Dump(
+        benchmark::State& state,
+        const std::vector<gol::CellAddress>& cells)
+    {
+        std::unique_ptr<std::FILE, int(*)(std::FILE*)> pFile(
+            std::fopen(NullDevice, "wb"),
+            &std::fclose);
+        if (!pFile)
+        {
+            state.SkipWithError("Couldn't open the null device.");
+            return;
+        }
+
+        //
+        // Dump a generation which has had a chance to spread out a little.
+        //
+        GridType grid(cells);
+        for (size_t i = 0; i < GenerationsPerStep; ++i) { grid.AdvanceGeneration(); }
+        const size_t NumLive{CountLiveCells(grid)};
+
+        const uint64_t AllocatedBefore{gol::AllocatedBytes()};
+        for (auto _ : state)
+        {
+            gol::LifeWriter writer(pFile.get());
+            writer.WriteSignature();
+            grid.ForEachLiveCell([&writer](const gol::CellAddress& address)
+            {
+                writer.WriteCell(address);
+            });
+            writer.Flush();
+        }
+
+        state.SetItemsProcessed(state.iterations() * NumLive);
+        ReportAllocations(state, gol::AllocatedBytes() - AllocatedBefore);
+    }
+
+    //
+    // Boards far bigger than the L2 cache, stepped one generation at a time
+    // or in temporally blocked strips. Only the board's size matters to the
+    // dense kernel, not how many cells are alive.
+    //
+    void BM_DenseLargeBoard(benchmark::State& state, bool blocked)
+    {
+        constexpr int64_t Size{8192};
+        constexpr uint64_t NumGenerations{32};
+
+        gol::DenseBounds bounds;
+        bounds.Width = Size;
+        bounds.Height = Size;
+        bounds.Topology = gol::DenseTopology::Torus;
+
+        std::vector<gol::CellAddress> cells;
+        for (int64_t y = 0; y < Size; y += 7)
+        {
+            for (int64_t x = y % 3; x < Size; x += 3) { cells.emplace_back(x, y); }
+        }
+
+        gol::DenseGrid grid(cells, bounds);
+        for (auto _ : state)
+        {
+            if (blocked)
+            {
+                grid.AdvanceGenerations(NumGenerations);
+            }
+            else
+            {
+                for (uint64_t i = 0; i < NumGenerations; ++i) { grid.AdvanceGeneration(); }
+            }
+        }
+
+        state.SetItemsProcessed(state.iterations() * NumGenerations * Size * Size);
+    }
+
+    template<typename GridType>
+    void RegisterEngine(
+        const std::string& engine,
+        const std::string& pattern,
+        const std::vector<gol::CellAddress>& cells)
+    {
+        const std::string Suffix{"/" + engine + "/" + pattern};
+        benchmark::RegisterBenchmark(
+            ("Construct" + Suffix).c_str(), BM_Construct<GridType>, cells);
+        benchmark::RegisterBenchmark(
+            ("Step" + Suffix).c_str(), BM_Step<GridType>, cells)
+            ->Unit(benchmark::kMillisecond);
+        benchmark::RegisterBenchmark(
+            ("Dump" + Suffix).c_str(), BM_Dump<GridType>, cells);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    benchmark::Initialize(&argc, argv);
+    gol::SetAllocationCounting(true);
+
+    //
+    // The corpus is loaded up front and shared by every benchmark; parsing
+    // isn't part of what's being measured here.
+    //
+    std::vector<std::vector<gol::CellAddress>> patterns;
+    patterns.reserve(std::size(Corpus));
+    for (const auto* pName : Corpus)
+    {
+        const std::string Path{std::string(GOL_BENCH_INPUTS_DIR) + "/" + pName + ".life"};
+
+        std::vector<gol::CellAddress> cells;
+        gol::LifeParseError error;
+        if (!gol::ParseLifeFile(Path, cells, error))
+        {
+            std::cerr << "Failed to load " << Path << ": " << error.Message;
+            if (error.Line) { std::cerr << " (line " << error.Line << ")"; }
+            std::cerr << std::endl;
+            return -1;
+        }
+
+        patterns.push_back(std::move(cells));
+    }
+
+    for (size_t i = 0; i < patterns.size(); ++i)
+    {
+        RegisterEngine<gol::GOLGrid>("sparse", Corpus[i], patterns[i]);
+        RegisterEngine<gol::TiledGrid>("tiled", Corpus[i], patterns[i]);
+        RegisterEngine<gol::HashLifeGrid>("hashlife", Corpus[i], patterns[i]);
+        RegisterEngine<gol::ClusteredGrid>("clustered", Corpus[i], patterns[i]);
+
+        //
+        // sample.life spans trillions of cells; no dense board covers it.
+        //
+        if (std::string(Corpus[i]) != "sample")
+        {
+            RegisterEngine<PaddedDenseGrid>("dense", Corpus[i], patterns[i]);
+        }
+    }
+
+    benchmark::RegisterBenchmark("StepLargeBoard/dense/stepped", BM_DenseLargeBoard, false)
+        ->Unit(benchmark::kMillisecond);
+    benchmark::RegisterBenchmark("StepLargeBoard/dense/blocked", BM_DenseLargeBoard, true)
+        ->Unit(benchmark::kMillisecond);
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
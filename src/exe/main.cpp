@@ -6,29 +6,406 @@
 // compatible format.
 //
 
+#include <algorithm>
 #include <cassert>
-#include <fstream>
+#include <chrono>
+#include <cstdio>
 #include <iostream>
+#include <limits>
 #include <memory>
 
 #include <bitset>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
 
+#include <alloc/AllocationCounter.h>
+#include <lib/BackgroundWriter.h>
+#include <lib/Batch.h>
 #include <lib/Cell.h>
+#include <lib/Checkpoint.h>
+#include <lib/ClusteredGrid.h>
+#include <lib/DenseGrid.h>
+#include <lib/DeltaStream.h>
 #include <lib/GOLGrid.h>
+#include <lib/HashLifeGrid.h>
+#include <lib/LifeParser.h>
+#include <lib/LifeWriter.h>
+#include <lib/Rule.h>
+#include <lib/Sharded.h>
+#include <lib/StatsWriter.h>
+#include <lib/TiledGrid.h>
 
 void PrintUsage(const std::string& progName)
 {
-    std::cerr << "Usage: " << progName << " <input_path> <num_iterations>"
+    std::cerr << "Usage: " << progName
+              << " [--engine sparse|tiled|hashlife|clustered] [--threads N] [--unsorted]"
+              << " [--checkpoint-every N] [--resume checkpoint_path]"
+              << " [--deltas path] [--delta-format text|binary]"
+              << " [--no-cycle-detection] [--no-freeze] [--stats path]"
+              << " [--rule B3/S23] [--bounded WxH[@X,Y] | --torus WxH[@X,Y]]"
+              << " [--pipeline] [--memory-budget MB [--spill-dir path]] [--shards N]"
+              << " <input_path> <num_iterations>"
+              << std::endl;
+    std::cerr << "       " << progName
+              << " --batch [--batch-cells] [--threads N] [--no-cycle-detection]"
+              << " [--no-freeze] [--rule B3/S23]"
+              << " <manifest_or_directory> <num_iterations>"
               << std::endl;
 }
 
-const std::string LifeSignature("#Life 1.06");
+struct Options
+{
+    std::string InputPath;
+    std::string NumIterations;
+    std::string Engine{"sparse"};
+    size_t      NumThreads{1};
+    bool        Sorted{true};
+    uint64_t    CheckpointEvery{0};
+    std::string ResumePath;
+    std::string DeltaPath;
+    std::string DeltaFormat{"text"};
+    bool        DetectCycles{true};
+    bool        FreezeRegions{true};
+    std::string StatsPath;
+    gol::Rule   Rule{gol::ConwayRule};
+
+    //
+    // A Width of 0 means no board was given, i.e. the plane is unbounded.
+    //
+    gol::DenseBounds Bounds;
+
+    //
+    // Overlaps loading with building the grid, and writing checkpoints and
+    // deltas with computing the next generations.
+    //
+    bool        Pipeline{false};
+
+    //
+    // In megabytes; 0 means no budget. Spill files go to the system's
+    // temporary directory unless SpillDirectory says otherwise.
+    //
+    uint64_t    MemoryBudget{0};
+    std::string SpillDirectory;
+
+    //
+    // In batch mode, InputPath is a manifest or directory of inputs.
+    //
+    bool        Batch{false};
+    bool        BatchCells{false};
+
+    //
+    // Number of worker processes to split the plane between; 0 runs
+    // everything in this process.
+    //
+    size_t      NumShards{0};
+
+    //
+    // Checkpoints overwrite the one being resumed from, or otherwise sit
+    // beside the input.
+    //
+    std::string CheckpointPath() const
+    {
+        return ResumePath.empty() ? InputPath + ".ckpt" : ResumePath;
+    }
+};
+
+//
+// Flags may appear anywhere; the first two remaining arguments are the input
+// path and iteration count.
+//
+bool ParseOptions(int argc, char** argv, Options& options)
+{
+    std::vector<std::string> positional;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string Arg(argv[i]);
+        if (Arg == "--engine" && i + 1 < argc)
+        {
+            options.Engine = argv[++i];
+        }
+        else if (Arg == "--threads" && i + 1 < argc)
+        {
+            try
+            {
+                options.NumThreads = std::stoul(argv[++i]);
+            }
+            catch (std::exception& /*e*/)
+            {
+                options.NumThreads = 0;
+            }
+
+            if (!options.NumThreads)
+            {
+                std::cerr << "Invalid threads parameter." << std::endl;
+                return false;
+            }
+        }
+        else if (Arg == "--unsorted")
+        {
+            options.Sorted = false;
+        }
+        else if (Arg == "--sorted")
+        {
+            //
+            // The default; still accepted so existing scripts keep working.
+            //
+            options.Sorted = true;
+        }
+        else if (Arg == "--checkpoint-every" && i + 1 < argc)
+        {
+            const std::string Value(argv[++i]);
+            try
+            {
+                if (Value.find('-') != std::string::npos)
+                {
+                    throw std::invalid_argument(Value);
+                }
+                options.CheckpointEvery = std::stoull(Value);
+            }
+            catch (std::exception& /*e*/)
+            {
+                options.CheckpointEvery = 0;
+            }
+
+            if (!options.CheckpointEvery)
+            {
+                std::cerr << "Invalid checkpoint-every parameter." << std::endl;
+                return false;
+            }
+        }
+        else if (Arg == "--resume" && i + 1 < argc)
+        {
+            options.ResumePath = argv[++i];
+        }
+        else if (Arg == "--deltas" && i + 1 < argc)
+        {
+            options.DeltaPath = argv[++i];
+        }
+        else if (Arg == "--delta-format" && i + 1 < argc)
+        {
+            options.DeltaFormat = argv[++i];
+        }
+        else if (Arg == "--no-cycle-detection")
+        {
+            options.DetectCycles = false;
+        }
+        else if (Arg == "--no-freeze")
+        {
+            options.FreezeRegions = false;
+        }
+        else if (Arg == "--stats" && i + 1 < argc)
+        {
+            options.StatsPath = argv[++i];
+        }
+        else if (Arg == "--rule" && i + 1 < argc)
+        {
+            std::string error;
+            if (!gol::ParseRule(argv[++i], options.Rule, error))
+            {
+                std::cerr << error << std::endl;
+                return false;
+            }
+        }
+        else if ((Arg == "--bounded" || Arg == "--torus") && i + 1 < argc)
+        {
+            const auto Topology = Arg == "--torus" ?
+                gol::DenseTopology::Torus :
+                gol::DenseTopology::Bounded;
+
+            std::string error;
+            if (!gol::ParseDenseBounds(argv[++i], Topology, options.Bounds, error))
+            {
+                std::cerr << error << std::endl;
+                return false;
+            }
+        }
+        else if (Arg == "--pipeline")
+        {
+            options.Pipeline = true;
+        }
+        else if (Arg == "--memory-budget" && i + 1 < argc)
+        {
+            const std::string Value(argv[++i]);
+            try
+            {
+                if (Value.find('-') != std::string::npos)
+                {
+                    throw std::invalid_argument(Value);
+                }
+                options.MemoryBudget = std::stoull(Value);
+            }
+            catch (std::exception& /*e*/)
+            {
+                options.MemoryBudget = 0;
+            }
+
+            if (!options.MemoryBudget ||
+                options.MemoryBudget > (std::numeric_limits<size_t>::max() >> 20))
+            {
+                std::cerr << "Invalid memory-budget parameter." << std::endl;
+                return false;
+            }
+        }
+        else if (Arg == "--spill-dir" && i + 1 < argc)
+        {
+            options.SpillDirectory = argv[++i];
+        }
+        else if (Arg == "--shards" && i + 1 < argc)
+        {
+            try
+            {
+                options.NumShards = std::stoul(argv[++i]);
+            }
+            catch (std::exception& /*e*/)
+            {
+                options.NumShards = 0;
+            }
+
+            if (!options.NumShards)
+            {
+                std::cerr << "Invalid shards parameter." << std::endl;
+                return false;
+            }
+        }
+        else if (Arg == "--batch")
+        {
+            options.Batch = true;
+        }
+        else if (Arg == "--batch-cells")
+        {
+            options.BatchCells = true;
+        }
+        else if (Arg.rfind("--", 0) == 0)
+        {
+            std::cerr << "Unrecognized option: " << Arg << std::endl;
+            return false;
+        }
+        else
+        {
+            positional.push_back(Arg);
+        }
+    }
+
+    if (positional.size() != 2) { return false; }
+
+    options.InputPath = positional[0];
+    options.NumIterations = positional[1];
+
+    //
+    // Finite boards always run on the dense engine, which handles nothing
+    // else.
+    //
+    if (options.Bounds.Width)
+    {
+        if (options.Engine != "sparse" && options.Engine != "dense")
+        {
+            std::cerr << "--bounded and --torus use the dense engine." << std::endl;
+            return false;
+        }
+        options.Engine = "dense";
+    }
+    else if (options.Engine == "dense")
+    {
+        std::cerr << "The dense engine needs --bounded or --torus." << std::endl;
+        return false;
+    }
+
+    //
+    // Only the sparse engine keeps track of which cells changed.
+    //
+    if (!options.DeltaPath.empty() && options.Engine != "sparse")
+    {
+        std::cerr << "--deltas requires the sparse engine." << std::endl;
+        return false;
+    }
+
+    if (options.DeltaFormat != "text" && options.DeltaFormat != "binary")
+    {
+        return false;
+    }
+
+    //
+    // The tiled, HashLife, dense and clustered engines compute B3/S23
+    // directly.
+    //
+    if (options.Rule != gol::ConwayRule && options.Engine != "sparse")
+    {
+        std::cerr << "--rule requires the sparse engine." << std::endl;
+        return false;
+    }
+
+    //
+    // Only the sparse engine has regions to spill.
+    //
+    if (options.MemoryBudget && options.Engine != "sparse")
+    {
+        std::cerr << "--memory-budget requires the sparse engine." << std::endl;
+        return false;
+    }
+
+    if (!options.SpillDirectory.empty() && !options.MemoryBudget)
+    {
+        std::cerr << "--spill-dir requires --memory-budget." << std::endl;
+        return false;
+    }
+
+    if (!options.DeltaPath.empty() && !options.StatsPath.empty())
+    {
+        std::cerr << "--stats and --deltas can't be combined." << std::endl;
+        return false;
+    }
+
+    //
+    // Batches run every pattern on the sparse engine and report a line per
+    // pattern, with nowhere to put per-pattern files.
+    //
+    if (options.BatchCells && !options.Batch)
+    {
+        std::cerr << "--batch-cells requires --batch." << std::endl;
+        return false;
+    }
+
+    if (options.Batch &&
+        (options.Engine != "sparse" || options.CheckpointEvery ||
+         !options.ResumePath.empty() || !options.DeltaPath.empty() ||
+         !options.StatsPath.empty() || options.Pipeline || options.MemoryBudget))
+    {
+        std::cerr << "--batch only works with the sparse engine, and without"
+                  << " checkpoints, deltas, stats, --pipeline or a memory budget."
+                  << std::endl;
+        return false;
+    }
+
+    //
+    // Sharded runs step the sparse engine in each worker, and only the final
+    // generation is gathered in one place.
+    //
+    if (options.NumShards &&
+        (options.Engine != "sparse" || options.CheckpointEvery ||
+         !options.DeltaPath.empty() || !options.StatsPath.empty() ||
+         options.Pipeline || options.MemoryBudget || options.Batch))
+    {
+        std::cerr << "--shards only works with the sparse engine, and without"
+                  << " checkpoints, deltas, stats, --pipeline, a memory budget or --batch."
+                  << std::endl;
+        return false;
+    }
+
+    return options.Engine == "sparse"   ||
+           options.Engine == "tiled"    ||
+           options.Engine == "hashlife" ||
+           options.Engine == "dense"    ||
+           options.Engine == "clustered";
+}
+
 void DumpCells(
     const std::vector<gol::Cell>& cells,
     std::ostream& out,
     bool debug)
 {
-    if (!debug) { out << LifeSignature << "\n"; }
+    if (!debug) { out << gol::LifeSignature << "\n"; }
 
     for (const auto& Cell : cells)
     {
@@ -53,69 +430,688 @@ void DumpCells(
     out.flush();
 }
 
-int main(int argc, char** argv)
+//
+// Debug dumps show every stored cell where the engine keeps per-cell state,
+// and just the live cells otherwise.
+//
+std::vector<gol::Cell> GetDebugCells(const gol::GOLGrid& grid)
+{
+    return grid.GetAllCells();
+}
+
+template<typename GridType>
+std::vector<gol::Cell> GetDebugCells(const GridType& grid)
+{
+    return grid.GetLiveCells();
+}
+
+//
+// HashLife jumps straight to the target generation, the sparse engine skips
+// ahead once it finds a cycle, and the dense engine blocks generations
+// together for the cache; everything else steps.
+//
+void Advance(gol::HashLifeGrid& grid, uint64_t numIterations)
+{
+    grid.AdvanceGenerations(numIterations);
+}
+
+void Advance(gol::DenseGrid& grid, uint64_t numIterations)
+{
+    grid.AdvanceGenerations(numIterations);
+}
+
+void Advance(gol::GOLGrid& grid, uint64_t numIterations)
 {
-    if (argc < 3)
+    grid.AdvanceGenerations(numIterations);
+}
+
+template<typename GridType>
+void Advance(GridType& grid, uint64_t numIterations)
+{
+    for (uint64_t i = 0; i < numIterations; ++i) { grid.AdvanceGeneration(); }
+}
+
+//
+// Only the sparse and clustered engines are multithreaded, and only the sparse
+// engine detects cycles.
+//
+template<typename GridType>
+std::unique_ptr<GridType> CreateGrid(
+    const std::vector<gol::CellAddress>& initialCells,
+    const Options& /*options*/)
+{
+    return std::make_unique<GridType>(initialCells);
+}
+
+template<>
+std::unique_ptr<gol::GOLGrid> CreateGrid<gol::GOLGrid>(
+    const std::vector<gol::CellAddress>& initialCells,
+    const Options& options)
+{
+    auto pGrid = std::make_unique<gol::GOLGrid>(initialCells, options.NumThreads);
+    pGrid->SetRule(options.Rule);
+
+    //
+    // Delta streams visit every generation anyway, so there's nothing to
+    // skip, and they need every change including those in frozen regions.
+    //
+    const bool Tracing{!options.DeltaPath.empty()};
+    pGrid->SetCycleDetection(options.DetectCycles && !Tracing);
+    pGrid->SetRegionFreezing(options.FreezeRegions && !Tracing);
+    pGrid->SetStepStats(!options.StatsPath.empty());
+    if (options.MemoryBudget)
     {
-        PrintUsage(argv[0]);
-        return -1;
+        pGrid->SetMemoryBudget(options.MemoryBudget << 20, options.SpillDirectory);
     }
+    return pGrid;
+}
+
+template<>
+std::unique_ptr<gol::ClusteredGrid> CreateGrid<gol::ClusteredGrid>(
+    const std::vector<gol::CellAddress>& initialCells,
+    const Options& options)
+{
+    return std::make_unique<gol::ClusteredGrid>(initialCells, options.NumThreads);
+}
 
-    const std::string InputPath(argv[1]);
-    std::ifstream in(InputPath);
-    if (!in)
+//
+// The dense engine also needs to know the size and shape of the board.
+//
+template<>
+std::unique_ptr<gol::DenseGrid> CreateGrid<gol::DenseGrid>(
+    const std::vector<gol::CellAddress>& initialCells,
+    const Options& options)
+{
+    return std::make_unique<gol::DenseGrid>(initialCells, options.Bounds);
+}
+
+//
+// Writes the final live cells sorted by address, or with --unsorted streams
+// them straight out of the engine, which saves copying the live set.
+//
+template<typename GridType>
+void WriteLiveCells(const GridType& grid, const Options& options)
+{
+    gol::LifeWriter writer(stdout);
+    writer.WriteSignature();
+    if (options.Sorted)
+    {
+        for (const auto& Cell : grid.GetLiveCells())
+        {
+            writer.WriteCell(Cell.Address);
+        }
+    }
+    else
     {
-        std::cerr << "Could not load file: " << InputPath << std::endl;
+        grid.ForEachLiveCell([&writer](const gol::CellAddress& address)
+        {
+            writer.WriteCell(address);
+        });
     }
 
-    uint32_t numIterations;
-    try
+    if (!writer.Flush())
     {
-        numIterations = static_cast<uint32_t>(std::stoi(argv[2]));
+        throw std::runtime_error("Failed to write output.");
     }
-    catch (std::exception& /*e*/)
+}
+
+gol::CheckpointEngine CheckpointEngineOf(const std::string& engine)
+{
+    if (engine == "tiled")     { return gol::CheckpointEngine::Tiled; }
+    if (engine == "hashlife")  { return gol::CheckpointEngine::HashLife; }
+    if (engine == "dense")     { return gol::CheckpointEngine::Dense; }
+    if (engine == "clustered") { return gol::CheckpointEngine::Clustered; }
+    return gol::CheckpointEngine::Sparse;
+}
+
+void SaveCheckpoint(
+    std::vector<gol::CellAddress> cells,
+    uint64_t generation,
+    const Options& options)
+{
+    std::string error;
+    if (!gol::SaveCheckpoint(
+            options.CheckpointPath(),
+            generation,
+            CheckpointEngineOf(options.Engine),
+            std::move(cells),
+            error))
     {
-        std::cout << "Invalid iterations parameter." << std::endl;
+        throw std::runtime_error(error);
     }
+}
 
-    //
-    // Check signature
-    //
-    std::string line;
-    if(!(std::getline(in, line) && line == LifeSignature))
+//
+// Copies the live set on this thread. With a background writer, the copy is
+// sorted, encoded and written while the simulation moves on.
+//
+template<typename GridType>
+void WriteCheckpoint(
+    const GridType& grid,
+    uint64_t generation,
+    const Options& options,
+    gol::BackgroundWriter* pBackgroundWriter)
+{
+    std::vector<gol::CellAddress> cells;
+    grid.ForEachLiveCell([&cells](const gol::CellAddress& address)
     {
-        std::cerr << "Invalid GOL format!" << std::endl;
-        return -1;
+        cells.push_back(address);
+    });
+
+    if (!pBackgroundWriter)
+    {
+        SaveCheckpoint(std::move(cells), generation, options);
+        return;
+    }
+
+    pBackgroundWriter->Submit(
+        [cells = std::move(cells), generation, &options]() mutable
+        {
+            SaveCheckpoint(std::move(cells), generation, options);
+        });
+}
+
+//
+// Records the starting live set as the first delta, i.e. all births.
+//
+template<typename GridType>
+void WriteInitialDelta(
+    const GridType& grid,
+    uint64_t generation,
+    gol::DeltaWriter& deltaWriter)
+{
+    std::vector<gol::CellAddress> births;
+    std::vector<gol::CellAddress> deaths;
+    grid.ForEachLiveCell([&births](const gol::CellAddress& address)
+    {
+        births.push_back(address);
+    });
+
+    deltaWriter.WriteGeneration(generation, births, deaths);
+}
+
+//
+// Steps one generation at a time, recording the changes each step makes.
+// Other engines are rejected up front, when options are parsed.
+//
+// With a background writer, changes are collected into two sets of buffers
+// in turn: one generation's changes are written while the next generation is
+// computed into the other set.
+//
+void AdvanceWithDeltas(
+    gol::GOLGrid& grid,
+    uint64_t generation,
+    uint64_t numIterations,
+    gol::DeltaWriter& deltaWriter,
+    gol::BackgroundWriter* pBackgroundWriter)
+{
+    std::vector<gol::CellAddress> births[2];
+    std::vector<gol::CellAddress> deaths[2];
+    for (uint64_t i = 1; i <= numIterations; ++i)
+    {
+        grid.AdvanceGeneration();
+
+        auto& generationBirths = births[i & 1];
+        auto& generationDeaths = deaths[i & 1];
+        generationBirths.clear();
+        generationDeaths.clear();
+        grid.ForEachChange([&](const gol::CellAddress& address, bool alive)
+        {
+            (alive ? generationBirths : generationDeaths).push_back(address);
+        });
+
+        const uint64_t Generation{generation + i};
+        if (!pBackgroundWriter)
+        {
+            deltaWriter.WriteGeneration(Generation, generationBirths, generationDeaths);
+            continue;
+        }
+
+        pBackgroundWriter->Submit([&, Generation]()
+        {
+            deltaWriter.WriteGeneration(Generation, generationBirths, generationDeaths);
+        });
     }
 
     //
-    // Read cells
+    // The buffers go out of scope here.
     //
-    int64_t x;
-    int64_t y;
-    std::vector<gol::CellAddress> initialCells;
-    while(in >> x >> y) { initialCells.emplace_back(x, y); }
+    if (pBackgroundWriter) { pBackgroundWriter->Wait(); }
+}
+
+template<typename GridType>
+void AdvanceWithDeltas(
+    GridType& /*grid*/,
+    uint64_t /*generation*/,
+    uint64_t /*numIterations*/,
+    gol::DeltaWriter& /*deltaWriter*/,
+    gol::BackgroundWriter* /*pBackgroundWriter*/)
+{
+    throw std::logic_error("This engine can't record deltas.");
+}
+
+//
+// The sparse engine breaks each generation down further.
+//
+void AddEngineStats(const gol::GOLGrid& grid, gol::GenerationStats& stats)
+{
+    const auto& Step = grid.GetLastStepStats();
+    stats.HasPhases = true;
+    stats.ClassifyNanoseconds = Step.ClassifyNanoseconds;
+    stats.PropagateNanoseconds = Step.PropagateNanoseconds;
+    stats.RetireNanoseconds = Step.RetireNanoseconds;
+    stats.FreezeNanoseconds = Step.FreezeNanoseconds;
+    stats.ChangedCells = Step.ChangedCells;
+    stats.RetiredCells = Step.RetiredCells;
+    stats.StoredCells = grid.GetStoredCellCount();
+    stats.StorageBytes = grid.GetStorageMemoryUsage();
+    stats.FrozenRegions = grid.GetFrozenRegionCount();
+}
+
+template<typename GridType>
+void AddEngineStats(const GridType& /*grid*/, gol::GenerationStats& /*stats*/)
+{
+}
+
+//
+// The sparse engine keeps a running count; the others are scanned.
+//
+uint64_t CountLiveCells(const gol::GOLGrid& grid)
+{
+    return grid.GetPopulation();
+}
+
+template<typename GridType>
+uint64_t CountLiveCells(const GridType& grid)
+{
+    uint64_t numLive{0};
+    grid.ForEachLiveCell([&numLive](const gol::CellAddress&) { ++numLive; });
+    return numLive;
+}
 
-    if (initialCells.empty())
+//
+// Steps one generation at a time, recording metrics for each step. There's
+// no skipping ahead on cycles, so that every generation gets a line.
+//
+template<typename GridType>
+void AdvanceWithStats(
+    GridType& grid,
+    uint64_t generation,
+    uint64_t numIterations,
+    const Options& options,
+    gol::StatsWriter& statsWriter)
+{
+    using Clock = std::chrono::steady_clock;
+    for (uint64_t i = 1; i <= numIterations; ++i)
     {
-        std::cerr << "Please specify at least one live cell in the input."
-                  << std::endl;
-        return -1;
+        const uint64_t AllocationsBefore{gol::AllocationCount()};
+        const uint64_t BytesBefore{gol::AllocatedBytes()};
+        const auto Start = Clock::now();
+        grid.AdvanceGeneration();
+        const auto End = Clock::now();
+
+        gol::GenerationStats stats;
+        stats.Generation = generation + i;
+        stats.pEngine = options.Engine.c_str();
+        stats.WallNanoseconds = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(End - Start)
+                .count());
+        stats.Allocations = gol::AllocationCount() - AllocationsBefore;
+        stats.AllocatedBytes = gol::AllocatedBytes() - BytesBefore;
+        stats.LiveCells = CountLiveCells(grid);
+        AddEngineStats(grid, stats);
+
+        statsWriter.WriteGeneration(stats);
     }
+}
 
-    gol::GOLGrid grid(initialCells);
-    for (uint32_t i = 0; i < numIterations; ++i)
-    {
+//
+// Runs from startGeneration up to numIterations, checkpointing whenever the
+// generation reaches a multiple of the checkpoint interval.
+//
+template<typename GridType>
+void Simulate(
+    GridType& grid,
+    uint64_t startGeneration,
+    uint64_t numIterations,
+    const Options& options)
+{
 #if defined(DEBUG)
+    for (uint64_t i = startGeneration; i < numIterations; ++i)
+    {
         std::cout << "Generation " << i << ":\n";
-        DumpCells(grid.GetAllCells(), std::cout, true);
-#endif
+        DumpCells(GetDebugCells(grid), std::cout, true);
         grid.AdvanceGeneration();
     }
+#else
+    std::unique_ptr<std::FILE, int (*)(std::FILE*)> pDeltaFile(
+        nullptr,
+        &std::fclose);
+    std::unique_ptr<gol::DeltaWriter> pDeltaWriter;
+    if (!options.DeltaPath.empty())
+    {
+        pDeltaFile.reset(std::fopen(options.DeltaPath.c_str(), "wb"));
+        if (!pDeltaFile)
+        {
+            throw std::runtime_error("Could not create " + options.DeltaPath);
+        }
+
+        pDeltaWriter = std::make_unique<gol::DeltaWriter>(
+            pDeltaFile.get(),
+            options.DeltaFormat == "binary" ?
+                gol::DeltaFormat::Binary :
+                gol::DeltaFormat::Text);
+        WriteInitialDelta(grid, startGeneration, *pDeltaWriter);
+    }
+
+    std::unique_ptr<std::FILE, int (*)(std::FILE*)> pStatsFile(
+        nullptr,
+        &std::fclose);
+    std::unique_ptr<gol::StatsWriter> pStatsWriter;
+    if (!options.StatsPath.empty())
+    {
+        pStatsFile.reset(std::fopen(options.StatsPath.c_str(), "wb"));
+        if (!pStatsFile)
+        {
+            throw std::runtime_error("Could not create " + options.StatsPath);
+        }
+
+        pStatsWriter = std::make_unique<gol::StatsWriter>(pStatsFile.get());
+        gol::SetAllocationCounting(true);
+    }
+
+    //
+    // Declared after the writers its jobs use, so that it's stopped first.
+    //
+    std::unique_ptr<gol::BackgroundWriter> pBackgroundWriter;
+    if (options.Pipeline)
+    {
+        pBackgroundWriter = std::make_unique<gol::BackgroundWriter>();
+    }
+
+    const uint64_t Interval{options.CheckpointEvery};
+    for (uint64_t generation = startGeneration; generation < numIterations;)
+    {
+        const uint64_t Remaining{numIterations - generation};
+        const uint64_t NumSteps = Interval ?
+            std::min(Interval - generation % Interval, Remaining) :
+            Remaining;
+
+        if (pDeltaWriter)
+        {
+            AdvanceWithDeltas(
+                grid,
+                generation,
+                NumSteps,
+                *pDeltaWriter,
+                pBackgroundWriter.get());
+        }
+        else if (pStatsWriter)
+        {
+            AdvanceWithStats(grid, generation, NumSteps, options, *pStatsWriter);
+        }
+        else
+        {
+            Advance(grid, NumSteps);
+        }
+        generation += NumSteps;
+
+        if (Interval && generation % Interval == 0)
+        {
+            WriteCheckpoint(grid, generation, options, pBackgroundWriter.get());
+        }
+    }
+
+    if (pBackgroundWriter) { pBackgroundWriter->Wait(); }
+
+    if (pDeltaWriter && !pDeltaWriter->Flush())
+    {
+        throw std::runtime_error("Failed to write " + options.DeltaPath);
+    }
+
+    if (pStatsWriter && !pStatsWriter->Flush())
+    {
+        throw std::runtime_error("Failed to write " + options.StatsPath);
+    }
 
-#if !defined(DEBUG)
-    DumpCells(grid.GetLiveCells(), std::cout, false);
+    WriteLiveCells(grid, options);
 #endif
+}
+
+//
+// Splits the run across options.NumShards worker processes. Their cells come
+// back sorted, so the output is too.
+//
+void RunShardedMode(
+    const std::vector<gol::CellAddress>& initialCells,
+    uint64_t startGeneration,
+    uint64_t numIterations,
+    const Options& options)
+{
+    gol::ShardedSettings settings;
+    settings.NumWorkers = options.NumShards;
+    settings.NumGenerations = numIterations - startGeneration;
+    settings.Rule = options.Rule;
+    settings.NumThreads = options.NumThreads;
+
+    const auto Result = gol::RunSharded(initialCells, settings);
+
+    gol::LifeWriter writer(stdout);
+    writer.WriteSignature();
+    for (const auto& Address : Result.LiveCells) { writer.WriteCell(Address); }
+
+    if (!writer.Flush())
+    {
+        throw std::runtime_error("Failed to write output.");
+    }
+}
+
+//
+// Runs every pattern listed by options.InputPath, writing a JSON line per
+// pattern to stdout and the overall throughput to stderr.
+//
+int RunBatchMode(const Options& options, uint64_t numIterations)
+{
+    std::vector<std::string> inputs;
+    std::string error;
+    if (!gol::ReadBatchInputs(options.InputPath, inputs, error))
+    {
+        std::cerr << error << std::endl;
+        return -1;
+    }
+
+    gol::BatchSettings settings;
+    settings.NumGenerations = numIterations;
+    settings.NumThreads = options.NumThreads;
+    settings.Rule = options.Rule;
+    settings.DetectCycles = options.DetectCycles;
+    settings.FreezeRegions = options.FreezeRegions;
+    settings.KeepLiveCells = options.BatchCells;
+
+    using Clock = std::chrono::steady_clock;
+    const auto Start = Clock::now();
+    try
+    {
+        gol::BatchWriter writer(stdout);
+        gol::RunBatch(inputs, settings, [&](size_t index, const gol::BatchResult& result)
+        {
+            writer.WriteResult(inputs[index], result);
+        });
+
+        if (!writer.Flush())
+        {
+            throw std::runtime_error("Failed to write output.");
+        }
+    }
+    catch (std::exception& e)
+    {
+        std::cerr << "Simulation failed: " << e.what() << std::endl;
+        return -1;
+    }
+
+    const double Seconds{std::chrono::duration<double>(Clock::now() - Start).count()};
+    std::cerr << "Simulated " << inputs.size() << " patterns in " << Seconds
+              << " s (" << (Seconds > 0 ? inputs.size() / Seconds : 0.0)
+              << " patterns/s)." << std::endl;
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!ParseOptions(argc, argv, options))
+    {
+        PrintUsage(argv[0]);
+        return -1;
+    }
+
+    uint64_t numIterations;
+    try
+    {
+        if (options.NumIterations.find('-') != std::string::npos)
+        {
+            throw std::invalid_argument(options.NumIterations);
+        }
+        numIterations = std::stoull(options.NumIterations);
+    }
+    catch (std::exception& /*e*/)
+    {
+        std::cout << "Invalid iterations parameter." << std::endl;
+        return -1;
+    }
+
+    if (options.Batch) { return RunBatchMode(options, numIterations); }
+
+    //
+    // Read cells, either from the input or from a checkpoint of an earlier
+    // run. The iteration count is the total for the whole job, so a resumed
+    // run only computes whatever is left.
+    //
+    // When pipelining on the sparse engine, the grid is built from the input
+    // chunk by chunk as it's parsed instead.
+    //
+    std::vector<gol::CellAddress> initialCells;
+    std::unique_ptr<gol::GOLGrid> pSparseGrid;
+    uint64_t startGeneration{0};
+    if (!options.ResumePath.empty())
+    {
+        gol::CheckpointInfo checkpointInfo;
+        std::string error;
+        if (!gol::LoadCheckpoint(
+                options.ResumePath,
+                checkpointInfo,
+                initialCells,
+                error))
+        {
+            std::cerr << error << std::endl;
+            return -1;
+        }
+
+        startGeneration = checkpointInfo.Generation;
+        if (startGeneration > numIterations)
+        {
+            std::cerr << options.ResumePath << " is already at generation "
+                      << startGeneration << "." << std::endl;
+            return -1;
+        }
+    }
+    else
+    {
+        gol::LifeParseError parseError;
+        bool parsed{false};
+        bool empty{false};
+        if (options.Pipeline && options.Engine == "sparse")
+        {
+            pSparseGrid = CreateGrid<gol::GOLGrid>({}, options);
+            parsed = gol::ParseLifeFileInChunks(
+                options.InputPath,
+                [&pSparseGrid](const std::vector<gol::CellAddress>& cells)
+                {
+                    pSparseGrid->InsertLiveCells(std::begin(cells), std::end(cells));
+                },
+                parseError,
+                options.NumThreads);
+            empty = pSparseGrid->GetPopulation() == 0;
+        }
+        else
+        {
+            parsed = gol::ParseLifeFile(
+                options.InputPath,
+                initialCells,
+                parseError,
+                options.NumThreads);
+            empty = initialCells.empty();
+        }
+
+        if (!parsed)
+        {
+            std::cerr << options.InputPath;
+            if (parseError.Line) { std::cerr << ":" << parseError.Line; }
+            std::cerr << ": " << parseError.Message << std::endl;
+            return -1;
+        }
+
+        if (empty)
+        {
+            std::cerr << "Please specify at least one live cell in the input."
+                      << std::endl;
+            return -1;
+        }
+    }
+
+    try
+    {
+        if (options.NumShards)
+        {
+            RunShardedMode(initialCells, startGeneration, numIterations, options);
+        }
+        else if (options.Engine == "tiled")
+        {
+            Simulate(
+                *CreateGrid<gol::TiledGrid>(initialCells, options),
+                startGeneration,
+                numIterations,
+                options);
+        }
+        else if (options.Engine == "hashlife")
+        {
+            Simulate(
+                *CreateGrid<gol::HashLifeGrid>(initialCells, options),
+                startGeneration,
+                numIterations,
+                options);
+        }
+        else if (options.Engine == "clustered")
+        {
+            Simulate(
+                *CreateGrid<gol::ClusteredGrid>(initialCells, options),
+                startGeneration,
+                numIterations,
+                options);
+        }
+        else if (options.Engine == "dense")
+        {
+            Simulate(
+                *CreateGrid<gol::DenseGrid>(initialCells, options),
+                startGeneration,
+                numIterations,
+                options);
+        }
+        else
+        {
+            if (!pSparseGrid)
+            {
+                pSparseGrid = CreateGrid<gol::GOLGrid>(initialCells, options);
+            }
+
+            Simulate(*pSparseGrid, startGeneration, numIterations, options);
+        }
+    }
+    catch (std::exception& e)
+    {
+        std::cerr << "Simulation failed: " << e.what() << std::endl;
+        return -1;
+    }
 
     return 0;
 }
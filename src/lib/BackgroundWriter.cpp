@@ -0,0 +1,82 @@
+#include "BackgroundWriter.h"
+
+#include <utility>
+
+namespace gol
+{
+    BackgroundWriter::BackgroundWriter()
+        : m_thread(&BackgroundWriter::Run, this)
+    {
+    }
+
+    BackgroundWriter::~BackgroundWriter()
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            WaitForIdle(lock);
+            m_stopping = true;
+        }
+        m_condition.notify_all();
+
+        m_thread.join();
+    }
+
+    void BackgroundWriter::Submit(std::function<void()> job)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            WaitForIdle(lock);
+            if (m_failure) { std::rethrow_exception(m_failure); }
+
+            m_job = std::move(job);
+            m_busy = true;
+        }
+        m_condition.notify_all();
+    }
+
+    void BackgroundWriter::Wait()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        WaitForIdle(lock);
+        if (m_failure) { std::rethrow_exception(m_failure); }
+    }
+
+    void BackgroundWriter::WaitForIdle(std::unique_lock<std::mutex>& lock)
+    {
+        m_condition.wait(lock, [this]() { return !m_busy; });
+    }
+
+    void BackgroundWriter::Run()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        for (;;)
+        {
+            m_condition.wait(lock, [this]() { return m_busy || m_stopping; });
+            if (!m_busy) { return; }
+
+            auto job = std::move(m_job);
+            m_job = nullptr;
+            lock.unlock();
+
+            std::exception_ptr failure;
+            try
+            {
+                job();
+            }
+            catch (...)
+            {
+                failure = std::current_exception();
+            }
+
+            //
+            // The job's captures are released before the caller is told it
+            // may reuse whatever they referred to.
+            //
+            job = nullptr;
+            lock.lock();
+            if (failure && !m_failure) { m_failure = failure; }
+            m_busy = false;
+            m_condition.notify_all();
+        }
+    }
+}
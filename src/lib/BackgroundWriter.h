@@ -0,0 +1,68 @@
+//
+// Runs output jobs (checkpoint saves, delta records) on a thread of their own,
+// so that the simulation doesn't stall while generation N is serialized: it
+// carries on computing generation N + 1 instead.
+//
+// Only one job runs at a time, in submission order. Submit waits for the
+// previous job to finish before queueing the next. A caller which alternates
+// between two buffers can therefore refill one while the other is written.
+//
+
+#pragma once
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace gol
+{
+    class BackgroundWriter
+    {
+    public:
+        BackgroundWriter();
+
+        //
+        // Waits for the job in flight, discarding any error it raises; call
+        // Wait first to find out about it.
+        //
+        ~BackgroundWriter();
+
+        BackgroundWriter(const BackgroundWriter&) = delete;
+        BackgroundWriter& operator=(const BackgroundWriter&) = delete;
+
+        //
+        // Waits for the previous job, then hands job over to the writer
+        // thread. If a job threw, the exception is rethrown here (or from
+        // Wait) and later jobs are dropped.
+        //
+        void Submit(std::function<void()> job);
+
+        //
+        // Blocks until the job in flight has finished, rethrowing anything it
+        // threw.
+        //
+        void Wait();
+
+    private:
+        void Run();
+
+        //
+        // Waits for the writer thread to go idle; lock must hold m_mutex.
+        //
+        void WaitForIdle(std::unique_lock<std::mutex>& lock);
+
+        std::mutex              m_mutex;
+        std::condition_variable m_condition;
+        std::function<void()>   m_job;
+        bool                    m_busy = false;
+        bool                    m_stopping = false;
+        std::exception_ptr      m_failure;
+
+        //
+        // Declared last so that everything above exists before it starts.
+        //
+        std::thread             m_thread;
+    };
+}
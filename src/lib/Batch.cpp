@@ -0,0 +1,336 @@
+#include "Batch.h"
+#include "LifeParser.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+
+namespace
+{
+    namespace fs = std::filesystem;
+
+    template<typename Integer>
+    void AppendNumber(std::vector<char>& buffer, Integer value)
+    {
+        char number[24];
+        char* pEnd = std::to_chars(number, number + sizeof(number), value).ptr;
+        buffer.insert(std::end(buffer), number, pEnd);
+    }
+
+    //
+    // What each worker keeps from one pattern to the next.
+    //
+    struct BatchWorker
+    {
+        std::unique_ptr<gol::GOLGrid> pGrid;
+        std::vector<gol::CellAddress> Cells;
+    };
+
+    void RunPattern(
+        const std::string& inputPath,
+        const gol::BatchSettings& settings,
+        BatchWorker& worker,
+        gol::BatchResult& result)
+    {
+        worker.Cells.clear();
+        gol::LifeParseError parseError;
+        if (!gol::ParseLifeFile(inputPath, worker.Cells, parseError))
+        {
+            result.Error = parseError.Message;
+            if (parseError.Line)
+            {
+                result.Error += " (line " + std::to_string(parseError.Line) + ")";
+            }
+            return;
+        }
+
+        if (!worker.pGrid)
+        {
+            //
+            // Patterns are small; the parallelism is across them instead.
+            //
+            const size_t NumThreads{1};
+            worker.pGrid = std::make_unique<gol::GOLGrid>(
+                std::vector<gol::CellAddress>(),
+                NumThreads);
+            worker.pGrid->SetRule(settings.Rule);
+            worker.pGrid->SetCycleDetection(settings.DetectCycles);
+            worker.pGrid->SetRegionFreezing(settings.FreezeRegions);
+        }
+
+        auto& grid = *worker.pGrid;
+        grid.Clear();
+        grid.InsertLiveCells(std::begin(worker.Cells), std::end(worker.Cells));
+        grid.AdvanceGenerations(settings.NumGenerations);
+
+        result.Generation = grid.GetGeneration();
+        result.Cycle = grid.GetCycle();
+        result.Population = grid.GetPopulation();
+
+        if (settings.KeepLiveCells)
+        {
+            result.LiveCells.reserve(result.Population);
+            grid.ForEachLiveCell([&result](const gol::CellAddress& address)
+            {
+                result.LiveCells.push_back(address);
+            });
+            std::sort(std::begin(result.LiveCells), std::end(result.LiveCells));
+        }
+    }
+}
+
+namespace gol
+{
+    bool ReadBatchInputs(
+        const std::string& path,
+        std::vector<std::string>& inputs,
+        std::string& error)
+    {
+        std::error_code errorCode;
+        if (fs::is_directory(path, errorCode))
+        {
+            std::vector<std::string> found;
+            for (const auto& Entry : fs::directory_iterator(path, errorCode))
+            {
+                if (Entry.is_regular_file(errorCode) &&
+                    Entry.path().extension() == ".life")
+                {
+                    found.push_back(Entry.path().string());
+                }
+            }
+
+            if (errorCode)
+            {
+                error = "Could not list " + path + ": " + errorCode.message();
+                return false;
+            }
+
+            std::sort(std::begin(found), std::end(found));
+            inputs.insert(std::end(inputs), std::begin(found), std::end(found));
+            return true;
+        }
+
+        std::ifstream manifest(path);
+        if (!manifest)
+        {
+            error = "Could not open " + path;
+            return false;
+        }
+
+        const fs::path BaseDirectory{fs::path(path).parent_path()};
+        std::string line;
+        while (std::getline(manifest, line))
+        {
+            if (!line.empty() && line.back() == '\r') { line.pop_back(); }
+            if (line.empty() || line[0] == '#') { continue; }
+
+            const fs::path Input{line};
+            inputs.push_back(
+                Input.is_absolute() ? line : (BaseDirectory / Input).string());
+        }
+
+        if (manifest.bad())
+        {
+            error = "Could not read " + path;
+            return false;
+        }
+
+        return true;
+    }
+
+    void RunBatch(
+        const std::vector<std::string>& inputs,
+        const BatchSettings& settings,
+        const std::function<void(size_t, const BatchResult&)>& onResult)
+    {
+        const size_t NumWorkers{
+            std::max<size_t>(std::min(settings.NumThreads, inputs.size()), 1)};
+        std::vector<BatchWorker> workers(NumWorkers);
+
+        //
+        // Each worker runs one long task which claims patterns in input
+        // order, so that results can be reported soon after they're ready.
+        // Results which finish ahead of an earlier one wait in pending.
+        //
+        std::atomic<size_t> nextInput{0};
+        std::mutex reportMutex;
+        std::vector<std::unique_ptr<BatchResult>> pending(inputs.size());
+        size_t nextReport{0};
+        std::exception_ptr failure;
+        std::atomic<bool> failed{false};
+
+        auto Work = [&](size_t workerIndex)
+        {
+            auto& worker = workers[workerIndex];
+            while (!failed)
+            {
+                const size_t InputIndex{nextInput++};
+                if (InputIndex >= inputs.size()) { return; }
+
+                try
+                {
+                    auto pResult = std::make_unique<BatchResult>();
+                    RunPattern(inputs[InputIndex], settings, worker, *pResult);
+
+                    std::lock_guard<std::mutex> lock(reportMutex);
+                    pending[InputIndex] = std::move(pResult);
+                    for (; nextReport < inputs.size() && pending[nextReport]; ++nextReport)
+                    {
+                        onResult(nextReport, *pending[nextReport]);
+                        pending[nextReport].reset();
+                    }
+                }
+                catch (...)
+                {
+                    //
+                    // Exceptions can't be allowed to escape into the pool's
+                    // worker threads.
+                    //
+                    std::lock_guard<std::mutex> lock(reportMutex);
+                    if (!failure) { failure = std::current_exception(); }
+                    failed = true;
+                }
+            }
+        };
+
+        ThreadPool pool(NumWorkers);
+        pool.ParallelFor(NumWorkers, std::ref(Work));
+
+        if (failure) { std::rethrow_exception(failure); }
+    }
+
+    BatchWriter::BatchWriter(std::FILE* pFile, size_t bufferSize)
+        : m_pFile(pFile),
+          m_bufferSize(bufferSize)
+    {
+        m_buffer.reserve(m_bufferSize);
+    }
+
+    BatchWriter::~BatchWriter()
+    {
+        Flush();
+    }
+
+    void BatchWriter::WriteResult(const std::string& inputPath, const BatchResult& result)
+    {
+        WriteText("{\"input\":");
+        WriteString(inputPath);
+
+        if (!result.Error.empty())
+        {
+            WriteText(",\"error\":");
+            WriteString(result.Error);
+        }
+        else
+        {
+            WriteField("generation", result.Generation);
+            WriteField("population", result.Population);
+            WriteField("period", result.Cycle.Period);
+            if (result.Cycle.Period)
+            {
+                WriteField("dx", result.Cycle.Offset.first);
+                WriteField("dy", result.Cycle.Offset.second);
+            }
+
+            if (!result.LiveCells.empty())
+            {
+                WriteText(",\"cells\":[");
+                for (const auto& Address : result.LiveCells)
+                {
+                    if (&Address != &result.LiveCells.front()) { m_buffer.push_back(','); }
+
+                    m_buffer.push_back('[');
+                    AppendNumber(m_buffer, Address.first);
+                    m_buffer.push_back(',');
+                    AppendNumber(m_buffer, Address.second);
+                    m_buffer.push_back(']');
+                }
+                m_buffer.push_back(']');
+            }
+        }
+
+        m_buffer.push_back('}');
+        m_buffer.push_back('\n');
+
+        if (m_buffer.size() >= m_bufferSize) { Flush(); }
+    }
+
+    bool BatchWriter::Flush()
+    {
+        if (!m_buffer.empty())
+        {
+            const size_t Written{
+                std::fwrite(m_buffer.data(), 1, m_buffer.size(), m_pFile)};
+            m_good = m_good && Written == m_buffer.size();
+            m_buffer.clear();
+        }
+
+        m_good = m_good && std::fflush(m_pFile) == 0;
+        return m_good;
+    }
+
+    void BatchWriter::WriteField(const char* pName, uint64_t value)
+    {
+        WriteName(pName);
+        AppendNumber(m_buffer, value);
+    }
+
+    void BatchWriter::WriteField(const char* pName, int64_t value)
+    {
+        WriteName(pName);
+        AppendNumber(m_buffer, value);
+    }
+
+    void BatchWriter::WriteName(const char* pName)
+    {
+        m_buffer.push_back(',');
+        m_buffer.push_back('"');
+        WriteText(pName);
+        m_buffer.push_back('"');
+        m_buffer.push_back(':');
+    }
+
+    void BatchWriter::WriteString(const std::string& text)
+    {
+        //
+        // Paths and error messages may hold anything, so quotes, backslashes
+        // and control characters are escaped.
+        //
+        static const char* const HexDigits = "0123456789abcdef";
+
+        m_buffer.push_back('"');
+        for (const char Character : text)
+        {
+            const unsigned char Byte = static_cast<unsigned char>(Character);
+            if (Character == '"' || Character == '\\')
+            {
+                m_buffer.push_back('\\');
+                m_buffer.push_back(Character);
+            }
+            else if (Byte < 0x20)
+            {
+                const char Escape[] = {
+                    '\\', 'u', '0', '0', HexDigits[Byte >> 4], HexDigits[Byte & 0xF]
+                };
+                m_buffer.insert(std::end(m_buffer), std::begin(Escape), std::end(Escape));
+            }
+            else
+            {
+                m_buffer.push_back(Character);
+            }
+        }
+        m_buffer.push_back('"');
+    }
+
+    void BatchWriter::WriteText(const char* pText)
+    {
+        m_buffer.insert(std::end(m_buffer), pText, pText + std::strlen(pText));
+    }
+}
@@ -0,0 +1,124 @@
+//
+// Batch runs: many small, independent patterns simulated in one process, for
+// soup searches and the like where starting a process per pattern would cost
+// more than the simulation itself.
+//
+// Patterns are handed out to a thread pool one at a time. Each worker borrows
+// a single-threaded GOLGrid and parse buffer which are cleared and refilled
+// for every pattern, so once warmed up they rarely go back to the heap.
+//
+// Results are written as JSON lines, one flat object per pattern, in input
+// order, e.g.
+//     {"input":"soups/17.life","generation":1000,"population":64,"period":2,"dx":0,"dy":0}
+// A pattern which fails to load gets {"input":...,"error":...} instead.
+//
+
+#pragma once
+
+#include "Cell.h"
+#include "GOLGrid.h"
+#include "Rule.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace gol
+{
+    struct BatchSettings
+    {
+        uint64_t NumGenerations = 0;
+        size_t   NumThreads = 1;
+        gol::Rule Rule = ConwayRule;
+        bool     DetectCycles = true;
+        bool     FreezeRegions = true;
+
+        //
+        // Report every final live cell, not just the summary.
+        //
+        bool     KeepLiveCells = false;
+    };
+
+    struct BatchResult
+    {
+        //
+        // Empty if the pattern ran; otherwise why it couldn't be loaded.
+        //
+        std::string    Error;
+        uint64_t       Generation = 0;
+        uint64_t       Population = 0;
+        GOLGrid::Cycle Cycle;
+
+        //
+        // Sorted by address; only filled in with KeepLiveCells.
+        //
+        std::vector<CellAddress> LiveCells;
+    };
+
+    //
+    // Lists the inputs of a batch. A directory contributes every .life file
+    // in it, sorted by name. Anything else is read as a manifest: one path
+    // per line, relative to the manifest's own directory unless absolute,
+    // with blank lines and lines starting with '#' skipped.
+    //
+    // Returns false and fills in error if the listing can't be read.
+    //
+    bool ReadBatchInputs(
+        const std::string& path,
+        std::vector<std::string>& inputs,
+        std::string& error);
+
+    //
+    // Simulates every input and calls onResult(index, result) for each of
+    // them in input order, one call at a time, as results become available.
+    // Failing to load one pattern doesn't stop the others. Exceptions thrown
+    // while simulating (or by onResult) are rethrown once the pool is idle.
+    //
+    void RunBatch(
+        const std::vector<std::string>& inputs,
+        const BatchSettings& settings,
+        const std::function<void(size_t, const BatchResult&)>& onResult);
+
+    class BatchWriter
+    {
+    public:
+        static constexpr size_t DefaultBufferSize{size_t(1) << 16};
+
+        explicit BatchWriter(std::FILE* pFile, size_t bufferSize = DefaultBufferSize);
+
+        //
+        // Flushes whatever is still buffered.
+        //
+        ~BatchWriter();
+
+        BatchWriter(const BatchWriter&) = delete;
+        BatchWriter& operator=(const BatchWriter&) = delete;
+
+        //
+        // Final live cells, if the result has any, go in a "cells" array of
+        // [x,y] pairs.
+        //
+        void WriteResult(const std::string& inputPath, const BatchResult& result);
+
+        //
+        // Returns false if any write so far has failed.
+        //
+        bool Flush();
+        bool Good() const noexcept { return m_good; }
+
+    private:
+        void WriteField(const char* pName, uint64_t value);
+        void WriteField(const char* pName, int64_t value);
+        void WriteName(const char* pName);
+        void WriteString(const std::string& text);
+        void WriteText(const char* pText);
+
+        std::FILE*        m_pFile;
+        size_t            m_bufferSize;
+        std::vector<char> m_buffer;
+        bool              m_good = true;
+    };
+}
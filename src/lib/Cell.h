@@ -11,17 +11,47 @@ namespace gol
 {
     using CellAddress = std::pair<int64_t, int64_t>;
 
+    //
+    // Folds a pair of coordinates, of cells or of the tiles, regions or blocks
+    // they're grouped into, into a single 64-bit value and runs it through a
+    // strong finalizer, so that keys which differ only in their high bits
+    // (e.g. far-apart clusters) still spread across every bit of the hash.
+    //
+    inline uint64_t HashCoordinates(int64_t x, int64_t y) noexcept
+    {
+        uint64_t h = static_cast<uint64_t>(x) * 0x9E3779B97F4A7C15ull;
+        h ^= static_cast<uint64_t>(y) + 0x632BE59BD9B4E019ull
+           + (h << 6) + (h >> 2);
+
+        h ^= h >> 33;
+        h *= 0xFF51AFD7ED558CCDull;
+        h ^= h >> 33;
+        h *= 0xC4CEB9FE1A85EC53ull;
+        h ^= h >> 33;
+        return h;
+    }
+
     struct Cell
     {
         Cell() = default;
         Cell(const CellAddress& address, bool alive, uint8_t neighborCount)
-            : Address(address), Alive(alive), NeighborCount(neighborCount) {}
+            : Address(address),
+              Alive(alive),
+              NeighborCount(neighborCount),
+              Dirty(false) {}
         Cell(const Cell& other) = default;
+        Cell& operator=(const Cell& other) = default;
 
         CellAddress Address;
         uint8_t     Alive;
         uint8_t     NeighborCount;
 
+        //
+        // Engine bookkeeping: set while the cell is queued for evaluation in
+        // the next generation. Fits in what would otherwise be padding.
+        //
+        uint8_t     Dirty;
+
         //
         // May be overkill? Packing state bits into place for an easy state
         // transition look-up when advancing the generation.
@@ -0,0 +1,114 @@
+//
+// Compact binary encoding of cell lists, shared by checkpoints and delta
+// streams.
+//
+// A list of cells sorted by address is stored as, for each cell, the varint
+// x delta from the previous cell (never negative, thanks to the sort) followed
+// by the zigzag varint y delta. Deltas are taken modulo 2^64 so they never
+// overflow however far apart two cells are, and clustered patterns take a
+// couple of bytes per cell.
+//
+
+#pragma once
+
+#include "Cell.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace gol
+{
+    //
+    // A 64-bit varint takes at most ten bytes.
+    //
+    constexpr size_t MaxVarintBytes{10};
+
+    inline void PutVarint(std::vector<char>& out, uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<char>(value));
+    }
+
+    //
+    // Returns the position after the varint, or nullptr if it runs past pEnd
+    // or is overlong.
+    //
+    inline const char* GetVarint(
+        const char* pCursor,
+        const char* pEnd,
+        uint64_t& value)
+    {
+        value = 0;
+        for (size_t i = 0; i < MaxVarintBytes && pCursor != pEnd; ++i)
+        {
+            const uint8_t Byte{static_cast<uint8_t>(*pCursor++)};
+            value |= uint64_t(Byte & 0x7F) << (7 * i);
+            if (!(Byte & 0x80)) { return pCursor; }
+        }
+
+        return nullptr;
+    }
+
+    inline uint64_t ZigZag(uint64_t delta)
+    {
+        return (delta << 1) ^ (0 - (delta >> 63));
+    }
+
+    inline uint64_t UnZigZag(uint64_t value)
+    {
+        return (value >> 1) ^ (0 - (value & 1));
+    }
+
+    //
+    // cells must be sorted by address.
+    //
+    inline void PutSortedAddresses(
+        std::vector<char>& out,
+        const std::vector<CellAddress>& cells)
+    {
+        uint64_t previousX{0};
+        uint64_t previousY{0};
+        for (const auto& Address : cells)
+        {
+            const uint64_t X{static_cast<uint64_t>(Address.first)};
+            const uint64_t Y{static_cast<uint64_t>(Address.second)};
+            PutVarint(out, X - previousX);
+            PutVarint(out, ZigZag(Y - previousY));
+            previousX = X;
+            previousY = Y;
+        }
+    }
+
+    //
+    // Decodes numCells cells, appending them to cells. Returns the position
+    // after the list, or nullptr if it runs past pEnd.
+    //
+    inline const char* GetSortedAddresses(
+        const char* pCursor,
+        const char* pEnd,
+        uint64_t numCells,
+        std::vector<CellAddress>& cells)
+    {
+        uint64_t x{0};
+        uint64_t y{0};
+        for (uint64_t i = 0; i < numCells && pCursor; ++i)
+        {
+            uint64_t deltaX{0};
+            uint64_t deltaY{0};
+            pCursor = GetVarint(pCursor, pEnd, deltaX);
+            if (pCursor) { pCursor = GetVarint(pCursor, pEnd, deltaY); }
+            if (!pCursor) { break; }
+
+            x += deltaX;
+            y += UnZigZag(deltaY);
+            cells.emplace_back(static_cast<int64_t>(x), static_cast<int64_t>(y));
+        }
+
+        return pCursor;
+    }
+}
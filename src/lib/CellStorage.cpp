@@ -1,7 +1,35 @@
 #include "CellStorage.h"
 
+#include <iterator>
+
 namespace gol
 {
+#if defined(GOL_STORAGE_STD_MAP)
+    CellStorage::CellStorage() = default;
+
+    CellStorage::CellStorage(const CellStorage& other)
+        : m_map(other.m_map, &m_nodePool)
+    {
+    }
+
+    CellStorage::CellStorage(CellStorage&& other)
+        : m_map(std::move(other.m_map), &m_nodePool)
+    {
+    }
+
+    CellStorage& CellStorage::operator=(const CellStorage& other)
+    {
+        m_map = other.m_map;
+        return *this;
+    }
+
+    CellStorage& CellStorage::operator=(CellStorage&& other)
+    {
+        m_map = std::move(other.m_map);
+        return *this;
+    }
+#endif
+
     CellStorage::iterator CellStorage::Find(const CellAddress& address)
     {
         return m_map.find(address);
@@ -38,5 +66,52 @@ namespace gol
             return false;
         }
     }
-}
 
+    void CellStorage::Remove(iterator it)
+    {
+        m_map.erase(it);
+    }
+
+    void CellStorage::Reserve(size_t count)
+    {
+#if defined(GOL_STORAGE_STD_MAP)
+        //
+        // Nodes are allocated individually; nothing to reserve.
+        //
+        (void)count;
+#else
+        m_map.reserve(count);
+#endif
+    }
+
+    void CellStorage::ShrinkToFit()
+    {
+#if defined(GOL_STORAGE_STD_MAP)
+        //
+        // Removed nodes already went back to the pool.
+        //
+#else
+        m_map.shrink_to_fit();
+#endif
+    }
+
+    void CellStorage::Clear() noexcept
+    {
+        m_map.clear();
+    }
+
+    size_t CellStorage::MemoryUsage() const noexcept
+    {
+#if defined(GOL_STORAGE_STD_MAP)
+        //
+        // Each node carries the entry plus three links and a color, rounded
+        // up to pointer alignment.
+        //
+        constexpr size_t NodeBytes{
+            sizeof(ContainerType::value_type) + 4 * sizeof(void*)};
+        return m_map.size() * NodeBytes;
+#else
+        return m_map.memory_usage();
+#endif
+    }
+}
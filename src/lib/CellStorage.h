@@ -6,21 +6,43 @@
 
 #include "Cell.h"
 
+#if defined(GOL_STORAGE_STD_MAP)
 #include <map>
+#include <memory_resource>
+#else
+#include "FlatCellMap.h"
+#endif
+
+#include <cstddef>
 
 namespace gol
 {
     class CellStorage
     {
     public:
+#if defined(GOL_STORAGE_STD_MAP)
+        CellStorage();
+        CellStorage(const CellStorage& other);
+        CellStorage(CellStorage&& other);
+        CellStorage& operator=(const CellStorage& other);
+        CellStorage& operator=(CellStorage&& other);
+#else
         CellStorage() = default;
+#endif
         ~CellStorage() = default;
 
         //
-        // Would be nice to templateize the underlying representation or just
-        // make this opaque;
+        // The flat hash table is the default backend. Configuring with
+        // GOL_STORAGE_STD_MAP swaps in the original ordered map, which is
+        // handy for comparing the two. Its nodes come from a pool owned by
+        // the storage, so cells being born and retired recycle nodes instead
+        // of going back and forth to the heap.
         //
-        using ContainerType = std::map<CellAddress, Cell>;
+#if defined(GOL_STORAGE_STD_MAP)
+        using ContainerType = std::pmr::map<CellAddress, Cell>;
+#else
+        using ContainerType = FlatCellMap;
+#endif
         using iterator = ContainerType::iterator;
         using const_iterator = ContainerType::const_iterator;
 
@@ -52,6 +74,35 @@ namespace gol
         bool Remove(const Cell& cell);
         bool Remove(const CellAddress& address);
 
+        //
+        // Removes the cell referenced by a valid iterator, saving a lookup.
+        //
+        void Remove(iterator it);
+
+        //
+        // Makes room for at least `count` cells. Iterators remain valid across
+        // insertions as long as the total stays within the reserved count.
+        //
+        void Reserve(size_t count);
+
+        //
+        // Gives back memory beyond what the cells held need, e.g. after many
+        // have been removed.
+        //
+        void ShrinkToFit();
+
+        //
+        // Removes every cell, keeping the memory already allocated for reuse.
+        //
+        void Clear() noexcept;
+
+        size_t Size() const noexcept { return m_map.size(); }
+
+        //
+        // Approximate bytes held by the container, for diagnostics.
+        //
+        size_t MemoryUsage() const noexcept;
+
         //
         // Iterator convenience.
         //
@@ -61,7 +112,16 @@ namespace gol
         const_iterator end()   const noexcept { return m_map.cend();   }
         
     private:
+#if defined(GOL_STORAGE_STD_MAP)
+        //
+        // Declared first so that it outlives the map. Each storage has its
+        // own pool; copies and moves go element by element between pools.
+        //
+        std::pmr::unsynchronized_pool_resource m_nodePool;
+        ContainerType                          m_map{&m_nodePool};
+#else
         ContainerType m_map;
+#endif
     };
 }
 
@@ -0,0 +1,200 @@
+#include "Checkpoint.h"
+#include "CellEncoding.h"
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+    constexpr char     Magic[8] = { 'G', 'O', 'L', 'C', 'K', 'P', 'T', '\0' };
+    constexpr uint32_t Version{1};
+
+    //
+    // Magic, version, engine, generation, bounding box, cell count and
+    // payload size.
+    //
+    constexpr size_t HeaderBytes{8 + 4 + 4 + 8 + 4 * 8 + 8 + 8};
+
+    void PutU32(std::vector<char>& out, uint32_t value)
+    {
+        for (size_t i = 0; i < 4; ++i)
+        {
+            out.push_back(static_cast<char>(value >> (8 * i)));
+        }
+    }
+
+    void PutU64(std::vector<char>& out, uint64_t value)
+    {
+        for (size_t i = 0; i < 8; ++i)
+        {
+            out.push_back(static_cast<char>(value >> (8 * i)));
+        }
+    }
+
+    uint32_t GetU32(const char* pData)
+    {
+        uint32_t value{0};
+        for (size_t i = 0; i < 4; ++i)
+        {
+            value |= uint32_t(static_cast<uint8_t>(pData[i])) << (8 * i);
+        }
+        return value;
+    }
+
+    uint64_t GetU64(const char* pData)
+    {
+        uint64_t value{0};
+        for (size_t i = 0; i < 8; ++i)
+        {
+            value |= uint64_t(static_cast<uint8_t>(pData[i])) << (8 * i);
+        }
+        return value;
+    }
+}
+
+namespace gol
+{
+    bool SaveCheckpoint(
+        const std::string& path,
+        uint64_t generation,
+        CheckpointEngine engine,
+        std::vector<CellAddress> cells,
+        std::string& error)
+    {
+        std::sort(std::begin(cells), std::end(cells));
+
+        CellAddress minAddress(0, 0);
+        CellAddress maxAddress(0, 0);
+        if (!cells.empty())
+        {
+            minAddress = maxAddress = cells.front();
+            for (const auto& Address : cells)
+            {
+                minAddress.second = std::min(minAddress.second, Address.second);
+                maxAddress.second = std::max(maxAddress.second, Address.second);
+            }
+            maxAddress.first = cells.back().first;
+        }
+
+        std::vector<char> payload;
+        payload.reserve(cells.size() * 2);
+        PutSortedAddresses(payload, cells);
+
+        std::vector<char> header(std::begin(Magic), std::end(Magic));
+        PutU32(header, Version);
+        PutU32(header, static_cast<uint32_t>(engine));
+        PutU64(header, generation);
+        PutU64(header, static_cast<uint64_t>(minAddress.first));
+        PutU64(header, static_cast<uint64_t>(minAddress.second));
+        PutU64(header, static_cast<uint64_t>(maxAddress.first));
+        PutU64(header, static_cast<uint64_t>(maxAddress.second));
+        PutU64(header, cells.size());
+        PutU64(header, payload.size());
+
+        const std::string TempPath = path + ".tmp";
+        std::FILE* pFile = std::fopen(TempPath.c_str(), "wb");
+        if (!pFile)
+        {
+            error = "Could not create " + TempPath + ": " + std::strerror(errno);
+            return false;
+        }
+
+        bool written =
+            std::fwrite(header.data(), 1, header.size(), pFile) == header.size();
+        written = written &&
+            std::fwrite(payload.data(), 1, payload.size(), pFile) == payload.size();
+        written = (std::fclose(pFile) == 0) && written;
+        if (!written)
+        {
+            error = "Could not write " + TempPath;
+            std::remove(TempPath.c_str());
+            return false;
+        }
+
+#if defined(_WIN32)
+        //
+        // rename() won't replace an existing file here.
+        //
+        std::remove(path.c_str());
+#endif
+        if (std::rename(TempPath.c_str(), path.c_str()) != 0)
+        {
+            error = "Could not replace " + path + ": " + std::strerror(errno);
+            std::remove(TempPath.c_str());
+            return false;
+        }
+
+        return true;
+    }
+
+    bool LoadCheckpoint(
+        const std::string& path,
+        CheckpointInfo& info,
+        std::vector<CellAddress>& cells,
+        std::string& error)
+    {
+        MappedFile file;
+        if (!file.Open(path, error)) { return false; }
+
+        const char* pData = file.Data();
+        const size_t Size{file.Size()};
+        if (Size < HeaderBytes || std::memcmp(pData, Magic, sizeof(Magic)) != 0)
+        {
+            error = path + " is not a checkpoint.";
+            return false;
+        }
+
+        const char* pHeader = pData + sizeof(Magic);
+        if (GetU32(pHeader) != Version)
+        {
+            error = path + " has an unsupported checkpoint version.";
+            return false;
+        }
+
+        const uint32_t Engine{GetU32(pHeader + 4)};
+        if (Engine > static_cast<uint32_t>(CheckpointEngine::Clustered))
+        {
+            error = path + " names an unknown engine.";
+            return false;
+        }
+
+        CheckpointInfo header;
+        header.Engine = static_cast<CheckpointEngine>(Engine);
+        header.Generation = GetU64(pHeader + 8);
+        header.Min.first = static_cast<int64_t>(GetU64(pHeader + 16));
+        header.Min.second = static_cast<int64_t>(GetU64(pHeader + 24));
+        header.Max.first = static_cast<int64_t>(GetU64(pHeader + 32));
+        header.Max.second = static_cast<int64_t>(GetU64(pHeader + 40));
+        header.NumCells = GetU64(pHeader + 48);
+
+        const uint64_t PayloadBytes{GetU64(pHeader + 56)};
+        if (PayloadBytes != Size - HeaderBytes ||
+            header.NumCells > PayloadBytes / 2)
+        {
+            error = path + " is truncated or corrupt.";
+            return false;
+        }
+
+        std::vector<CellAddress> decoded;
+        decoded.reserve(static_cast<size_t>(header.NumCells));
+
+        const char* pEnd = pData + Size;
+        const char* pCursor = GetSortedAddresses(
+            pData + HeaderBytes,
+            pEnd,
+            header.NumCells,
+            decoded);
+        if (pCursor != pEnd)
+        {
+            error = path + " is truncated or corrupt.";
+            return false;
+        }
+
+        info = header;
+        cells.swap(decoded);
+        return true;
+    }
+}
@@ -0,0 +1,71 @@
+//
+// Compact binary snapshots of the live set, for resuming long runs.
+//
+// A checkpoint is a fixed little-endian header followed by the live cells
+// sorted by address, delta and varint encoded (see CellEncoding.h).
+//
+// Checkpoints hold plain cell coordinates, so a run may be resumed on any
+// engine regardless of which one wrote the snapshot.
+//
+
+#pragma once
+
+#include "Cell.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace gol
+{
+    enum class CheckpointEngine : uint32_t
+    {
+        Sparse    = 0,
+        Tiled     = 1,
+        HashLife  = 2,
+        Dense     = 3,
+        Clustered = 4,
+    };
+
+    struct CheckpointInfo
+    {
+        uint64_t         Generation = 0;
+        CheckpointEngine Engine = CheckpointEngine::Sparse;
+
+        //
+        // Inclusive bounds of the live set; meaningless when NumCells is 0.
+        //
+        CellAddress      Min;
+        CellAddress      Max;
+        uint64_t         NumCells = 0;
+    };
+
+    //
+    // Writes the cells (in any order, without duplicates) to path. The file is
+    // written beside its destination and renamed into place, so an interrupted
+    // save leaves any previous checkpoint intact.
+    //
+    // Returns false and fills in error on failure.
+    //
+    bool SaveCheckpoint(
+        const std::string& path,
+        uint64_t generation,
+        CheckpointEngine engine,
+        std::vector<CellAddress> cells,
+        std::string& error);
+
+    //
+    // Maps the checkpoint at path and decodes it, replacing the contents of
+    // cells. Cells come back sorted by address, in a single pass over the
+    // file, so loading is linear in the number of cells.
+    //
+    // Returns false and fills in error if the file can't be read or is
+    // malformed.
+    //
+    bool LoadCheckpoint(
+        const std::string& path,
+        CheckpointInfo& info,
+        std::vector<CellAddress>& cells,
+        std::string& error);
+}
@@ -0,0 +1,395 @@
+#include "ClusteredGrid.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace
+{
+    using gol::CellAddress;
+    using gol::ClusteredGrid;
+
+    //
+    // Live cells are kept at least this far inside their board, so that
+    // births always land on it. Cells on neighboring boards are then at least
+    // three apart and share no neighbors.
+    //
+    constexpr int64_t EdgeClearance{1};
+
+    //
+    // Loose cells are first grouped by buckets of Margin x Margin cells.
+    //
+    constexpr int64_t BucketShift{5};
+    static_assert(ClusteredGrid::Margin == int64_t(1) << BucketShift);
+
+    class UnionFind
+    {
+    public:
+        explicit UnionFind(size_t size)
+            : m_parents(size)
+        {
+            std::iota(std::begin(m_parents), std::end(m_parents), size_t(0));
+        }
+
+        size_t Find(size_t index)
+        {
+            while (m_parents[index] != index)
+            {
+                m_parents[index] = m_parents[m_parents[index]];
+                index = m_parents[index];
+            }
+            return index;
+        }
+
+        //
+        // Returns false if a and b were already joined.
+        //
+        bool Join(size_t a, size_t b)
+        {
+            a = Find(a);
+            b = Find(b);
+            if (a == b) { return false; }
+
+            m_parents[std::max(a, b)] = std::min(a, b);
+            return true;
+        }
+
+    private:
+        std::vector<size_t> m_parents;
+    };
+
+    void Include(CellAddress& min, CellAddress& max, const CellAddress& address)
+    {
+        min.first = std::min(min.first, address.first);
+        min.second = std::min(min.second, address.second);
+        max.first = std::max(max.first, address.first);
+        max.second = std::max(max.second, address.second);
+    }
+
+    bool Overlap(
+        const CellAddress& minA,
+        const CellAddress& maxA,
+        const CellAddress& minB,
+        const CellAddress& maxB)
+    {
+        return minA.first <= maxB.first && minB.first <= maxA.first &&
+               minA.second <= maxB.second && minB.second <= maxA.second;
+    }
+}
+
+namespace gol
+{
+    struct ClusteredGrid::Piece
+    {
+        //
+        // The area the piece's board has to cover, inclusive.
+        //
+        CellAddress Min;
+        CellAddress Max;
+
+        //
+        // An existing cluster keeps its board for as long as it isn't merged.
+        //
+        Cluster Existing;
+        std::vector<CellAddress> Cells;
+    };
+
+    ClusteredGrid::ClusteredGrid(
+        const std::vector<CellAddress>& cellAddresses,
+        size_t numThreads)
+    {
+        if (numThreads > 1)
+        {
+            m_pool = std::make_unique<ThreadPool>(numThreads);
+        }
+
+        Regroup(cellAddresses);
+    }
+
+    ClusteredGrid::~ClusteredGrid() = default;
+
+    void ClusteredGrid::AdvanceGeneration()
+    {
+        auto StepCluster = [this](size_t clusterIndex)
+        {
+            auto& cluster = m_clusters[clusterIndex];
+            cluster.pBoard->AdvanceGeneration();
+            cluster.Empty = !cluster.pBoard->GetLiveBounds(cluster.LiveMin, cluster.LiveMax);
+        };
+
+        if (m_pool)
+        {
+            m_pool->ParallelFor(m_clusters.size(), StepCluster);
+        }
+        else
+        {
+            for (size_t i = 0; i < m_clusters.size(); ++i) { StepCluster(i); }
+        }
+
+        //
+        // Dead clusters are dropped; those which came too close to their
+        // edge are broken back up into cells and regrouped.
+        //
+        std::vector<CellAddress> looseCells;
+        size_t numKept{0};
+        for (auto& cluster : m_clusters)
+        {
+            if (cluster.Empty) { continue; }
+
+            const auto& Bounds = cluster.pBoard->GetBounds();
+            const bool NearEdge =
+                cluster.LiveMin.first - Bounds.Origin.first < EdgeClearance ||
+                cluster.LiveMin.second - Bounds.Origin.second < EdgeClearance ||
+                Bounds.Origin.first + Bounds.Width - 1 - cluster.LiveMax.first < EdgeClearance ||
+                Bounds.Origin.second + Bounds.Height - 1 - cluster.LiveMax.second < EdgeClearance;
+            if (NearEdge)
+            {
+                cluster.pBoard->ForEachLiveCell([&looseCells](const CellAddress& address)
+                {
+                    looseCells.push_back(address);
+                });
+                continue;
+            }
+
+            if (&m_clusters[numKept] != &cluster) { m_clusters[numKept] = std::move(cluster); }
+            ++numKept;
+        }
+        m_clusters.resize(numKept);
+
+        if (!looseCells.empty()) { Regroup(looseCells); }
+    }
+
+    std::vector<Cell> ClusteredGrid::GetLiveCells() const
+    {
+        //
+        // Clusters are too far apart to be each other's neighbors, so every
+        // board's neighbor counts are complete.
+        //
+        std::vector<Cell> liveCells;
+        for (const auto& Current : m_clusters)
+        {
+            const auto ClusterCells = Current.pBoard->GetLiveCells();
+            liveCells.insert(
+                std::end(liveCells),
+                std::begin(ClusterCells),
+                std::end(ClusterCells));
+        }
+
+        std::sort(
+            std::begin(liveCells),
+            std::end(liveCells),
+            [](const Cell& a, const Cell& b) { return a.Address < b.Address; });
+        return liveCells;
+    }
+
+    size_t ClusteredGrid::MemoryFootprint() const
+    {
+        size_t bytes{m_clusters.capacity() * sizeof(Cluster)};
+        for (const auto& Current : m_clusters)
+        {
+            bytes += sizeof(DenseGrid) + Current.pBoard->MemoryFootprint();
+        }
+        return bytes;
+    }
+
+    void ClusteredGrid::Regroup(const std::vector<CellAddress>& looseCells)
+    {
+        constexpr int64_t MinCoordinate{std::numeric_limits<int64_t>::min()};
+        constexpr int64_t MaxCoordinate{std::numeric_limits<int64_t>::max()};
+
+        //
+        // Loose cells in the same or neighboring buckets start out in the
+        // same piece.
+        //
+        std::vector<std::pair<CellAddress, CellAddress>> bucketed;
+        bucketed.reserve(looseCells.size());
+        for (const auto& Address : looseCells)
+        {
+            bucketed.emplace_back(
+                CellAddress(Address.first >> BucketShift, Address.second >> BucketShift),
+                Address);
+        }
+        std::sort(std::begin(bucketed), std::end(bucketed));
+
+        std::vector<CellAddress> buckets;
+        for (const auto& [Bucket, Address] : bucketed)
+        {
+            if (buckets.empty() || buckets.back() != Bucket) { buckets.push_back(Bucket); }
+        }
+
+        UnionFind bucketGroups(buckets.size());
+        for (size_t i = 0; i < buckets.size(); ++i)
+        {
+            //
+            // Only neighbors after this bucket need checking; the others have
+            // checked this one. Bucket keys never reach the ends of int64_t.
+            //
+            const CellAddress Bucket{buckets[i]};
+            const CellAddress Neighbors[] = {
+                { Bucket.first, Bucket.second + 1 },
+                { Bucket.first + 1, Bucket.second - 1 },
+                { Bucket.first + 1, Bucket.second },
+                { Bucket.first + 1, Bucket.second + 1 },
+            };
+            for (const auto& Neighbor : Neighbors)
+            {
+                const auto It = std::lower_bound(std::begin(buckets), std::end(buckets), Neighbor);
+                if (It != std::end(buckets) && *It == Neighbor)
+                {
+                    bucketGroups.Join(i, static_cast<size_t>(It - std::begin(buckets)));
+                }
+            }
+        }
+
+        std::vector<Piece> pieces;
+        std::vector<size_t> pieceOfGroup(buckets.size(), SIZE_MAX);
+        size_t bucketIndex{0};
+        for (const auto& [Bucket, Address] : bucketed)
+        {
+            while (buckets[bucketIndex] != Bucket) { ++bucketIndex; }
+
+            size_t& pieceIndex = pieceOfGroup[bucketGroups.Find(bucketIndex)];
+            if (pieceIndex == SIZE_MAX)
+            {
+                pieceIndex = pieces.size();
+                pieces.emplace_back();
+                pieces.back().Min = Address;
+                pieces.back().Max = Address;
+            }
+
+            auto& piece = pieces[pieceIndex];
+            Include(piece.Min, piece.Max, Address);
+            piece.Cells.push_back(Address);
+        }
+
+        for (auto& piece : pieces)
+        {
+            if (piece.Min.first < MinCoordinate + Margin ||
+                piece.Min.second < MinCoordinate + Margin ||
+                piece.Max.first > MaxCoordinate - Margin ||
+                piece.Max.second > MaxCoordinate - Margin)
+            {
+                throw std::out_of_range(
+                    "A cluster came within " + std::to_string(Margin) +
+                    " cells of the edge of the plane.");
+            }
+
+            piece.Min = CellAddress(piece.Min.first - Margin, piece.Min.second - Margin);
+            piece.Max = CellAddress(piece.Max.first + Margin, piece.Max.second + Margin);
+        }
+
+        for (auto& cluster : m_clusters)
+        {
+            const auto& Bounds = cluster.pBoard->GetBounds();
+
+            Piece piece;
+            piece.Min = Bounds.Origin;
+            piece.Max = CellAddress(
+                Bounds.Origin.first + Bounds.Width - 1,
+                Bounds.Origin.second + Bounds.Height - 1);
+            piece.Existing = std::move(cluster);
+            pieces.push_back(std::move(piece));
+        }
+        m_clusters.clear();
+
+        //
+        // Merge overlapping pieces until none are left. A merged piece covers
+        // both, so it may overlap others in turn.
+        //
+        for (bool merged = true; merged;)
+        {
+            merged = false;
+            std::sort(
+                std::begin(pieces),
+                std::end(pieces),
+                [](const Piece& a, const Piece& b) { return a.Min.first < b.Min.first; });
+
+            UnionFind groups(pieces.size());
+            for (size_t i = 0; i < pieces.size(); ++i)
+            {
+                for (size_t j = i + 1;
+                     j < pieces.size() && pieces[j].Min.first <= pieces[i].Max.first;
+                     ++j)
+                {
+                    if (Overlap(pieces[i].Min, pieces[i].Max, pieces[j].Min, pieces[j].Max))
+                    {
+                        merged = groups.Join(i, j) || merged;
+                    }
+                }
+            }
+
+            if (!merged) { break; }
+
+            //
+            // Groups are represented by their first piece, which absorbs the
+            // rest. Merged boards are broken up into cells.
+            //
+            auto Loosen = [](Piece& piece)
+            {
+                if (!piece.Existing.pBoard) { return; }
+
+                piece.Existing.pBoard->ForEachLiveCell([&piece](const CellAddress& address)
+                {
+                    piece.Cells.push_back(address);
+                });
+                piece.Existing = Cluster();
+            };
+
+            for (size_t i = 0; i < pieces.size(); ++i)
+            {
+                const size_t Root{groups.Find(i)};
+                if (Root == i) { continue; }
+
+                auto& root = pieces[Root];
+                auto& piece = pieces[i];
+                Loosen(root);
+                Loosen(piece);
+                Include(root.Min, root.Max, piece.Min);
+                Include(root.Min, root.Max, piece.Max);
+                root.Cells.insert(std::end(root.Cells), std::begin(piece.Cells), std::end(piece.Cells));
+                piece.Cells.clear();
+                piece.Cells.shrink_to_fit();
+            }
+
+            size_t numRoots{0};
+            for (size_t i = 0; i < pieces.size(); ++i)
+            {
+                if (groups.Find(i) != i) { continue; }
+
+                if (numRoots != i) { pieces[numRoots] = std::move(pieces[i]); }
+                ++numRoots;
+            }
+            pieces.resize(numRoots);
+        }
+
+        m_clusters.reserve(pieces.size());
+        for (auto& piece : pieces)
+        {
+            if (piece.Existing.pBoard)
+            {
+                m_clusters.push_back(std::move(piece.Existing));
+                continue;
+            }
+
+            DenseBounds bounds;
+            bounds.Origin = piece.Min;
+            bounds.Width = piece.Max.first - piece.Min.first + 1;
+            bounds.Height = piece.Max.second - piece.Min.second + 1;
+
+            Cluster cluster;
+            cluster.pBoard = std::make_unique<DenseGrid>(piece.Cells, bounds);
+            cluster.LiveMin = piece.Cells.front();
+            cluster.LiveMax = piece.Cells.front();
+            for (const auto& Address : piece.Cells)
+            {
+                Include(cluster.LiveMin, cluster.LiveMax, Address);
+            }
+            m_clusters.push_back(std::move(cluster));
+        }
+    }
+}
@@ -0,0 +1,118 @@
+//
+// Engine for patterns made of many small clusters scattered across the plane,
+// e.g. a glider near the origin and a block trillions of cells away.
+//
+// Live cells are grouped into clusters, each simulated on a dense board of its
+// own (see DenseGrid) covering its bounding box plus a growth margin. Boards
+// use local coordinates, so the hot loop never touches 64-bit addresses, and
+// the clusters of a generation are stepped in parallel on a thread pool.
+//
+// Every live cell is kept off the edge of its board, so births always land
+// on the board, and boards never overlap, so clusters can't interact. A
+// cluster which reaches its edge gets a new board, and its cells are split
+// into clusters again: parts which have drifted apart (e.g. gliders leaving a
+// gun) go their own way. Whenever boards would overlap, their clusters are
+// merged onto one board covering both.
+//
+// Only Conway's rules (B3/S23) are supported. Clusters are meant to stay
+// compact; a cluster spread over a large area takes a board of that area.
+//
+
+#pragma once
+
+#include "Cell.h"
+#include "DenseGrid.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace gol
+{
+    class ThreadPool;
+
+    class ClusteredGrid
+    {
+    public:
+        //
+        // cellAddresses lists all live cells which describes the initial state.
+        // Clusters are stepped on a pool of numThreads threads. Throws
+        // std::out_of_range if a cell lies within a margin of the edge of the
+        // 64-bit plane.
+        //
+        ClusteredGrid(
+            const std::vector<CellAddress>& cellAddresses,
+            size_t numThreads = 1);
+
+        ~ClusteredGrid();
+
+        //
+        // Advance the generation by one single iteration.
+        //
+        void AdvanceGeneration();
+
+        //
+        // Retrieve live cells for testing and output, sorted by address.
+        //
+        std::vector<Cell> GetLiveCells() const;
+
+        //
+        // Calls visitor(const CellAddress&) for every live cell, cluster by
+        // cluster.
+        //
+        template<typename Visitor>
+        void ForEachLiveCell(Visitor&& visitor) const;
+
+        size_t GetClusterCount() const { return m_clusters.size(); }
+
+        //
+        // Approximate number of bytes held by the boards.
+        //
+        size_t MemoryFootprint() const;
+
+        //
+        // Space left around a cluster's bounding box when it gets a new
+        // board, and so also how far apart clusters stay separate.
+        //
+        static constexpr int64_t Margin{32};
+
+    private:
+        struct Cluster
+        {
+            std::unique_ptr<DenseGrid> pBoard;
+
+            //
+            // Inclusive bounding box of the live cells, as of the last step.
+            //
+            CellAddress LiveMin;
+            CellAddress LiveMax;
+            bool        Empty = false;
+        };
+
+        //
+        // A board-to-be during regrouping: either an existing cluster's board
+        // or loose cells, plus the area its board must cover.
+        //
+        struct Piece;
+
+        //
+        // Groups the loose cells into new clusters, then merges clusters
+        // (old and new) until no two boards overlap. Merged clusters get a new
+        // board covering both of theirs; the rest keep theirs.
+        //
+        void Regroup(const std::vector<CellAddress>& looseCells);
+
+        std::vector<Cluster> m_clusters;
+        std::unique_ptr<ThreadPool> m_pool;
+    };
+
+    template<typename Visitor>
+    void ClusteredGrid::ForEachLiveCell(Visitor&& visitor) const
+    {
+        for (const auto& Current : m_clusters)
+        {
+            Current.pBoard->ForEachLiveCell(visitor);
+        }
+    }
+}
@@ -0,0 +1,276 @@
+#include "DeltaStream.h"
+#include "CellEncoding.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <limits>
+
+namespace
+{
+    constexpr char     Magic[8] = { 'G', 'O', 'L', 'D', 'E', 'L', 'T', '\0' };
+    constexpr uint32_t Version{1};
+    constexpr size_t   HeaderBytes{sizeof(Magic) + 4};
+
+    const char* const TextSignature = "#Life deltas\n";
+
+    //
+    // The longest decimal forms: digits10 falls one short of the number of
+    // digits, and coordinates may need a minus sign on top.
+    //
+    constexpr size_t MaxGenerationChars{std::numeric_limits<uint64_t>::digits10 + 1};
+    constexpr size_t MaxCoordinateChars{std::numeric_limits<int64_t>::digits10 + 2};
+
+    bool ReadBinaryDeltas(
+        const char* pData,
+        size_t size,
+        const gol::DeltaVisitor& visitor,
+        std::string& error)
+    {
+        using namespace gol;
+
+        if (size < HeaderBytes || std::memcmp(pData, Magic, sizeof(Magic)) != 0)
+        {
+            error = "Not a delta stream.";
+            return false;
+        }
+
+        uint32_t version{0};
+        for (size_t i = 0; i < 4; ++i)
+        {
+            const uint8_t Byte{static_cast<uint8_t>(pData[sizeof(Magic) + i])};
+            version |= uint32_t(Byte) << (8 * i);
+        }
+        if (version != Version)
+        {
+            error = "Unsupported delta stream version.";
+            return false;
+        }
+
+        std::vector<CellAddress> births;
+        std::vector<CellAddress> deaths;
+        const char* pCursor = pData + HeaderBytes;
+        const char* pEnd = pData + size;
+        while (pCursor != pEnd)
+        {
+            uint64_t generation{0};
+            uint64_t numBirths{0};
+            uint64_t numDeaths{0};
+            pCursor = GetVarint(pCursor, pEnd, generation);
+            if (pCursor) { pCursor = GetVarint(pCursor, pEnd, numBirths); }
+            if (pCursor) { pCursor = GetVarint(pCursor, pEnd, numDeaths); }
+
+            births.clear();
+            deaths.clear();
+            if (pCursor)
+            {
+                pCursor = GetSortedAddresses(pCursor, pEnd, numBirths, births);
+            }
+            if (pCursor)
+            {
+                pCursor = GetSortedAddresses(pCursor, pEnd, numDeaths, deaths);
+            }
+            if (!pCursor)
+            {
+                error = "Truncated or corrupt delta record.";
+                return false;
+            }
+
+            visitor(generation, births, deaths);
+        }
+
+        return true;
+    }
+
+    //
+    // Lines are "G <generation>" followed by that record's "+<x> <y>" births
+    // and "-<x> <y>" deaths. Each record is handed over when the next one
+    // starts, or at the end.
+    //
+    bool ReadTextDeltas(
+        const char* pData,
+        size_t size,
+        const gol::DeltaVisitor& visitor,
+        std::string& error)
+    {
+        using gol::CellAddress;
+
+        std::vector<CellAddress> births;
+        std::vector<CellAddress> deaths;
+        uint64_t generation{0};
+        bool inRecord{false};
+
+        const char* pCursor = pData;
+        const char* pEnd = pData + size;
+        while (pCursor != pEnd)
+        {
+            const char* pLineEnd = static_cast<const char*>(
+                std::memchr(pCursor, '\n', static_cast<size_t>(pEnd - pCursor)));
+            if (!pLineEnd)
+            {
+                error = "Truncated delta record.";
+                return false;
+            }
+
+            bool valid{pLineEnd - pCursor > 1};
+            if (valid && *pCursor == 'G')
+            {
+                if (inRecord) { visitor(generation, births, deaths); }
+                births.clear();
+                deaths.clear();
+                inRecord = true;
+
+                const auto Result = std::from_chars(pCursor + 2, pLineEnd, generation);
+                valid = pCursor[1] == ' ' && Result.ec == std::errc() && Result.ptr == pLineEnd;
+            }
+            else if (valid && inRecord && (*pCursor == '+' || *pCursor == '-'))
+            {
+                CellAddress address;
+                auto Result = std::from_chars(pCursor + 1, pLineEnd, address.first);
+                valid = Result.ec == std::errc() && Result.ptr != pLineEnd && *Result.ptr == ' ';
+                if (valid)
+                {
+                    Result = std::from_chars(Result.ptr + 1, pLineEnd, address.second);
+                    valid = Result.ec == std::errc() && Result.ptr == pLineEnd;
+                }
+                if (valid) { (*pCursor == '+' ? births : deaths).push_back(address); }
+            }
+            else
+            {
+                valid = false;
+            }
+
+            if (!valid)
+            {
+                error = "Malformed delta line: " + std::string(pCursor, pLineEnd);
+                return false;
+            }
+
+            pCursor = pLineEnd + 1;
+        }
+
+        if (inRecord) { visitor(generation, births, deaths); }
+        return true;
+    }
+}
+
+namespace gol
+{
+    DeltaWriter::DeltaWriter(
+        std::FILE* pFile,
+        DeltaFormat format,
+        size_t bufferSize)
+        : m_pFile(pFile),
+          m_format(format),
+          m_bufferSize(bufferSize)
+    {
+        m_buffer.reserve(m_bufferSize);
+        if (m_format == DeltaFormat::Binary)
+        {
+            m_buffer.insert(std::end(m_buffer), std::begin(Magic), std::end(Magic));
+            for (size_t i = 0; i < 4; ++i)
+            {
+                m_buffer.push_back(static_cast<char>(Version >> (8 * i)));
+            }
+        }
+        else
+        {
+            m_buffer.insert(
+                std::end(m_buffer),
+                TextSignature,
+                TextSignature + std::strlen(TextSignature));
+        }
+    }
+
+    DeltaWriter::~DeltaWriter()
+    {
+        Flush();
+    }
+
+    void DeltaWriter::WriteGeneration(
+        uint64_t generation,
+        std::vector<CellAddress>& births,
+        std::vector<CellAddress>& deaths)
+    {
+        std::sort(std::begin(births), std::end(births));
+        std::sort(std::begin(deaths), std::end(deaths));
+
+        if (m_format == DeltaFormat::Binary)
+        {
+            PutVarint(m_buffer, generation);
+            PutVarint(m_buffer, births.size());
+            PutVarint(m_buffer, deaths.size());
+            PutSortedAddresses(m_buffer, births);
+            PutSortedAddresses(m_buffer, deaths);
+        }
+        else
+        {
+            char line[MaxGenerationChars];
+            char* pEnd = std::to_chars(line, line + sizeof(line), generation).ptr;
+            m_buffer.push_back('G');
+            m_buffer.push_back(' ');
+            m_buffer.insert(std::end(m_buffer), line, pEnd);
+            m_buffer.push_back('\n');
+
+            for (const auto& Address : births) { WriteText('+', Address); }
+            for (const auto& Address : deaths) { WriteText('-', Address); }
+        }
+
+        //
+        // The buffer may overshoot by one generation's worth before it's
+        // handed off.
+        //
+        if (m_buffer.size() >= m_bufferSize) { Flush(); }
+    }
+
+    bool DeltaWriter::Flush()
+    {
+        if (!m_buffer.empty())
+        {
+            const size_t Written{
+                std::fwrite(m_buffer.data(), 1, m_buffer.size(), m_pFile)};
+            m_good = m_good && Written == m_buffer.size();
+            m_buffer.clear();
+        }
+
+        m_good = m_good && std::fflush(m_pFile) == 0;
+        return m_good;
+    }
+
+    void DeltaWriter::WriteText(char sign, const CellAddress& address)
+    {
+        //
+        // Each number is given just its own room, so the separators after
+        // it always fit.
+        //
+        char line[1 + MaxCoordinateChars + 1 + MaxCoordinateChars + 1];
+        char* pCursor = line;
+        *pCursor++ = sign;
+        pCursor = std::to_chars(pCursor, pCursor + MaxCoordinateChars, address.first).ptr;
+        *pCursor++ = ' ';
+        pCursor = std::to_chars(pCursor, pCursor + MaxCoordinateChars, address.second).ptr;
+        *pCursor++ = '\n';
+
+        m_buffer.insert(std::end(m_buffer), line, pCursor);
+    }
+
+    bool ReadDeltaStream(
+        const char* pData,
+        size_t size,
+        const DeltaVisitor& visitor,
+        std::string& error)
+    {
+        const size_t SignatureLength{std::strlen(TextSignature)};
+        if (size >= SignatureLength &&
+            std::memcmp(pData, TextSignature, SignatureLength) == 0)
+        {
+            return ReadTextDeltas(
+                pData + SignatureLength,
+                size - SignatureLength,
+                visitor,
+                error);
+        }
+
+        return ReadBinaryDeltas(pData, size, visitor, error);
+    }
+}
@@ -0,0 +1,99 @@
+//
+// Per-generation change streams: rather than the whole live set, each
+// generation records just the cells which were born and the cells which died.
+// Replaying the stream from its first record reconstructs any generation, at
+// a cost proportional to activity rather than population.
+//
+// Two formats are available:
+//
+// Text, one line per change after a "#Life deltas" signature line:
+//     G <generation>
+//     +<x> <y>    (birth)
+//     -<x> <y>    (death)
+//
+// Binary, a "GOLDELT" magic and a 32-bit little-endian version, followed by
+// one record per generation: varint generation, varint birth count, varint
+// death count, then the births and deaths as sorted cell lists (see
+// CellEncoding.h).
+//
+
+#pragma once
+
+#include "Cell.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace gol
+{
+    enum class DeltaFormat
+    {
+        Text,
+        Binary,
+    };
+
+    class DeltaWriter
+    {
+    public:
+        static constexpr size_t DefaultBufferSize{size_t(1) << 20};
+
+        DeltaWriter(
+            std::FILE* pFile,
+            DeltaFormat format,
+            size_t bufferSize = DefaultBufferSize);
+
+        //
+        // Flushes whatever is still buffered.
+        //
+        ~DeltaWriter();
+
+        DeltaWriter(const DeltaWriter&) = delete;
+        DeltaWriter& operator=(const DeltaWriter&) = delete;
+
+        //
+        // Records the changes leading up to generation. The first record of a
+        // stream should list the whole starting live set as births. Both
+        // lists are sorted in place.
+        //
+        void WriteGeneration(
+            uint64_t generation,
+            std::vector<CellAddress>& births,
+            std::vector<CellAddress>& deaths);
+
+        //
+        // Returns false if any write so far has failed.
+        //
+        bool Flush();
+        bool Good() const noexcept { return m_good; }
+
+    private:
+        void WriteText(char sign, const CellAddress& address);
+
+        std::FILE*        m_pFile;
+        DeltaFormat       m_format;
+        size_t            m_bufferSize;
+        std::vector<char> m_buffer;
+        bool              m_good = true;
+    };
+
+    using DeltaVisitor = std::function<void(
+        uint64_t generation,
+        const std::vector<CellAddress>& births,
+        const std::vector<CellAddress>& deaths)>;
+
+    //
+    // Decodes a delta stream already in memory, in either format, calling
+    // visitor once per record in order. Returns false and fills in error if
+    // the stream is malformed; records before the bad one will have been
+    // visited.
+    //
+    bool ReadDeltaStream(
+        const char* pData,
+        size_t size,
+        const DeltaVisitor& visitor,
+        std::string& error);
+}
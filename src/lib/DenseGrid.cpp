@@ -0,0 +1,489 @@
+#include "DenseGrid.h"
+#include "DenseKernel.h"
+
+#include <algorithm>
+#include <charconv>
+#include <limits>
+#include <stdexcept>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+namespace
+{
+    using gol::DenseGrid;
+
+    constexpr size_t BitsPerWord{64};
+
+    //
+    // AdvanceGenerations aims to keep both scratch strips within this many
+    // bytes, about the size of a recent CPU's L2 cache. A strip advances at
+    // most MaxBlockGenerations generations per pass. Its halo costs as many
+    // extra rows, so the strip is kept at least MinRowsPerGeneration times
+    // taller than that.
+    //
+    constexpr size_t BlockCacheBytes{size_t(1) << 20};
+    constexpr int64_t MaxBlockGenerations{16};
+    constexpr int64_t MinRowsPerGeneration{8};
+
+    bool ParseInteger(const char* pFirst, const char* pLast, int64_t& value)
+    {
+        const auto Result = std::from_chars(pFirst, pLast, value);
+        return Result.ec == std::errc() && Result.ptr == pLast;
+    }
+
+    //
+    // Indices of the lowest and highest set bits of a non-zero word.
+    //
+    size_t LowestBit(uint64_t word)
+    {
+#if defined(_MSC_VER) && !defined(__clang__)
+        unsigned long index;
+        _BitScanForward64(&index, word);
+        return index;
+#else
+        return static_cast<size_t>(__builtin_ctzll(word));
+#endif
+    }
+
+    size_t HighestBit(uint64_t word)
+    {
+#if defined(_MSC_VER) && !defined(__clang__)
+        unsigned long index;
+        _BitScanReverse64(&index, word);
+        return index;
+#else
+        return static_cast<size_t>(63 - __builtin_clzll(word));
+#endif
+    }
+
+    DenseGrid::Kernel FastestKernel()
+    {
+        return DenseGrid::IsKernelSupported(DenseGrid::Kernel::Avx2)
+            ? DenseGrid::Kernel::Avx2
+            : DenseGrid::Kernel::Scalar;
+    }
+}
+
+namespace gol
+{
+    namespace dense
+    {
+        void StepRowScalar(
+            const uint64_t* pAbove,
+            const uint64_t* pRow,
+            const uint64_t* pBelow,
+            uint64_t* pOut,
+            size_t numWords)
+        {
+            for (size_t w = 0; w < numWords; ++w)
+            {
+                pOut[w] = NextWordScalar(pAbove, pRow, pBelow, w);
+            }
+        }
+
+        bool Avx2Available()
+        {
+#if !defined(GOL_DENSE_AVX2)
+            return false;
+#elif defined(_MSC_VER) && !defined(__clang__)
+            //
+            // AVX2 is CPUID leaf 7, EBX bit 5. The OS must also save the YMM
+            // registers on context switches: OSXSAVE is leaf 1, ECX bit 27,
+            // and XCR0 then has to enable both SSE and AVX state.
+            //
+            int info[4];
+            __cpuid(info, 1);
+            if (!(info[2] & (1 << 27))) { return false; }
+            if ((_xgetbv(0) & 0x6) != 0x6) { return false; }
+
+            __cpuidex(info, 7, 0);
+            return (info[1] & (1 << 5)) != 0;
+#else
+            //
+            // Also checks that the OS has enabled AVX state.
+            //
+            return __builtin_cpu_supports("avx2");
+#endif
+        }
+    }
+
+    bool ParseDenseBounds(
+        const std::string& text,
+        DenseTopology topology,
+        DenseBounds& bounds,
+        std::string& error)
+    {
+        error = "Invalid board size \"" + text + "\"; expected WxH or WxH@X,Y.";
+
+        const char* const pBegin{text.data()};
+        const char* const pEnd{pBegin + text.size()};
+        const char* const pAt{std::find(pBegin, pEnd, '@')};
+        const char* const pTimes{std::find(pBegin, pAt, 'x')};
+        if (pTimes == pAt) { return false; }
+
+        DenseBounds parsed;
+        parsed.Topology = topology;
+        if (!ParseInteger(pBegin, pTimes, parsed.Width) ||
+            !ParseInteger(pTimes + 1, pAt, parsed.Height) ||
+            parsed.Width <= 0 || parsed.Height <= 0)
+        {
+            return false;
+        }
+
+        if (pAt != pEnd)
+        {
+            const char* const pComma{std::find(pAt + 1, pEnd, ',')};
+            if (pComma == pEnd ||
+                !ParseInteger(pAt + 1, pComma, parsed.Origin.first) ||
+                !ParseInteger(pComma + 1, pEnd, parsed.Origin.second))
+            {
+                return false;
+            }
+        }
+
+        bounds = parsed;
+        error.clear();
+        return true;
+    }
+
+    DenseGrid::DenseGrid(
+        const std::vector<CellAddress>& cellAddresses,
+        const DenseBounds& bounds)
+        : m_bounds(bounds)
+        , m_kernel(FastestKernel())
+    {
+        constexpr int64_t Max{std::numeric_limits<int64_t>::max()};
+        if (bounds.Width <= 0 || bounds.Height <= 0)
+        {
+            throw std::invalid_argument("Dense boards can't be empty.");
+        }
+        if (bounds.Origin.first > Max - (bounds.Width - 1) ||
+            bounds.Origin.second > Max - (bounds.Height - 1))
+        {
+            throw std::invalid_argument("Dense board extends past the largest coordinate.");
+        }
+
+        const uint64_t Width{static_cast<uint64_t>(bounds.Width)};
+        const uint64_t Height{static_cast<uint64_t>(bounds.Height)};
+        const uint64_t WordsPerRow{(Width + BitsPerWord - 1) / BitsPerWord};
+        const uint64_t MaxWords{std::numeric_limits<size_t>::max() / sizeof(uint64_t)};
+        if (Height + 2 > MaxWords / (WordsPerRow + 2))
+        {
+            throw std::invalid_argument("Dense board is too large.");
+        }
+
+        m_wordsPerRow = static_cast<size_t>(WordsPerRow);
+        m_stride = m_wordsPerRow + 2;
+        const size_t UsedBits{static_cast<size_t>(Width % BitsPerWord)};
+        m_lastWordMask = UsedBits ? (uint64_t(1) << UsedBits) - 1 : ~uint64_t(0);
+
+        const size_t NumWords{static_cast<size_t>(Height + 2) * m_stride};
+        m_current.assign(NumWords, 0);
+        m_next.assign(NumWords, 0);
+
+        for (const auto& Address : cellAddresses)
+        {
+            //
+            // Unsigned offsets catch cells before the origin too.
+            //
+            const uint64_t Column{
+                static_cast<uint64_t>(Address.first) - static_cast<uint64_t>(bounds.Origin.first)};
+            const uint64_t RowIndex{
+                static_cast<uint64_t>(Address.second) - static_cast<uint64_t>(bounds.Origin.second)};
+            if (Column >= Width || RowIndex >= Height)
+            {
+                throw std::out_of_range(
+                    "Cell " + std::to_string(Address.first) + " " +
+                    std::to_string(Address.second) + " lies outside the board.");
+            }
+
+            Row(m_current, static_cast<int64_t>(RowIndex))[Column / BitsPerWord] |=
+                uint64_t(1) << (Column % BitsPerWord);
+        }
+    }
+
+    void DenseGrid::AdvanceGeneration()
+    {
+        if (m_bounds.Topology == DenseTopology::Torus) { WrapEdges(); }
+
+        const auto StepRow = m_kernel == Kernel::Avx2
+            ? &dense::StepRowAvx2
+            : &dense::StepRowScalar;
+        for (int64_t row = 0; row < m_bounds.Height; ++row)
+        {
+            uint64_t* pOut{Row(m_next, row)};
+            StepRow(Row(row - 1), Row(row), Row(row + 1), pOut, m_wordsPerRow);
+
+            //
+            // Columns past the right edge may have been born from the last
+            // column; they aren't on the board.
+            //
+            pOut[m_wordsPerRow - 1] &= m_lastWordMask;
+        }
+
+        std::swap(m_current, m_next);
+    }
+
+    void DenseGrid::AdvanceGenerations(uint64_t numGenerations)
+    {
+        //
+        // Pick the strip height and generations per pass from how many
+        // padded rows fit in the cache budget. Boards which fit whole, and
+        // rows too wide for a useful strip, are simply stepped.
+        //
+        const size_t RowBytes{m_stride * sizeof(uint64_t)};
+        const int64_t BudgetRows{static_cast<int64_t>(BlockCacheBytes / (2 * RowBytes)) - 2};
+        const int64_t BlockGenerations{
+            std::min(MaxBlockGenerations, BudgetRows / (2 + MinRowsPerGeneration))};
+        if (m_bounds.Height <= BudgetRows || BlockGenerations < 2)
+        {
+            for (uint64_t i = 0; i < numGenerations; ++i) { AdvanceGeneration(); }
+            return;
+        }
+
+        const int64_t StripRows{BudgetRows - 2 * BlockGenerations};
+        for (uint64_t done = 0; done < numGenerations;)
+        {
+            const int64_t NumGenerations{static_cast<int64_t>(
+                std::min<uint64_t>(numGenerations - done, BlockGenerations))};
+            if (m_bounds.Topology == DenseTopology::Torus) { WrapEdges(); }
+            for (int64_t row = 0; row < m_bounds.Height; row += StripRows)
+            {
+                AdvanceStrip(row, std::min(row + StripRows, m_bounds.Height), NumGenerations);
+            }
+
+            std::swap(m_current, m_next);
+            done += static_cast<uint64_t>(NumGenerations);
+        }
+    }
+
+    void DenseGrid::AdvanceStrip(int64_t firstRow, int64_t lastRow, int64_t numGenerations)
+    {
+        //
+        // Block row i stands for board row haloStart + i. Rows past the edges
+        // of a bounded board are dead; on a torus they wrap around. Strips
+        // are only used on boards far taller than the halo, so wrapping
+        // once is enough.
+        //
+        const int64_t HaloStart{firstRow - numGenerations};
+        const int64_t NumRows{lastRow - firstRow + 2 * numGenerations};
+        const bool Torus{m_bounds.Topology == DenseTopology::Torus};
+        auto BoardRowOf = [this, HaloStart, Torus](int64_t blockRow) -> int64_t
+        {
+            int64_t boardRow{HaloStart + blockRow};
+            if (Torus)
+            {
+                if (boardRow < 0) { boardRow += m_bounds.Height; }
+                else if (boardRow >= m_bounds.Height) { boardRow -= m_bounds.Height; }
+                return boardRow;
+            }
+            return boardRow >= 0 && boardRow < m_bounds.Height ? boardRow : -1;
+        };
+        auto BlockRow = [this](std::vector<uint64_t>& block, int64_t row)
+        {
+            return block.data() + (row + 1) * m_stride + 1;
+        };
+
+        //
+        // The first generation reads the board itself, with the ghost row
+        // standing in for dead rows, and the last writes straight into
+        // m_next. Padding words are never written on a bounded board, so
+        // they stay zero from when the blocks were first grown.
+        //
+        auto CurrentRow = [this, &BoardRowOf](int64_t blockRow)
+        {
+            const int64_t BoardRow{BoardRowOf(blockRow)};
+            return Row(BoardRow >= 0 ? BoardRow : -1);
+        };
+
+        auto* pSource = &m_blocks[0];
+        auto* pTarget = &m_blocks[1];
+        const size_t BlockWords{static_cast<size_t>(NumRows + 2) * m_stride};
+        pSource->resize(std::max(pSource->size(), BlockWords));
+        pTarget->resize(std::max(pTarget->size(), BlockWords));
+
+        const auto StepRow = m_kernel == Kernel::Avx2
+            ? &dense::StepRowAvx2
+            : &dense::StepRowScalar;
+        for (int64_t generation = 1; generation <= numGenerations; ++generation)
+        {
+            //
+            // After each generation the rows within `generation` of either
+            // end of the block are stale: they'd have needed rows beyond it.
+            //
+            const bool First{generation == 1};
+            const bool Last{generation == numGenerations};
+            if (Torus && !First)
+            {
+                for (int64_t row = generation - 1; row < NumRows - generation + 1; ++row)
+                {
+                    WrapRow(BlockRow(*pSource, row));
+                }
+            }
+
+            for (int64_t row = generation; row < NumRows - generation; ++row)
+            {
+                const int64_t BoardRow{BoardRowOf(row)};
+                uint64_t* pOut{Last ? Row(m_next, BoardRow) : BlockRow(*pTarget, row)};
+                if (BoardRow < 0)
+                {
+                    std::fill_n(pOut, m_wordsPerRow, 0);
+                    continue;
+                }
+
+                if (First)
+                {
+                    StepRow(CurrentRow(row - 1), CurrentRow(row), CurrentRow(row + 1), pOut, m_wordsPerRow);
+                }
+                else
+                {
+                    StepRow(
+                        BlockRow(*pSource, row - 1),
+                        BlockRow(*pSource, row),
+                        BlockRow(*pSource, row + 1),
+                        pOut,
+                        m_wordsPerRow);
+                }
+                pOut[m_wordsPerRow - 1] &= m_lastWordMask;
+            }
+
+            std::swap(pSource, pTarget);
+        }
+    }
+
+    std::vector<Cell> DenseGrid::GetLiveCells() const
+    {
+        std::vector<Cell> liveCells;
+        ForEachLiveCell([this, &liveCells](const CellAddress& address)
+        {
+            const int64_t Column{address.first - m_bounds.Origin.first};
+            const int64_t RowIndex{address.second - m_bounds.Origin.second};
+
+            uint8_t neighborCount{0};
+            for (int64_t dy = -1; dy <= 1; ++dy)
+            {
+                for (int64_t dx = -1; dx <= 1; ++dx)
+                {
+                    if ((dx || dy) && IsAlive(Column + dx, RowIndex + dy))
+                    {
+                        ++neighborCount;
+                    }
+                }
+            }
+
+            const bool AliveCell{true};
+            liveCells.emplace_back(address, AliveCell, neighborCount);
+        });
+
+        //
+        // Rows are visited in order of y, but addresses sort by x first.
+        //
+        std::sort(
+            std::begin(liveCells),
+            std::end(liveCells),
+            [](const Cell& a, const Cell& b) { return a.Address < b.Address; });
+        return liveCells;
+    }
+
+    bool DenseGrid::GetLiveBounds(CellAddress& min, CellAddress& max) const
+    {
+        int64_t firstRow{-1};
+        int64_t lastRow{-1};
+        size_t firstColumn{std::numeric_limits<size_t>::max()};
+        size_t lastColumn{0};
+        for (int64_t row = 0; row < m_bounds.Height; ++row)
+        {
+            const uint64_t* pRow{Row(row)};
+            for (size_t w = 0; w < m_wordsPerRow; ++w)
+            {
+                if (!pRow[w]) { continue; }
+
+                if (firstRow < 0) { firstRow = row; }
+                lastRow = row;
+                firstColumn = std::min(firstColumn, w * BitsPerWord + LowestBit(pRow[w]));
+                lastColumn = std::max(lastColumn, w * BitsPerWord + HighestBit(pRow[w]));
+            }
+        }
+
+        if (firstRow < 0) { return false; }
+
+        min = CellAddress(
+            m_bounds.Origin.first + static_cast<int64_t>(firstColumn),
+            m_bounds.Origin.second + firstRow);
+        max = CellAddress(
+            m_bounds.Origin.first + static_cast<int64_t>(lastColumn),
+            m_bounds.Origin.second + lastRow);
+        return true;
+    }
+
+    void DenseGrid::SetKernel(Kernel kernel)
+    {
+        if (!IsKernelSupported(kernel))
+        {
+            throw std::invalid_argument("This CPU can't run the requested dense kernel.");
+        }
+        m_kernel = kernel;
+    }
+
+    bool DenseGrid::IsKernelSupported(Kernel kernel)
+    {
+        return kernel == Kernel::Scalar || dense::Avx2Available();
+    }
+
+    size_t DenseGrid::MemoryFootprint() const
+    {
+        return (m_current.capacity() + m_next.capacity() +
+                m_blocks[0].capacity() + m_blocks[1].capacity()) * sizeof(uint64_t);
+    }
+
+    bool DenseGrid::IsAlive(int64_t column, int64_t row) const
+    {
+        if (m_bounds.Topology == DenseTopology::Torus)
+        {
+            column = (column + m_bounds.Width) % m_bounds.Width;
+            row = (row + m_bounds.Height) % m_bounds.Height;
+        }
+        else if (column < 0 || column >= m_bounds.Width ||
+                 row < 0 || row >= m_bounds.Height)
+        {
+            return false;
+        }
+
+        const size_t Column{static_cast<size_t>(column)};
+        return (Row(row)[Column / BitsPerWord] >> (Column % BitsPerWord)) & 1;
+    }
+
+    void DenseGrid::WrapRow(uint64_t* pRow) const
+    {
+        const size_t Width{static_cast<size_t>(m_bounds.Width)};
+        const size_t LastColumn{Width - 1};
+
+        //
+        // The last column lands in bit 63 of the padding word before the
+        // row, and the first column in the bit just past the last column,
+        // which is either spare space in the last word or the padding word
+        // after the row. That bit is cleared again when the next generation
+        // is masked.
+        //
+        pRow[-1] = ((pRow[LastColumn / BitsPerWord] >> (LastColumn % BitsPerWord)) & 1) << 63;
+        pRow[m_wordsPerRow] = 0;
+        pRow[Width / BitsPerWord] |= (pRow[0] & 1) << (Width % BitsPerWord);
+    }
+
+    void DenseGrid::WrapEdges()
+    {
+        for (int64_t row = 0; row < m_bounds.Height; ++row)
+        {
+            WrapRow(Row(m_current, row));
+        }
+
+        //
+        // The ghost rows copy whole padded rows, corners included.
+        //
+        std::copy_n(Row(m_current, m_bounds.Height - 1) - 1, m_stride, Row(m_current, -1) - 1);
+        std::copy_n(Row(m_current, 0) - 1, m_stride, Row(m_current, m_bounds.Height) - 1);
+    }
+}
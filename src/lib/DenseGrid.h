@@ -0,0 +1,194 @@
+//
+// Board representation for finite boards: every cell of a fixed W x H
+// rectangle is one bit, with rows packed into 64-bit words. Each generation
+// is worked out a word at a time (four words at a time on CPUs with AVX2) by
+// adding up shifted copies of the rows with bitwise full adders, as in
+// TiledGrid but without any tiles to look up.
+//
+// On a bounded board everything outside the rectangle is permanently dead; a
+// torus wraps around, so the column after the last is the first, and likewise
+// for rows. Patterns that never reach the edge of a bounded board evolve
+// exactly as they would on the infinite plane.
+//
+// Only Conway's rules (B3/S23) are supported.
+//
+
+#pragma once
+
+#include "Cell.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace gol
+{
+    enum class DenseTopology
+    {
+        Bounded,
+        Torus,
+    };
+
+    struct DenseBounds
+    {
+        //
+        // The board covers x in [Origin.x, Origin.x + Width) and likewise for
+        // y.
+        //
+        CellAddress Origin{0, 0};
+        int64_t Width = 0;
+        int64_t Height = 0;
+        DenseTopology Topology = DenseTopology::Bounded;
+    };
+
+    //
+    // Parses "WxH" or "WxH@X,Y", e.g. "256x128" or "256x128@-128,-64". The
+    // origin defaults to 0,0.
+    //
+    // Returns false and fills in error if the text isn't a valid board size.
+    //
+    bool ParseDenseBounds(
+        const std::string& text,
+        DenseTopology topology,
+        DenseBounds& bounds,
+        std::string& error);
+
+    class DenseGrid
+    {
+    public:
+        enum class Kernel
+        {
+            Scalar,
+            Avx2,
+        };
+
+        //
+        // cellAddresses lists all live cells which describes the initial state.
+        // Throws std::out_of_range if any of them lies outside the board, and
+        // std::invalid_argument if the board is empty or too large to address.
+        //
+        DenseGrid(
+            const std::vector<CellAddress>& cellAddresses,
+            const DenseBounds& bounds);
+
+        //
+        // Advance the generation by one single iteration.
+        //
+        void AdvanceGeneration();
+
+        //
+        // Advance by numGenerations, with the same result as calling
+        // AdvanceGeneration that many times.
+        //
+        // Boards too big for the cache are worked through in strips of rows
+        // (temporal blocking). Each strip is copied into a scratch buffer
+        // together with a halo of one row per generation on either side. It
+        // is then advanced several generations while it stays in cache. The
+        // halo rows absorb the effects that would otherwise need the
+        // neighboring strips, so only the strip's own rows are copied back.
+        //
+        void AdvanceGenerations(uint64_t numGenerations);
+
+        //
+        // Retrieve live cells for testing and output, sorted by address.
+        //
+        std::vector<Cell> GetLiveCells() const;
+
+        //
+        // Calls visitor(const CellAddress&) for every live cell, row by row.
+        //
+        template<typename Visitor>
+        void ForEachLiveCell(Visitor&& visitor) const;
+
+        const DenseBounds& GetBounds() const { return m_bounds; }
+
+        //
+        // Finds the inclusive bounding box of the live cells, in one pass over
+        // the board. Returns false if every cell is dead.
+        //
+        bool GetLiveBounds(CellAddress& min, CellAddress& max) const;
+
+        //
+        // The fastest kernel this CPU supports is picked on construction.
+        // Throws std::invalid_argument when asked for one it can't run.
+        //
+        void SetKernel(Kernel kernel);
+        Kernel GetKernel() const { return m_kernel; }
+        static bool IsKernelSupported(Kernel kernel);
+
+        //
+        // Approximate number of bytes held by the board.
+        //
+        size_t MemoryFootprint() const;
+
+    private:
+        //
+        // Rows are stored with a word of padding at either end and a ghost row
+        // above and below the board. On a bounded board these stay dead; on a
+        // torus they are refreshed from the opposite edge before each
+        // generation.
+        //
+        uint64_t* Row(std::vector<uint64_t>& words, int64_t row) const
+        {
+            return words.data() + (row + 1) * m_stride + 1;
+        }
+        const uint64_t* Row(int64_t row) const
+        {
+            return m_current.data() + (row + 1) * m_stride + 1;
+        }
+
+        bool IsAlive(int64_t column, int64_t row) const;
+        void WrapEdges();
+
+        //
+        // Copies a torus row's edge columns into the bits either side of it.
+        //
+        void WrapRow(uint64_t* pRow) const;
+
+        //
+        // Advances the rows [firstRow, lastRow) numGenerations generations
+        // into m_next, working on a copy in m_blocks.
+        //
+        void AdvanceStrip(int64_t firstRow, int64_t lastRow, int64_t numGenerations);
+
+        DenseBounds m_bounds;
+        size_t m_wordsPerRow;
+        size_t m_stride;
+
+        //
+        // The bits of a row's last word that lie on the board.
+        //
+        uint64_t m_lastWordMask;
+        Kernel m_kernel;
+
+        std::vector<uint64_t> m_current;
+        std::vector<uint64_t> m_next;
+
+        //
+        // Scratch strips for AdvanceGenerations, laid out like the board.
+        //
+        std::vector<uint64_t> m_blocks[2];
+    };
+
+    template<typename Visitor>
+    void DenseGrid::ForEachLiveCell(Visitor&& visitor) const
+    {
+        for (int64_t row = 0; row < m_bounds.Height; ++row)
+        {
+            const uint64_t* pRow{Row(row)};
+            const int64_t Y{m_bounds.Origin.second + row};
+            for (size_t w = 0; w < m_wordsPerRow; ++w)
+            {
+                int64_t column{static_cast<int64_t>(w) * 64};
+                for (uint64_t bits = pRow[w]; bits; bits >>= 1, ++column)
+                {
+                    if (bits & 1)
+                    {
+                        visitor(CellAddress(m_bounds.Origin.first + column, Y));
+                    }
+                }
+            }
+        }
+    }
+}
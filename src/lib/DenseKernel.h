@@ -0,0 +1,112 @@
+//
+// Row kernels for DenseGrid. Each computes one row of the next B3/S23
+// generation from the current row and the rows above and below it.
+//
+// Rows are arrays of 64-bit words; bit c of word w is column 64 * w + c. The
+// pointers address word 0, and word -1 and word numWords must be readable:
+// they hold whatever lies just beyond either end of the row.
+//
+// The AVX2 kernel lives in its own translation unit, built with AVX2 enabled,
+// and must only be called when the CPU supports it.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace gol
+{
+    namespace dense
+    {
+        void StepRowScalar(
+            const uint64_t* pAbove,
+            const uint64_t* pRow,
+            const uint64_t* pBelow,
+            uint64_t* pOut,
+            size_t numWords);
+
+        void StepRowAvx2(
+            const uint64_t* pAbove,
+            const uint64_t* pRow,
+            const uint64_t* pBelow,
+            uint64_t* pOut,
+            size_t numWords);
+
+        //
+        // True if the AVX2 kernel was compiled in and the CPU (and OS) can
+        // run it.
+        //
+        bool Avx2Available();
+    }
+}
+
+//
+// Shared by both kernels' translation units. Internal linkage keeps each copy
+// compiled for its own instruction set: were it an ordinary inline function,
+// the linker could pick the AVX2 build for everyone.
+//
+namespace
+{
+    inline uint64_t AndNot(uint64_t a, uint64_t b)
+    {
+        return a & ~b;
+    }
+
+    template<typename Word>
+    void FullAdd(Word a, Word b, Word c, Word& sum, Word& carry)
+    {
+        const Word Partial = a ^ b;
+        sum = Partial ^ c;
+        carry = (a & b) | (Partial & c);
+    }
+
+    template<typename Word>
+    void HalfAdd(Word a, Word b, Word& sum, Word& carry)
+    {
+        sum = a ^ b;
+        carry = a & b;
+    }
+
+    //
+    // Adds up eight one-bit neighbor inputs per lane into four bit planes and
+    // applies B3/S23: alive next generation with exactly three neighbors, or
+    // with exactly two if already alive. Word needs &, |, ^ and an AndNot(a,
+    // b) computing a & ~b.
+    //
+    template<typename Word>
+    Word NextState(const Word (&neighbors)[8], Word alive)
+    {
+        Word onesA, twosA, onesB, twosB, onesC, twosC;
+        FullAdd(neighbors[0], neighbors[1], neighbors[2], onesA, twosA);
+        FullAdd(neighbors[3], neighbors[4], neighbors[5], onesB, twosB);
+        HalfAdd(neighbors[6], neighbors[7], onesC, twosC);
+
+        Word ones, twosD;
+        FullAdd(onesA, onesB, onesC, ones, twosD);
+
+        Word twosPartial, foursA, foursB, twos, fours, eights;
+        FullAdd(twosA, twosB, twosC, twosPartial, foursA);
+        HalfAdd(twosPartial, twosD, twos, foursB);
+        HalfAdd(foursA, foursB, fours, eights);
+
+        return AndNot(AndNot(twos & (ones | alive), fours), eights);
+    }
+
+    inline uint64_t NextWordScalar(
+        const uint64_t* pAbove,
+        const uint64_t* pRow,
+        const uint64_t* pBelow,
+        size_t w)
+    {
+        auto West = [w](const uint64_t* p) { return (p[w] << 1) | (p[w - 1] >> 63); };
+        auto East = [w](const uint64_t* p) { return (p[w] >> 1) | (p[w + 1] << 63); };
+
+        const uint64_t Neighbors[8] = {
+            West(pAbove), pAbove[w], East(pAbove),
+            West(pRow),              East(pRow),
+            West(pBelow), pBelow[w], East(pBelow),
+        };
+        return NextState(Neighbors, pRow[w]);
+    }
+}
@@ -0,0 +1,110 @@
+//
+// Built with AVX2 enabled where the compiler and target allow it (see
+// CMakeLists.txt); otherwise GOL_DENSE_AVX2 is left undefined and this kernel
+// is never selected. Nothing from the standard library is used here, so no
+// AVX2-compiled copy of a shared inline function can leak into the rest of
+// the program.
+//
+
+#include "DenseKernel.h"
+
+#if defined(GOL_DENSE_AVX2)
+
+#include <immintrin.h>
+
+namespace
+{
+    //
+    // Four words side by side, so that NextState can work on 256 cells at
+    // once.
+    //
+    struct Avx2Word
+    {
+        __m256i Bits;
+    };
+
+    Avx2Word operator&(Avx2Word a, Avx2Word b) { return { _mm256_and_si256(a.Bits, b.Bits) }; }
+    Avx2Word operator|(Avx2Word a, Avx2Word b) { return { _mm256_or_si256(a.Bits, b.Bits) }; }
+    Avx2Word operator^(Avx2Word a, Avx2Word b) { return { _mm256_xor_si256(a.Bits, b.Bits) }; }
+
+    Avx2Word AndNot(Avx2Word a, Avx2Word b)
+    {
+        return { _mm256_andnot_si256(b.Bits, a.Bits) };
+    }
+
+    Avx2Word Load(const uint64_t* p)
+    {
+        return { _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)) };
+    }
+
+    //
+    // The neighbor to the west of column c is column c - 1: shift each word
+    // up a bit and carry in the top bit of the word before it.
+    //
+    Avx2Word West(const uint64_t* p)
+    {
+        return { _mm256_or_si256(
+            _mm256_slli_epi64(Load(p).Bits, 1),
+            _mm256_srli_epi64(Load(p - 1).Bits, 63)) };
+    }
+
+    Avx2Word East(const uint64_t* p)
+    {
+        return { _mm256_or_si256(
+            _mm256_srli_epi64(Load(p).Bits, 1),
+            _mm256_slli_epi64(Load(p + 1).Bits, 63)) };
+    }
+}
+
+namespace gol
+{
+    namespace dense
+    {
+        void StepRowAvx2(
+            const uint64_t* pAbove,
+            const uint64_t* pRow,
+            const uint64_t* pBelow,
+            uint64_t* pOut,
+            size_t numWords)
+        {
+            constexpr size_t WordsPerVector{4};
+
+            size_t w{0};
+            for (; w + WordsPerVector <= numWords; w += WordsPerVector)
+            {
+                const Avx2Word Neighbors[8] = {
+                    West(pAbove + w), Load(pAbove + w), East(pAbove + w),
+                    West(pRow + w),                     East(pRow + w),
+                    West(pBelow + w), Load(pBelow + w), East(pBelow + w),
+                };
+                const Avx2Word Next{NextState(Neighbors, Load(pRow + w))};
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(pOut + w), Next.Bits);
+            }
+
+            for (; w < numWords; ++w)
+            {
+                pOut[w] = NextWordScalar(pAbove, pRow, pBelow, w);
+            }
+        }
+    }
+}
+
+#else
+
+namespace gol
+{
+    namespace dense
+    {
+        void StepRowAvx2(
+            const uint64_t* pAbove,
+            const uint64_t* pRow,
+            const uint64_t* pBelow,
+            uint64_t* pOut,
+            size_t numWords)
+        {
+            StepRowScalar(pAbove, pRow, pBelow, pOut, numWords);
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,317 @@
+#include "FlatCellMap.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GOL_FLATCELLMAP_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    constexpr int8_t Empty{-128};
+    constexpr size_t GroupWidth{16};
+    constexpr size_t MinCapacity{GroupWidth};
+
+    uint64_t HashAddress(const gol::CellAddress& address)
+    {
+        return gol::HashCoordinates(address.first, address.second);
+    }
+
+    size_t HomeIndex(uint64_t hash, size_t capacity)
+    {
+        return static_cast<size_t>(hash >> 7) & (capacity - 1);
+    }
+
+    int8_t ControlTag(uint64_t hash)
+    {
+        return static_cast<int8_t>(hash & 0x7F);
+    }
+
+    //
+    // Bit i of the returned masks corresponds to control byte i of the group.
+    //
+    struct GroupMasks
+    {
+        uint32_t Match;
+        uint32_t Empty;
+    };
+
+    GroupMasks ProbeGroup(const int8_t* pGroup, int8_t tag)
+    {
+#if defined(GOL_FLATCELLMAP_SSE2)
+        const __m128i Group =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(pGroup));
+        const uint32_t MatchMask = static_cast<uint32_t>(
+            _mm_movemask_epi8(_mm_cmpeq_epi8(Group, _mm_set1_epi8(tag))));
+
+        //
+        // Empty is the only negative control value, so the sign bits alone
+        // identify empty slots.
+        //
+        const uint32_t EmptyMask =
+            static_cast<uint32_t>(_mm_movemask_epi8(Group));
+        return { MatchMask, EmptyMask };
+#else
+        GroupMasks masks{0, 0};
+        for (size_t i = 0; i < GroupWidth; ++i)
+        {
+            masks.Match |= static_cast<uint32_t>(pGroup[i] == tag) << i;
+            masks.Empty |= static_cast<uint32_t>(pGroup[i] == Empty) << i;
+        }
+        return masks;
+#endif
+    }
+
+    uint32_t LowestBitIndex(uint32_t mask)
+    {
+        assert(mask != 0);
+        uint32_t index = 0;
+        while (!(mask & 1)) { mask >>= 1; ++index; }
+        return index;
+    }
+}
+
+namespace gol
+{
+    FlatCellMap::FlatCellMap(const FlatCellMap& other)
+        : m_capacity(other.m_capacity), m_size(other.m_size)
+    {
+        if (m_capacity)
+        {
+            m_control.reset(new int8_t[m_capacity + GroupWidth]);
+            m_slots.reset(new value_type[m_capacity]);
+            std::memcpy(
+                m_control.get(),
+                other.m_control.get(),
+                m_capacity + GroupWidth);
+            std::copy(
+                other.m_slots.get(),
+                other.m_slots.get() + m_capacity,
+                m_slots.get());
+        }
+    }
+
+    FlatCellMap::FlatCellMap(FlatCellMap&& other) noexcept
+        : m_control(std::move(other.m_control)),
+          m_slots(std::move(other.m_slots)),
+          m_capacity(other.m_capacity),
+          m_size(other.m_size)
+    {
+        other.m_capacity = 0;
+        other.m_size = 0;
+    }
+
+    FlatCellMap& FlatCellMap::operator=(FlatCellMap other) noexcept
+    {
+        std::swap(m_control, other.m_control);
+        std::swap(m_slots, other.m_slots);
+        std::swap(m_capacity, other.m_capacity);
+        std::swap(m_size, other.m_size);
+        return *this;
+    }
+
+    FlatCellMap::iterator FlatCellMap::find(const CellAddress& address)
+    {
+        const size_t Index = FindIndex(address, HashAddress(address));
+        if (Index == m_capacity) { return end(); }
+
+        return iterator(
+            m_control.get() + Index,
+            m_slots.get() + Index,
+            SlotsEnd());
+    }
+
+    FlatCellMap::const_iterator
+    FlatCellMap::find(const CellAddress& address) const
+    {
+        const size_t Index = FindIndex(address, HashAddress(address));
+        if (Index == m_capacity) { return end(); }
+
+        return const_iterator(
+            m_control.get() + Index,
+            m_slots.get() + Index,
+            SlotsEnd());
+    }
+
+    Cell& FlatCellMap::operator[](const CellAddress& address)
+    {
+        const uint64_t Hash = HashAddress(address);
+        const size_t ExistingIndex = FindIndex(address, Hash);
+        if (ExistingIndex != m_capacity)
+        {
+            return m_slots[ExistingIndex].second;
+        }
+
+        //
+        // Keep the load factor at or below 7/8; beyond that probe runs get
+        // long enough to cost more than the memory saved.
+        //
+        if ((m_size + 1) * 8 > m_capacity * 7)
+        {
+            Rehash(std::max(MinCapacity, m_capacity * 2));
+        }
+
+        const size_t Index = FindEmptyIndex(Hash);
+        SetControl(Index, ControlTag(Hash));
+        m_slots[Index] = value_type(address, Cell());
+        ++m_size;
+
+        return m_slots[Index].second;
+    }
+
+    void FlatCellMap::erase(iterator it)
+    {
+        assert(it != end());
+        size_t hole = static_cast<size_t>(it.m_pSlot - m_slots.get());
+        const size_t Mask = m_capacity - 1;
+
+        //
+        // Backward-shift deletion: walk the rest of the probe run and pull
+        // each entry into the hole unless doing so would move it in front of
+        // its home slot.
+        //
+        size_t current = hole;
+        for (;;)
+        {
+            current = (current + 1) & Mask;
+            if (m_control[current] == Empty) { break; }
+
+            const size_t Home =
+                HomeIndex(HashAddress(m_slots[current].first), m_capacity);
+            const bool HomeInRange = (hole <= current)
+                ? (hole < Home && Home <= current)
+                : (hole < Home || Home <= current);
+            if (HomeInRange) { continue; }
+
+            SetControl(hole, m_control[current]);
+            m_slots[hole] = m_slots[current];
+            hole = current;
+        }
+
+        SetControl(hole, Empty);
+        --m_size;
+    }
+
+    size_t FlatCellMap::erase(const CellAddress& address)
+    {
+        auto it = find(address);
+        if (it == end()) { return 0; }
+
+        erase(it);
+        return 1;
+    }
+
+    void FlatCellMap::reserve(size_t count)
+    {
+        size_t newCapacity = std::max(MinCapacity, m_capacity);
+        while (count * 8 > newCapacity * 7) { newCapacity *= 2; }
+
+        if (newCapacity != m_capacity) { Rehash(newCapacity); }
+    }
+
+    void FlatCellMap::shrink_to_fit()
+    {
+        size_t newCapacity = MinCapacity;
+        while (m_size * 8 > newCapacity * 7) { newCapacity *= 2; }
+
+        if (newCapacity < m_capacity) { Rehash(newCapacity); }
+    }
+
+    void FlatCellMap::clear() noexcept
+    {
+        if (m_capacity)
+        {
+            std::memset(m_control.get(), Empty, m_capacity + GroupWidth);
+        }
+        m_size = 0;
+    }
+
+    size_t FlatCellMap::FindIndex(const CellAddress& address, uint64_t hash) const
+    {
+        if (!m_capacity) { return m_capacity; }
+
+        const int8_t Tag = ControlTag(hash);
+        const size_t Mask = m_capacity - 1;
+        size_t groupStart = HomeIndex(hash, m_capacity);
+        for (;;)
+        {
+            const auto Masks = ProbeGroup(m_control.get() + groupStart, Tag);
+
+            //
+            // Entries never sit past the first empty slot of their probe run,
+            // so only matches in front of it are candidates.
+            //
+            const uint32_t CandidateLimit =
+                Masks.Empty ? (Masks.Empty & (0u - Masks.Empty)) - 1 : ~0u;
+            uint32_t candidates = Masks.Match & CandidateLimit;
+            while (candidates)
+            {
+                const size_t Index =
+                    (groupStart + LowestBitIndex(candidates)) & Mask;
+                if (m_slots[Index].first == address) { return Index; }
+
+                candidates &= candidates - 1;
+            }
+
+            if (Masks.Empty) { return m_capacity; }
+
+            groupStart = (groupStart + GroupWidth) & Mask;
+        }
+    }
+
+    size_t FlatCellMap::FindEmptyIndex(uint64_t hash) const
+    {
+        const size_t Mask = m_capacity - 1;
+        size_t groupStart = HomeIndex(hash, m_capacity);
+        for (;;)
+        {
+            const auto Masks = ProbeGroup(m_control.get() + groupStart, 0);
+            if (Masks.Empty)
+            {
+                return (groupStart + LowestBitIndex(Masks.Empty)) & Mask;
+            }
+
+            groupStart = (groupStart + GroupWidth) & Mask;
+        }
+    }
+
+    void FlatCellMap::SetControl(size_t index, int8_t value)
+    {
+        m_control[index] = value;
+        if (index < GroupWidth)
+        {
+            m_control[m_capacity + index] = value;
+        }
+    }
+
+    size_t FlatCellMap::memory_usage() const noexcept
+    {
+        if (!m_capacity) { return 0; }
+        return m_capacity * sizeof(value_type) + m_capacity + GroupWidth;
+    }
+
+    void FlatCellMap::Rehash(size_t newCapacity)
+    {
+        std::unique_ptr<int8_t[]> oldControl(std::move(m_control));
+        std::unique_ptr<value_type[]> oldSlots(std::move(m_slots));
+        const size_t OldCapacity = m_capacity;
+
+        m_control.reset(new int8_t[newCapacity + GroupWidth]);
+        m_slots.reset(new value_type[newCapacity]);
+        m_capacity = newCapacity;
+        std::memset(m_control.get(), Empty, m_capacity + GroupWidth);
+
+        for (size_t i = 0; i < OldCapacity; ++i)
+        {
+            if (oldControl[i] == Empty) { continue; }
+
+            const uint64_t Hash = HashAddress(oldSlots[i].first);
+            const size_t Index = FindEmptyIndex(Hash);
+            SetControl(Index, ControlTag(Hash));
+            m_slots[Index] = oldSlots[i];
+        }
+    }
+}
@@ -0,0 +1,192 @@
+//
+// Flat, open-addressing hash table from cell addresses to cells.
+//
+// Slots live in a single contiguous array alongside a parallel array of
+// control bytes. A control byte is either Empty or holds the low seven bits of
+// the slot's hash, so a probe can compare a whole group of candidates against
+// the query with one SIMD compare before touching any slot memory.
+//
+// Probing is linear, and removal shifts subsequent entries of the probe run
+// back into the vacated slot rather than leaving tombstones behind. Lookups
+// therefore never wade through deleted entries, no matter how many cells are
+// retired and re-inserted over the lifetime of the table.
+//
+
+#pragma once
+
+#include "Cell.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace gol
+{
+    class FlatCellMap
+    {
+    public:
+        using key_type    = CellAddress;
+        using mapped_type = Cell;
+
+        //
+        // The key is not const-qualified so that entries can be shifted
+        // between slots on removal. Don't modify it through an iterator.
+        //
+        using value_type  = std::pair<CellAddress, Cell>;
+
+        template<typename ValueType>
+        class IteratorBase
+        {
+        public:
+            IteratorBase() = default;
+            IteratorBase(const int8_t* pControl, ValueType* pSlot, ValueType* pEnd)
+                : m_pControl(pControl), m_pSlot(pSlot), m_pEnd(pEnd)
+            {
+                SkipEmpty();
+            }
+
+            //
+            // Allow iterator -> const_iterator conversions.
+            //
+            template<typename OtherValueType>
+            IteratorBase(const IteratorBase<OtherValueType>& other)
+                : m_pControl(other.m_pControl),
+                  m_pSlot(other.m_pSlot),
+                  m_pEnd(other.m_pEnd) {}
+
+            ValueType& operator*()  const { return *m_pSlot; }
+            ValueType* operator->() const { return m_pSlot;  }
+
+            IteratorBase& operator++()
+            {
+                ++m_pControl;
+                ++m_pSlot;
+                SkipEmpty();
+                return *this;
+            }
+
+            IteratorBase operator++(int)
+            {
+                IteratorBase copy(*this);
+                ++(*this);
+                return copy;
+            }
+
+            bool operator==(const IteratorBase& other) const
+            {
+                return m_pSlot == other.m_pSlot;
+            }
+            bool operator!=(const IteratorBase& other) const
+            {
+                return m_pSlot != other.m_pSlot;
+            }
+
+        private:
+            template<typename> friend class IteratorBase;
+            friend class FlatCellMap;
+
+            void SkipEmpty()
+            {
+                while (m_pSlot != m_pEnd && *m_pControl < 0)
+                {
+                    ++m_pControl;
+                    ++m_pSlot;
+                }
+            }
+
+            const int8_t* m_pControl = nullptr;
+            ValueType*    m_pSlot    = nullptr;
+            ValueType*    m_pEnd     = nullptr;
+        };
+
+        using iterator       = IteratorBase<value_type>;
+        using const_iterator = IteratorBase<const value_type>;
+
+        FlatCellMap() = default;
+        FlatCellMap(const FlatCellMap& other);
+        FlatCellMap(FlatCellMap&& other) noexcept;
+        FlatCellMap& operator=(FlatCellMap other) noexcept;
+        ~FlatCellMap() = default;
+
+        iterator       find(const CellAddress& address);
+        const_iterator find(const CellAddress& address) const;
+
+        //
+        // Inserts a default-constructed cell if none exists at the address.
+        // Insertion only moves existing entries when it triggers a rehash; see
+        // reserve().
+        //
+        Cell& operator[](const CellAddress& address);
+
+        //
+        // Removes the entry, shifting later entries in the same probe run back
+        // by one slot. Invalidates all iterators.
+        //
+        void erase(iterator it);
+        size_t erase(const CellAddress& address);
+
+        //
+        // Grows the table so that at least `count` entries fit without a
+        // rehash. Iterators stay valid across insertions while the size stays
+        // below the reserved count.
+        //
+        void reserve(size_t count);
+
+        //
+        // Shrinks the table to the smallest capacity which holds the current
+        // entries, handing the rest of its memory back.
+        //
+        void shrink_to_fit();
+
+        void clear() noexcept;
+
+        size_t size() const noexcept     { return m_size; }
+        size_t capacity() const noexcept { return m_capacity; }
+        bool   empty() const noexcept    { return m_size == 0; }
+
+        //
+        // Bytes held by the table's slots and control bytes.
+        //
+        size_t memory_usage() const noexcept;
+
+        iterator begin() noexcept
+        {
+            return iterator(m_control.get(), m_slots.get(), SlotsEnd());
+        }
+        iterator end() noexcept
+        {
+            return iterator(nullptr, SlotsEnd(), SlotsEnd());
+        }
+        const_iterator begin() const noexcept
+        {
+            return const_iterator(m_control.get(), m_slots.get(), SlotsEnd());
+        }
+        const_iterator end() const noexcept
+        {
+            return const_iterator(nullptr, SlotsEnd(), SlotsEnd());
+        }
+        const_iterator cbegin() const noexcept { return begin(); }
+        const_iterator cend()   const noexcept { return end();   }
+
+    private:
+        size_t FindIndex(const CellAddress& address, uint64_t hash) const;
+        size_t FindEmptyIndex(uint64_t hash) const;
+        void   SetControl(size_t index, int8_t value);
+        void   Rehash(size_t newCapacity);
+
+        value_type* SlotsEnd() const noexcept
+        {
+            return m_slots.get() + m_capacity;
+        }
+
+        //
+        // The trailing group of control bytes mirrors the leading group so a
+        // probe can load a full group at any slot index without wrapping.
+        //
+        std::unique_ptr<int8_t[]>     m_control;
+        std::unique_ptr<value_type[]> m_slots;
+        size_t                        m_capacity = 0;
+        size_t                        m_size     = 0;
+    };
+}
@@ -1,7 +1,15 @@
 #include "GOLGrid.h"
+#include "SpillStore.h"
+#include "ThreadPool.h"
 
 #include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <filesystem>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <utility>
 
 namespace
 {
@@ -33,227 +41,1545 @@ namespace
         {-1,  1},
         {-1,  0}
     };
+
+    //
+    // Storage iteration order depends on the backend; keep the copies handed
+    // out in address order so output is stable regardless.
+    //
+    void SortByAddress(std::vector<gol::Cell>& cells)
+    {
+        std::sort(
+            std::begin(cells),
+            std::end(cells),
+            [](const gol::Cell& a, const gol::Cell& b)
+            {
+                return a.Address < b.Address;
+            });
+    }
+
+    //
+    // Storage is split into shards by 64x64 spatial block, so most of a
+    // cell's neighbors live in the same shard as the cell itself. With more
+    // than one thread there are several shards per thread, which gives work
+    // stealing something to balance.
+    //
+    constexpr int64_t ShardBlockShift{6};
+    constexpr size_t  ShardsPerThread{4};
+
+    //
+    // Freezing works on 16x16 regions, which tile the shard blocks exactly.
+    // A region is frozen once its changes have repeated with period 2 for a
+    // few generations, staying at least two cells clear of its border so
+    // that neither the changes nor their neighbor count updates leave it.
+    //
+    constexpr int64_t  RegionShift{4};
+    constexpr int64_t  RegionSize{int64_t(1) << RegionShift};
+    constexpr int64_t  RegionMargin{2};
+    constexpr uint32_t FreezeAfterRepeats{4};
+
+    static_assert(RegionShift <= ShardBlockShift);
+    static_assert(RegionShift == gol::TileIndex::TileShift);
+
+    gol::CellAddress RegionOf(const gol::CellAddress& address)
+    {
+        return gol::CellAddress(
+            address.first >> RegionShift,
+            address.second >> RegionShift);
+    }
+
+    bool OnRegionBorder(const gol::CellAddress& address)
+    {
+        const int64_t LocalX{address.first & (RegionSize - 1)};
+        const int64_t LocalY{address.second & (RegionSize - 1)};
+        return LocalX == 0 || LocalX == RegionSize - 1 ||
+               LocalY == 0 || LocalY == RegionSize - 1;
+    }
+
+    bool InRegionInterior(const gol::CellAddress& address)
+    {
+        const int64_t LocalX{address.first & (RegionSize - 1)};
+        const int64_t LocalY{address.second & (RegionSize - 1)};
+        return LocalX >= RegionMargin && LocalX < RegionSize - RegionMargin &&
+               LocalY >= RegionMargin && LocalY < RegionSize - RegionMargin;
+    }
+
+    //
+    // A spilled region takes one byte per cell, in row order: 0 where storage
+    // holds no cell, otherwise a flag, the neighbor count and the state.
+    //
+    constexpr uint8_t SpilledCellStored{0x80};
+    static_assert(gol::SpillStore::SlotSize == RegionSize * RegionSize);
+
+    gol::CellAddress RegionCellAddress(const gol::CellAddress& region, size_t index)
+    {
+        return gol::CellAddress(
+            (region.first << RegionShift) + static_cast<int64_t>(index % RegionSize),
+            (region.second << RegionShift) + static_cast<int64_t>(index / RegionSize));
+    }
+
+    bool SameChanges(
+        const std::vector<gol::Cell>& a,
+        std::vector<gol::Cell>::const_iterator first,
+        std::vector<gol::Cell>::const_iterator last)
+    {
+        return std::equal(
+            std::begin(a),
+            std::end(a),
+            first,
+            last,
+            [](const gol::Cell& x, const gol::Cell& y)
+            {
+                return x.Address == y.Address && x.Alive == y.Alive;
+            });
+    }
+
+    //
+    // Next-state lookups for the classify pass. Both index a bitmask by
+    // Cell::LookupKey(); the fixed one has its mask folded into the code.
+    //
+    template<uint32_t Mask>
+    struct FixedTransitions
+    {
+        bool operator()(uint8_t lookupKey) const
+        {
+            return (Mask >> lookupKey) & 1;
+        }
+    };
+
+    struct RuntimeTransitions
+    {
+        uint32_t Mask;
+
+        bool operator()(uint8_t lookupKey) const
+        {
+            return (Mask >> lookupKey) & 1;
+        }
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+    uint64_t NanosecondsBetween(Clock::time_point start, Clock::time_point end)
+    {
+        return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end - start)
+                .count());
+    }
+
+    size_t ShardCountFor(size_t numThreads)
+    {
+        if (numThreads <= 1) { return 1; }
+
+        size_t numShards{1};
+        while (numShards < numThreads * ShardsPerThread) { numShards <<= 1; }
+        return numShards;
+    }
 }
 
 namespace gol
 {
-    GOLGrid::GOLGrid(const std::vector<CellAddress>& cellAddresses)
+    GOLGrid::GOLGrid(size_t numThreads)
+        : m_shards(ShardCountFor(numThreads)),
+          m_frontiers(m_shards.size()),
+          m_tileIndexes(m_shards.size()),
+          m_changes(m_shards.size()),
+          m_outboxes(
+              m_shards.size(),
+              std::vector<std::vector<Cell>>(m_shards.size())),
+          m_retiredCells(m_shards.size()),
+          m_evaluating(m_shards.size()),
+          m_regionChanges(m_shards.size()),
+          m_shardStats(m_shards.size()),
+          m_summaries(m_shards.size()),
+          m_regionActivity(m_shards.size()),
+          m_frozenRegions(m_shards.size()),
+          m_regionsToThaw(m_shards.size()),
+          m_frozenToggleSummaries(m_shards.size()),
+          m_spillStores(m_shards.size()),
+          m_spilledRegions(m_shards.size()),
+          m_spillPending(m_shards.size()),
+          m_spillFailures(m_shards.size())
     {
-        //
-        // Insert live cells
-        //
-        for (const auto& Address : cellAddresses)
+        if (m_shards.size() > 1)
         {
-            const bool AliveCell{true};
-            m_storage.Insert(Address, AliveCell, 0);
+            m_pool = std::make_unique<ThreadPool>(numThreads);
         }
+    }
 
+    GOLGrid::~GOLGrid() = default;
+
+    void GOLGrid::Clear()
+    {
+        ClearCells();
+        m_generation = 0;
+        m_cycle = Cycle();
+        m_lastStepStats = StepStats();
+        m_cycleSearchPending = m_detectCycles;
+    }
+
+    void GOLGrid::AdvanceGeneration()
+    {
+        //
+        // To update storage in-place, conduct the update in two passes:
+        // 1) Note state transitions for each cell (alive<->dead). A cell's own
+        //    transition only depends on its own state, so the alive state is
+        //    flipped right away rather than looked up again later.
+        // 2) Update the neighbor count of transitioning cells' neighbors.
         //
-        // Generate adjacent dead cells and properly set neighbor counts.
+        // Both passes run shard by shard, in parallel when there is a pool.
+        // In the first pass each shard only writes to itself, and posts its
+        // changed cells to the outbox of every shard holding one of their
+        // neighbors. In the second pass each shard drains the outboxes
+        // addressed to it, again only writing to itself, so no locks are
+        // needed. Outboxes are drained in source shard order, which keeps
+        // the result independent of scheduling.
         //
-        std::vector<Cell> deadCells;
-        for (auto [liveAddress, IGNORE] : m_storage)
+        // Only cells on the active frontier are visited: those whose own state
+        // or neighbor count changed during the previous generation. Every
+        // other cell would come to the same conclusion as last time, so stable
+        // regions cost nothing no matter how large they are.
+        //
+        // Along the way, retire cells with no neighbors. Retirement happens
+        // last so that a cell which picks up a neighbor during this very
+        // generation isn't removed only to be re-inserted.
+        //
+        // With region freezing on, regions reached by outside changes are
+        // thawed before retirement, and regions which have settled into
+        // period 2 are frozen after it. With a memory budget, cold regions are
+        // spilled last of all.
+        //
+        if (m_cycleSearchPending)
         {
-            //
-            // Check for neighbors. Where there isn't one, create a new,
-            // dead cell. Where there are neighbors, increment neighor count.
-            //
-            for (const auto& Offset : NeighborOffsets)
+            m_cycleSearchPending = false;
+            RestartCycleSearch();
+        }
+
+        const uint64_t NextGeneration{m_generation + 1};
+        const bool CollectStats{m_collectStats};
+
+        ClassifyShards(CollectStats);
+
+        ForEachShard([&](size_t shardIndex)
+        {
+            const auto PropagateStart = CollectStats ? Clock::now() : Clock::time_point();
+            auto& storage = m_shards[shardIndex];
+            DrainOutboxes(m_outboxes, shardIndex);
+            if (m_freezeRegions) { ThawRegions(shardIndex, NextGeneration); }
+
+            const auto RetireStart = CollectStats ? Clock::now() : Clock::time_point();
+            uint64_t numRetired{0};
+            for (const auto& RetiredAddress : m_retiredCells[shardIndex])
             {
-                const auto NeighborAddress = liveAddress + Offset;
-                auto neighborCellIt = m_storage.Find(NeighborAddress);
-                if (neighborCellIt != m_storage.end())
+                auto retiredIt = storage.Find(RetiredAddress);
+                if (retiredIt != storage.end() &&
+                    !retiredIt->second.Alive &&
+                    retiredIt->second.NeighborCount == 0)
                 {
-                    neighborCellIt->second.NeighborCount++;
+                    storage.Remove(retiredIt);
+                    ++numRetired;
                 }
-                else
+            }
+
+            const auto FreezeStart = CollectStats ? Clock::now() : Clock::time_point();
+            if (TracksRegions())
+            {
+                TrackRegionActivity(shardIndex, NextGeneration);
+            }
+
+            if (m_memoryBudget)
+            {
+                try
+                {
+                    SpillColdRegions(shardIndex);
+                }
+                catch (...)
                 {
                     //
-                    // See if the dead cell exists in the dead cells list.
+                    // Exceptions can't be allowed to escape into the pool's
+                    // worker threads.
                     //
-                    auto it = 
-                        std::find_if(
-                            std::begin(deadCells),
-                            std::end(deadCells),
-                            [&NeighborAddress](const Cell& cell)
-                            {
-                                return NeighborAddress == cell.Address;
-                            });
-                    if (it != std::end(deadCells))
-                    {
-                        it->NeighborCount++;
-                    }
-                    else
-                    {
-                        //
-                        // Don't mess with the container while iterating through
-                        // it. Defer adding dead cells to storage.
-                        //
-                        const bool DeadCell{false};
-                        deadCells.emplace_back(NeighborAddress, DeadCell, 1);
-                    }
+                    m_spillFailures[shardIndex] = std::current_exception();
                 }
             }
+
+            if (CollectStats)
+            {
+                auto& stats = m_shardStats[shardIndex];
+                stats.PropagateNanoseconds = NanosecondsBetween(PropagateStart, RetireStart);
+                stats.RetireNanoseconds = NanosecondsBetween(RetireStart, FreezeStart);
+                stats.FreezeNanoseconds = NanosecondsBetween(FreezeStart, Clock::now());
+                stats.RetiredCells = numRetired;
+            }
+        });
+
+        for (auto& failure : m_spillFailures)
+        {
+            if (failure) { std::rethrow_exception(std::exchange(failure, nullptr)); }
         }
 
-        for (const auto& DeadCell : deadCells)
+        if (CollectStats)
         {
-            m_storage.Insert(DeadCell);
+            m_lastStepStats = StepStats();
+            for (const auto& Stats : m_shardStats)
+            {
+                m_lastStepStats.ClassifyNanoseconds += Stats.ClassifyNanoseconds;
+                m_lastStepStats.PropagateNanoseconds += Stats.PropagateNanoseconds;
+                m_lastStepStats.RetireNanoseconds += Stats.RetireNanoseconds;
+                m_lastStepStats.FreezeNanoseconds += Stats.FreezeNanoseconds;
+                m_lastStepStats.ChangedCells += Stats.ChangedCells;
+                m_lastStepStats.RetiredCells += Stats.RetiredCells;
+            }
         }
+
+        ++m_generation;
+        if (m_detectCycles && !m_cycle.Period) { ContinueCycleSearch(); }
     }
 
-    void GOLGrid::AdvanceGeneration()
+    void GOLGrid::ClassifyShards(bool collectStats)
     {
+        auto Classify = [&](const auto& Transitions)
+        {
+            ForEachShard([&](size_t shardIndex)
+            {
+                ClassifyShard(shardIndex, Transitions, collectStats);
+            });
+        };
+
         //
-        // A look-up table which encodes life-to-death states based on the 
-        // bit field contained in the state variables in a given cell.
-        //
-        // High order bit represents current alive state and the remaining
-        // bits are the neighbor count.
+        // Common rules get a kernel with their transitions built in.
         //
-        static const std::vector<bool> AliveOrDeadLUT = 
+        switch (m_rule.Transitions())
         {
-            //
-            // Dead cells
-            //
-            false, // 0b00000
-            false, // 0b00001
-            false, // 0b00010
-            true , // 0b00011
-            false, // 0b00100
-            false, // 0b00101
-            false, // 0b00110
-            false, // 0b00111
-            false, // 0b01000
-
-            //
-            // This chunk represents invalid states, since any given cell may
-            // only have up to eight neighbors.
-            //
-            false, // 0b01001
-            false, // 0b01010
-            false, // 0b01011
-            false, // 0b01100
-            false, // 0b01101
-            false, // 0b01110
-            false, // 0b01111
+        case ConwayRule.Transitions():
+            Classify(FixedTransitions<ConwayRule.Transitions()>());
+            break;
+        case HighLifeRule.Transitions():
+            Classify(FixedTransitions<HighLifeRule.Transitions()>());
+            break;
+        case SeedsRule.Transitions():
+            Classify(FixedTransitions<SeedsRule.Transitions()>());
+            break;
+        case DayAndNightRule.Transitions():
+            Classify(FixedTransitions<DayAndNightRule.Transitions()>());
+            break;
+        default:
+            Classify(RuntimeTransitions{m_rule.Transitions()});
+            break;
+        }
+    }
 
-            //
-            // Live cells
-            //
-            false, // 0b10000
-            false, // 0b10001
-            true , // 0b10010
-            true , // 0b10011
-            false, // 0b10100
-            false, // 0b10101
-            false, // 0b10110
-            false, // 0b10111
-            false, // 0b11000
-        };
+    template<typename Transitions>
+    void GOLGrid::ClassifyShard(
+        size_t shardIndex,
+        const Transitions& transitions,
+        bool collectStats)
+    {
+        const auto ClassifyStart = collectStats ? Clock::now() : Clock::time_point();
+        auto& storage = m_shards[shardIndex];
+        auto& outbox = m_outboxes[shardIndex];
+        auto& changes = m_changes[shardIndex];
+        auto& summary = m_summaries[shardIndex];
+        auto& tileIndex = m_tileIndexes[shardIndex];
+        changes.clear();
+        m_retiredCells[shardIndex].clear();
+        for (auto& destination : outbox) { destination.clear(); }
 
         //
-        // To update storage in-place, conduct the update in two passes:
-        // 1) Note state transitions for each cell (alive<->dead)
-        // 2) Update transitioning cells' living state and the neighbor count
-        //    of their neighbors.
-        //
-        // Along the way, retire cells with no neighbors.
+        // Cells queued from here on go to the empty buffer left behind by
+        // the swap, which still has last generation's capacity.
         //
-        std::vector<Cell> changedCells;
-        std::vector<Cell> retiredCells;
-        for (auto& [IGNORE, cell] : m_storage)
+        auto& frontier = m_evaluating[shardIndex];
+        frontier.swap(m_frontiers[shardIndex]);
+        for (const auto& Address : frontier)
         {
-            const bool NewState{ AliveOrDeadLUT[cell.LookupKey()] };
+            //
+            // Skip addresses which were retired since being queued, or
+            // queued twice.
+            //
+            auto cellIt = storage.Find(Address);
+            if (cellIt == storage.end() || !cellIt->second.Dirty)
+            {
+                continue;
+            }
+
+            auto& cell = cellIt->second;
+            cell.Dirty = false;
+
+            const bool NewState{ transitions(cell.LookupKey()) };
             const bool Transitioned{ cell.Alive != NewState };
             if (Transitioned) 
             { 
-                changedCells.push_back(cell); 
+                cell.Alive = NewState;
+                PostChange(cell, outbox);
+                changes.push_back(cell);
+                tileIndex.SetAlive(cell.Address, NewState);
+
+                if (m_detectCycles)
+                {
+                    if (NewState) { summary.Add(cell.Address); }
+                    else          { summary.Remove(cell.Address); }
+                }
             }
             else if (!cell.Alive && cell.NeighborCount == 0)
             {
-                retiredCells.push_back(cell);
+                m_retiredCells[shardIndex].push_back(cell.Address);
             }
         }
+        frontier.clear();
 
-        for (auto& retiredCell : retiredCells)
+        if (collectStats)
         {
-            m_storage.Remove(retiredCell);
+            auto& stats = m_shardStats[shardIndex];
+            stats.ClassifyNanoseconds = NanosecondsBetween(ClassifyStart, Clock::now());
+            stats.ChangedCells = changes.size();
         }
-        
-        for (auto& changedCell : changedCells)
+    }
+
+    void GOLGrid::AdvanceGenerations(uint64_t numGenerations)
+    {
+        for (; numGenerations && !m_cycle.Period; --numGenerations)
         {
-            changedCell.Alive = !changedCell.Alive;
+            AdvanceGeneration();
+        }
 
-            // 
-            // Update the alive state here, neighbor count below.
-            //
-            auto changedCellIt = m_storage.Find(changedCell.Address);
-            changedCellIt->second.Alive = changedCell.Alive;
+        if (!numGenerations) { return; }
 
-            if (!changedCell.Alive)
+        //
+        // The board is in a known cycle, so whole periods only move it.
+        //
+        const uint64_t NumPeriods{numGenerations / m_cycle.Period};
+        const CellAddress& Offset = m_cycle.Offset;
+        if (NumPeriods && Offset != CellAddress(0, 0))
+        {
+            const uint64_t MaxSteps{
+                static_cast<uint64_t>(std::numeric_limits<int64_t>::max())};
+            auto Magnitude = [](int64_t value)
             {
-                //
-                // Decrement neighbor cell NeighborCounts
-                //
-                for (const auto& Offset : NeighborOffsets)
-                {
-                    const auto NeighborAddress = changedCell.Address + Offset;
-                    auto neighborIt = m_storage.Find(NeighborAddress);
+                const uint64_t Bits{static_cast<uint64_t>(value)};
+                return value < 0 ? 0 - Bits : Bits;
+            };
+            const uint64_t StepX{Magnitude(Offset.first)};
+            const uint64_t StepY{Magnitude(Offset.second)};
+            if ((StepX && NumPeriods > MaxSteps / StepX) ||
+                (StepY && NumPeriods > MaxSteps / StepY))
+            {
+                throw std::overflow_error(
+                    "Pattern moves beyond the addressable plane.");
+            }
 
-                    //
-                    // A formerly living cell should have eight neighboring
-                    // cells in storage (not necessarily alive).
-                    //
-                    assert(neighborIt != m_storage.end());
-                    assert(neighborIt->second.NeighborCount > 0);
-                    neighborIt->second.NeighborCount--;
-                }
+            const int64_t Periods{static_cast<int64_t>(NumPeriods)};
+            Translate(CellAddress(
+                Offset.first * Periods,
+                Offset.second * Periods));
+        }
+
+        m_generation += NumPeriods * m_cycle.Period;
+        for (uint64_t i = 0; i < numGenerations % m_cycle.Period; ++i)
+        {
+            AdvanceGeneration();
+        }
+    }
+
+    void GOLGrid::SetCycleDetection(bool enabled)
+    {
+        m_detectCycles = enabled;
+        m_cycle = Cycle();
+        m_cycleSearchPending = false;
+        m_savedCells.clear();
+        if (!m_detectCycles) { return; }
+
+        //
+        // Summaries aren't kept up to date while detection is off, so start
+        // from scratch.
+        //
+        ForEachShard([&](size_t shardIndex)
+        {
+            auto& summary = m_summaries[shardIndex];
+            summary = LiveSetSummary();
+            for (const auto& [Address, Cell] : m_shards[shardIndex])
+            {
+                if (Cell.Alive) { summary.Add(Address); }
             }
-            else if(changedCell.Alive)
+
+            //
+            // Like storage, the index holds spilled regions as they were
+            // frozen, if they were.
+            //
+            const auto& Index = m_tileIndexes[shardIndex];
+            for (const auto& [Region, IGNORE] : m_spilledRegions[shardIndex])
             {
-                //
-                // Increment neighbor cell NeighborCounts
-                //
-                for (const auto& Offset : NeighborOffsets)
+                const auto* pTile = Index.FindTile(Region);
+                if (!pTile) { continue; }
+
+                for (size_t i = 0; i < SpillStore::SlotSize; ++i)
                 {
-                    const auto NeighborAddress = changedCell.Address + Offset;
-                    auto neighborIt = m_storage.Find(NeighborAddress);
-                    if (neighborIt == m_storage.end())
-                    {
-                        //
-                        // Live cells must be surrounded.
-                        //
-                        const bool DeadCell{false};
-                        m_storage.Insert(NeighborAddress, DeadCell, 1);
-                    }
-                    else
+                    if (((*pTile)[i / RegionSize] >> (i % RegionSize)) & 1)
                     {
-                        assert(neighborIt->second.NeighborCount < 9);
-                        neighborIt->second.NeighborCount++;
+                        summary.Add(RegionCellAddress(Region, i));
                     }
                 }
-            } 
-        }
+            }
+        });
+
+        RestartCycleSearch();
     }
 
     std::vector<Cell> GOLGrid::GetLiveCells() const
     {
+        if (GetFrozenRegionCount() || GetSpilledRegionCount())
+        {
+            auto cells = GetAllCells();
+            cells.erase(
+                std::remove_if(
+                    std::begin(cells),
+                    std::end(cells),
+                    [](const Cell& cell) { return !cell.Alive; }),
+                std::end(cells));
+            return cells;
+        }
+
         std::vector<Cell> liveCells;
-        for (const auto& [IGNORE, Cell] : m_storage)
+        for (const auto& Shard : m_shards)
         {
-            if (Cell.Alive) { liveCells.push_back(Cell); }
+            for (const auto& [IGNORE, Cell] : Shard)
+            {
+                if (Cell.Alive) { liveCells.push_back(Cell); }
+            }
         }
 
+        SortByAddress(liveCells);
         return liveCells;
     }
 
     std::vector<Cell> GOLGrid::GetAllCells() const
     {
         std::vector<Cell> cells;
-        for (const auto& [IGNORE, Cell] : m_storage) { cells.push_back(Cell); }
+        for (const auto& Shard : m_shards)
+        {
+            for (const auto& [IGNORE, Cell] : Shard) { cells.push_back(Cell); }
+        }
 
+        AppendSpilledCells(cells);
+        SortByAddress(cells);
+        ApplyFrozenPhases(cells);
         return cells;
     }
-}
 
+    void GOLGrid::SetRoutedCells(const RoutedAddresses& routedAddresses, bool alive)
+    {
+        //
+        // Any cycle found so far no longer applies, and the cells may lie in
+        // frozen or spilled regions.
+        //
+        m_cycle = Cycle();
+        ThawAllRegions();
+        RestoreAllRegions();
+
+        //
+        // Bringing a cell to life here is no different from a birth during
+        // AdvanceGeneration: flip it, then let the usual propagation build
+        // its dead neighbors and neighbor counts. Killing one is a death, and
+        // the cells left without neighbors are retired next generation. Every
+        // lookup is a hash probe, so the whole load is linear in the number
+        // of cells.
+        //
+        ForEachShard([&](size_t shardIndex)
+        {
+            auto& storage = m_shards[shardIndex];
+            auto& outbox = m_outboxes[shardIndex];
+            for (auto& destination : outbox) { destination.clear(); }
+            auto& summary = m_summaries[shardIndex];
+            auto& tileIndex = m_tileIndexes[shardIndex];
+
+            if (alive)
+            {
+                size_t numIncoming{0};
+                for (const auto& Buckets : routedAddresses)
+                {
+                    numIncoming += Buckets[shardIndex].size();
+                }
+                storage.Reserve(storage.Size() + numIncoming);
+            }
+
+            for (const auto& Buckets : routedAddresses)
+            {
+                for (const auto& Address : Buckets[shardIndex])
+                {
+                    auto cellIt = storage.Find(Address);
+                    if (cellIt == storage.end())
+                    {
+                        if (!alive) { continue; }
+
+                        const Cell NewCell(Address, alive, 0);
+                        storage.Insert(NewCell);
+                        PostChange(NewCell, outbox);
+                    }
+                    else if (cellIt->second.Alive != alive)
+                    {
+                        cellIt->second.Alive = alive;
+                        PostChange(cellIt->second, outbox);
+                    }
+                    else
+                    {
+                        continue;
+                    }
+
+                    tileIndex.SetAlive(Address, alive);
+                    if (m_detectCycles)
+                    {
+                        if (alive) { summary.Add(Address); }
+                        else       { summary.Remove(Address); }
+                    }
+                }
+            }
+        });
+
+        ForEachShard([&](size_t shardIndex)
+        {
+            DrainOutboxes(m_outboxes, shardIndex);
+        });
+
+        //
+        // Inserting in chunks calls here once per chunk, so the search only
+        // starts over at the next step, from the board as it then stands.
+        //
+        m_cycleSearchPending = m_detectCycles;
+    }
+
+    size_t GOLGrid::NumRoutingChunks() const
+    {
+        return m_pool ? m_pool->Size() * ShardsPerThread : 1;
+    }
+
+    size_t GOLGrid::ShardOf(const CellAddress& address) const
+    {
+        if (m_shards.size() == 1) { return 0; }
+
+        return ShardOfBlock(
+            address.first >> ShardBlockShift,
+            address.second >> ShardBlockShift);
+    }
+
+    size_t GOLGrid::ShardOfBlock(int64_t blockX, int64_t blockY) const
+    {
+        return static_cast<size_t>(HashCoordinates(blockX, blockY)) & (m_shards.size() - 1);
+    }
+
+    void GOLGrid::ParallelFor(
+        size_t numTasks,
+        const std::function<void(size_t)>& task)
+    {
+        if (m_pool)
+        {
+            m_pool->ParallelFor(numTasks, task);
+        }
+        else
+        {
+            for (size_t i = 0; i < numTasks; ++i) { task(i); }
+        }
+    }
+
+    void GOLGrid::PostChange(
+        const Cell& changedCell,
+        std::vector<std::vector<Cell>>& outbox) const
+    {
+        if (m_shards.size() == 1)
+        {
+            outbox[0].push_back(changedCell);
+            return;
+        }
+
+        //
+        // The 3x3 neighborhood spans at most two blocks in each direction.
+        //
+        const auto& Address = changedCell.Address;
+        const int64_t BlockX[2] = {
+            (Address.first - 1) >> ShardBlockShift,
+            (Address.first + 1) >> ShardBlockShift };
+        const int64_t BlockY[2] = {
+            (Address.second - 1) >> ShardBlockShift,
+            (Address.second + 1) >> ShardBlockShift };
+
+        size_t destinations[4];
+        size_t numDestinations{0};
+        for (size_t i = 0; i < (BlockX[0] == BlockX[1] ? 1u : 2u); ++i)
+        {
+            for (size_t j = 0; j < (BlockY[0] == BlockY[1] ? 1u : 2u); ++j)
+            {
+                const size_t Destination{ShardOfBlock(BlockX[i], BlockY[j])};
+                if (std::find(
+                        destinations,
+                        destinations + numDestinations,
+                        Destination) == destinations + numDestinations)
+                {
+                    destinations[numDestinations++] = Destination;
+                }
+            }
+        }
+
+        for (size_t i = 0; i < numDestinations; ++i)
+        {
+            outbox[destinations[i]].push_back(changedCell);
+        }
+    }
+
+    void GOLGrid::PropagateChange(const Cell& changedCell, size_t shardIndex)
+    {
+        auto& storage = m_shards[shardIndex];
+        const bool Sharded{m_shards.size() > 1};
+
+        //
+        // Changes on a region's border reach into the regions next door.
+        //
+        const bool MayTouchRegions{
+            TracksRegions() && OnRegionBorder(changedCell.Address)};
+        const RegionKey ChangedRegion{RegionOf(changedCell.Address)};
+
+        //
+        // The changed cell has to be looked at again next generation.
+        //
+        if (!Sharded || ShardOf(changedCell.Address) == shardIndex)
+        {
+            auto changedIt = storage.Find(changedCell.Address);
+            assert(changedIt != storage.end());
+            MarkDirty(shardIndex, changedIt->second);
+        }
+
+        for (const auto& Offset : NeighborOffsets)
+        {
+            const auto NeighborAddress = changedCell.Address + Offset;
+            if (Sharded && ShardOf(NeighborAddress) != shardIndex) { continue; }
+
+            if (MayTouchRegions)
+            {
+                const RegionKey NeighborRegion{RegionOf(NeighborAddress)};
+                if (NeighborRegion != ChangedRegion)
+                {
+                    NoteTouch(shardIndex, NeighborRegion);
+                }
+            }
+
+            auto neighborIt = storage.Find(NeighborAddress);
+            if (!changedCell.Alive)
+            {
+                //
+                // A formerly living cell should have eight neighboring cells
+                // in storage (not necessarily alive).
+                //
+                assert(neighborIt != storage.end());
+                assert(neighborIt->second.NeighborCount > 0);
+                neighborIt->second.NeighborCount--;
+                MarkDirty(shardIndex, neighborIt->second);
+            }
+            else if (neighborIt == storage.end())
+            {
+                //
+                // Live cells must be surrounded.
+                //
+                const bool DeadCell{false};
+                Cell newCell(NeighborAddress, DeadCell, 1);
+                MarkDirty(shardIndex, newCell);
+                storage.Insert(newCell);
+            }
+            else
+            {
+                assert(neighborIt->second.NeighborCount < 9);
+                neighborIt->second.NeighborCount++;
+                MarkDirty(shardIndex, neighborIt->second);
+            }
+        }
+    }
+
+    void GOLGrid::DrainOutboxes(const Outboxes& outboxes, size_t shardIndex)
+    {
+        //
+        // Each birth inserts at most eight dead neighbors. Growing up front
+        // means storage is rehashed at most once per drain.
+        //
+        size_t numBirths{0};
+        for (const auto& SourceOutboxes : outboxes)
+        {
+            for (const auto& ChangedCell : SourceOutboxes[shardIndex])
+            {
+                numBirths += ChangedCell.Alive;
+            }
+        }
+
+        auto& storage = m_shards[shardIndex];
+        storage.Reserve(storage.Size() + numBirths * NeighborOffsets.size());
+
+        for (const auto& SourceOutboxes : outboxes)
+        {
+            for (const auto& ChangedCell : SourceOutboxes[shardIndex])
+            {
+                PropagateChange(ChangedCell, shardIndex);
+            }
+        }
+    }
+
+    void GOLGrid::MarkDirty(size_t shardIndex, Cell& cell)
+    {
+        if (cell.Dirty) { return; }
+
+        cell.Dirty = true;
+        m_frontiers[shardIndex].push_back(cell.Address);
+    }
+
+    void GOLGrid::RestartCycleSearch()
+    {
+        m_savedSummary = SummarizeLiveSet();
+
+        m_savedCells = GetSortedLiveAddresses();
+        m_savedGeneration = m_generation;
+        m_searchInterval = 1;
+    }
+
+    void GOLGrid::ContinueCycleSearch()
+    {
+        const LiveSetSummary Current{SummarizeLiveSet()};
+
+        //
+        // The hash only says the two live sets are almost certainly the same,
+        // so confirm against the saved cells before trusting it.
+        //
+        CellAddress offset;
+        if (MatchesTranslated(m_savedSummary, Current, offset) &&
+            MatchesSavedCells(offset))
+        {
+            m_cycle.Period = m_generation - m_savedGeneration;
+            m_cycle.Offset = offset;
+            m_savedCells.clear();
+            return;
+        }
+
+        if (m_generation - m_savedGeneration == m_searchInterval)
+        {
+            m_savedSummary = Current;
+            m_savedCells = GetSortedLiveAddresses();
+            m_savedGeneration = m_generation;
+            m_searchInterval *= 2;
+        }
+    }
+
+    bool GOLGrid::MatchesSavedCells(const CellAddress& offset) const
+    {
+        const auto Current = GetSortedLiveAddresses();
+        if (Current.size() != m_savedCells.size()) { return false; }
+
+        //
+        // Shifting preserves address order.
+        //
+        for (size_t i = 0; i < Current.size(); ++i)
+        {
+            if (Current[i] != m_savedCells[i] + offset) { return false; }
+        }
+
+        return true;
+    }
+
+    std::vector<CellAddress> GOLGrid::GetSortedLiveAddresses() const
+    {
+        std::vector<CellAddress> addresses;
+        ForEachLiveCell([&addresses](const CellAddress& address)
+        {
+            addresses.push_back(address);
+        });
+
+        std::sort(std::begin(addresses), std::end(addresses));
+        return addresses;
+    }
+
+    void GOLGrid::Translate(const CellAddress& offset)
+    {
+        const int64_t Max{std::numeric_limits<int64_t>::max()};
+        const int64_t Min{std::numeric_limits<int64_t>::min()};
+        auto Overflows = [Max, Min](int64_t value, int64_t shift)
+        {
+            return shift > 0 ? value > Max - shift : value < Min - shift;
+        };
+
+        auto addresses = GetSortedLiveAddresses();
+        for (auto& address : addresses)
+        {
+            if (Overflows(address.first, offset.first) ||
+                Overflows(address.second, offset.second))
+            {
+                throw std::overflow_error(
+                    "Pattern moves beyond the addressable plane.");
+            }
+
+            address = address + offset;
+        }
+
+        ClearCells();
+
+        //
+        // Rebuilding forgets the cycle, but the shifted board is still in it.
+        //
+        const Cycle KnownCycle{m_cycle};
+        InsertLiveCells(std::begin(addresses), std::end(addresses));
+        m_cycle = KnownCycle;
+        m_cycleSearchPending = false;
+        m_savedCells.clear();
+    }
+
+    void GOLGrid::ClearCells()
+    {
+        for (size_t shardIndex = 0; shardIndex < m_shards.size(); ++shardIndex)
+        {
+            m_shards[shardIndex].Clear();
+            m_tileIndexes[shardIndex].Clear();
+            m_frontiers[shardIndex].clear();
+            m_changes[shardIndex].clear();
+            m_summaries[shardIndex] = LiveSetSummary();
+            m_regionActivity[shardIndex].clear();
+            m_frozenRegions[shardIndex].clear();
+            m_regionsToThaw[shardIndex].clear();
+            m_frozenToggleSummaries[shardIndex] = {};
+            m_spilledRegions[shardIndex].clear();
+            m_spillPending[shardIndex] = true;
+            if (m_spillStores[shardIndex]) { m_spillStores[shardIndex]->Clear(); }
+        }
+    }
+
+    LiveSetSummary GOLGrid::SummarizeLiveSet() const
+    {
+        //
+        // Frozen regions an odd number of generations past their freeze are
+        // out of phase with storage by their toggles.
+        //
+        const size_t OutOfPhaseParity{(m_generation + 1) & 1};
+
+        LiveSetSummary summary;
+        for (size_t shardIndex = 0; shardIndex < m_shards.size(); ++shardIndex)
+        {
+            summary.Merge(m_summaries[shardIndex]);
+            summary.Merge(m_frozenToggleSummaries[shardIndex][OutOfPhaseParity]);
+        }
+
+        return summary;
+    }
+
+    void GOLGrid::SetRule(const Rule& rule)
+    {
+        if (rule.Birth & 1)
+        {
+            throw std::invalid_argument("Rules with B0 aren't supported.");
+        }
+
+        m_rule = rule;
+    }
+
+    void GOLGrid::SetRegionFreezing(bool enabled)
+    {
+        if (!enabled) { ThawAllRegions(); }
+
+        m_freezeRegions = enabled;
+        for (auto& activity : m_regionActivity) { activity.clear(); }
+        std::fill(std::begin(m_spillPending), std::end(m_spillPending), true);
+    }
+
+    void GOLGrid::SetMemoryBudget(size_t numBytes, const std::string& spillDirectory)
+    {
+        RestoreAllRegions();
+        m_memoryBudget = 0;
+        for (auto& pStore : m_spillStores) { pStore.reset(); }
+        if (!numBytes) { return; }
+
+        const std::string Directory{
+            spillDirectory.empty() ?
+                std::filesystem::temp_directory_path().string() :
+                spillDirectory};
+        for (auto& pStore : m_spillStores)
+        {
+            pStore = std::make_unique<SpillStore>(Directory);
+        }
+
+        m_memoryBudget = numBytes;
+        std::fill(std::begin(m_spillPending), std::end(m_spillPending), true);
+    }
+
+    size_t GOLGrid::GetSpilledRegionCount() const
+    {
+        size_t numSpilled{0};
+        for (const auto& Spilled : m_spilledRegions) { numSpilled += Spilled.size(); }
+        return numSpilled;
+    }
+
+    size_t GOLGrid::GetStoredCellCount() const
+    {
+        size_t numCells{0};
+        for (const auto& Shard : m_shards) { numCells += Shard.Size(); }
+        return numCells;
+    }
+
+    size_t GOLGrid::GetStorageMemoryUsage() const
+    {
+        size_t numBytes{0};
+        for (const auto& Shard : m_shards) { numBytes += Shard.MemoryUsage(); }
+        return numBytes;
+    }
+
+    size_t GOLGrid::GetFrozenRegionCount() const
+    {
+        size_t numFrozen{0};
+        for (const auto& Frozen : m_frozenRegions) { numFrozen += Frozen.size(); }
+        return numFrozen;
+    }
+
+    uint64_t GOLGrid::GetPopulation() const
+    {
+        //
+        // Summaries of frozen regions' toggles count births minus deaths.
+        //
+        const size_t OutOfPhaseParity{(m_generation + 1) & 1};
+
+        uint64_t population{0};
+        for (size_t shardIndex = 0; shardIndex < m_shards.size(); ++shardIndex)
+        {
+            population += m_tileIndexes[shardIndex].Population();
+            population += m_frozenToggleSummaries[shardIndex][OutOfPhaseParity].Population;
+        }
+
+        return population;
+    }
+
+    bool GOLGrid::GetBoundingBox(CellAddress& min, CellAddress& max) const
+    {
+        //
+        // Scan inwards from each edge of each shard's index for the first
+        // line of tiles with a live cell, then take the outermost cell of
+        // those tiles.
+        //
+        const int64_t Max{std::numeric_limits<int64_t>::max()};
+        const int64_t Min{std::numeric_limits<int64_t>::min()};
+        CellAddress low(Max, Max);
+        CellAddress high(Min, Min);
+        for (size_t shardIndex = 0; shardIndex < m_shards.size(); ++shardIndex)
+        {
+            const auto& Index = m_tileIndexes[shardIndex];
+            for (size_t edge = 0; edge < 4; ++edge)
+            {
+                Index.ScanFromEdge(edge, [&](const TileIndex::TileKey& key, const TileIndex::Tile& indexed)
+                {
+                    const auto Tile = CurrentTile(shardIndex, key, indexed);
+                    uint16_t columns{0};
+                    int64_t firstRow{-1};
+                    int64_t lastRow{-1};
+                    for (int64_t row = 0; row < TileIndex::TileSize; ++row)
+                    {
+                        if (!Tile[row]) { continue; }
+                        columns |= Tile[row];
+                        if (firstRow < 0) { firstRow = row; }
+                        lastRow = row;
+                    }
+                    if (!columns) { return false; }
+
+                    const int64_t OriginX{key.first << TileIndex::TileShift};
+                    const int64_t OriginY{key.second << TileIndex::TileShift};
+                    int64_t firstColumn{0};
+                    while (!((columns >> firstColumn) & 1)) { ++firstColumn; }
+                    int64_t lastColumn{TileIndex::TileSize - 1};
+                    while (!((columns >> lastColumn) & 1)) { --lastColumn; }
+
+                    low.first = std::min(low.first, OriginX + firstColumn);
+                    high.first = std::max(high.first, OriginX + lastColumn);
+                    low.second = std::min(low.second, OriginY + firstRow);
+                    high.second = std::max(high.second, OriginY + lastRow);
+                    return true;
+                });
+            }
+        }
+
+        if (low.first > high.first) { return false; }
+
+        min = low;
+        max = high;
+        return true;
+    }
+
+    std::vector<CellAddress> GOLGrid::GetLiveCellsInRect(
+        const CellAddress& min,
+        const CellAddress& max) const
+    {
+        std::vector<CellAddress> addresses;
+        if (min.first > max.first || min.second > max.second) { return addresses; }
+
+        const auto MinKey = TileIndex::TileKeyOf(min);
+        const auto MaxKey = TileIndex::TileKeyOf(max);
+        for (size_t shardIndex = 0; shardIndex < m_shards.size(); ++shardIndex)
+        {
+            m_tileIndexes[shardIndex].ForEachTileInRect(
+                MinKey,
+                MaxKey,
+                [&](const TileIndex::TileKey& key, const TileIndex::Tile& indexed)
+                {
+                    const auto Tile = CurrentTile(shardIndex, key, indexed);
+                    const int64_t OriginX{key.first << TileIndex::TileShift};
+                    const int64_t OriginY{key.second << TileIndex::TileShift};
+                    for (int64_t row = 0; row < TileIndex::TileSize; ++row)
+                    {
+                        const int64_t Y{OriginY + row};
+                        if (Y < min.second || Y > max.second) { continue; }
+
+                        for (int64_t column = 0; column < TileIndex::TileSize; ++column)
+                        {
+                            const int64_t X{OriginX + column};
+                            if (((Tile[row] >> column) & 1) && X >= min.first && X <= max.first)
+                            {
+                                addresses.emplace_back(X, Y);
+                            }
+                        }
+                    }
+                });
+        }
+
+        std::sort(std::begin(addresses), std::end(addresses));
+        return addresses;
+    }
+
+    TileIndex::Tile GOLGrid::CurrentTile(
+        size_t shardIndex,
+        const TileIndex::TileKey& key,
+        const TileIndex::Tile& indexed) const
+    {
+        TileIndex::Tile tile = indexed;
+
+        const auto& FrozenRegions = m_frozenRegions[shardIndex];
+        if (FrozenRegions.empty()) { return tile; }
+
+        const auto FrozenIt = FrozenRegions.find(key);
+        if (FrozenIt == FrozenRegions.end()) { return tile; }
+
+        const auto& Frozen = FrozenIt->second;
+        if (!((m_generation - Frozen.FreezeGeneration) & 1)) { return tile; }
+
+        for (const auto& Toggle : Frozen.Toggles)
+        {
+            const size_t Row{static_cast<size_t>(Toggle.Address.second & (TileIndex::TileSize - 1))};
+            const uint16_t Bit = uint16_t(1u << (Toggle.Address.first & (TileIndex::TileSize - 1)));
+            tile[Row] = Toggle.Alive ? uint16_t(tile[Row] | Bit) : uint16_t(tile[Row] & ~Bit);
+        }
+
+        return tile;
+    }
+
+    size_t GOLGrid::RegionKeyHash::operator()(const RegionKey& key) const noexcept
+    {
+        return static_cast<size_t>(HashCoordinates(key.first, key.second));
+    }
+
+    void GOLGrid::NoteTouch(size_t shardIndex, const RegionKey& region)
+    {
+        RestoreRegion(shardIndex, region);
+        m_regionActivity[shardIndex][region].LastTouched = m_generation + 1;
+        if (m_frozenRegions[shardIndex].count(region))
+        {
+            m_regionsToThaw[shardIndex].push_back(region);
+        }
+    }
+
+    void GOLGrid::TrackRegionActivity(size_t shardIndex, uint64_t generation)
+    {
+        auto& activities = m_regionActivity[shardIndex];
+
+        //
+        // Group this generation's changes by region, each group sorted.
+        //
+        auto& changes = m_regionChanges[shardIndex];
+        changes.assign(
+            std::begin(m_changes[shardIndex]),
+            std::end(m_changes[shardIndex]));
+        std::sort(
+            std::begin(changes),
+            std::end(changes),
+            [](const Cell& a, const Cell& b)
+            {
+                const auto RegionA = RegionOf(a.Address);
+                const auto RegionB = RegionOf(b.Address);
+                return RegionA != RegionB ?
+                    RegionA < RegionB :
+                    a.Address < b.Address;
+            });
+
+        for (auto first = std::cbegin(changes); first != std::cend(changes);)
+        {
+            const RegionKey Region{RegionOf(first->Address)};
+            const auto Last = std::find_if(
+                first,
+                std::cend(changes),
+                [&Region](const Cell& cell)
+                {
+                    return RegionOf(cell.Address) != Region;
+                });
+
+            auto& activity = activities[Region];
+            if (activity.LastChanged + 1 != generation)
+            {
+                activity.Changes[0].clear();
+                activity.Changes[1].clear();
+                activity.NumRepeats = 0;
+            }
+
+            auto& previous = activity.Changes[generation & 1];
+            const bool Repeated{
+                !previous.empty() && SameChanges(previous, first, Last)};
+            const bool Interior = std::all_of(
+                first,
+                Last,
+                [](const Cell& cell) { return InRegionInterior(cell.Address); });
+
+            activity.NumRepeats = Repeated && Interior ? activity.NumRepeats + 1 : 0;
+            activity.LastChanged = generation;
+            previous.assign(first, Last);
+            first = Last;
+
+            const bool Undisturbed{
+                generation - activity.LastTouched > FreezeAfterRepeats};
+            if (m_freezeRegions &&
+                activity.NumRepeats >= FreezeAfterRepeats &&
+                Undisturbed)
+            {
+                FreezeRegion(shardIndex, Region, activity, generation);
+                activities.erase(Region);
+                m_spillPending[shardIndex] = true;
+            }
+        }
+
+        //
+        // Forget regions which have gone quiet. Each is a new candidate for
+        // spilling.
+        //
+        for (auto it = std::begin(activities); it != std::end(activities);)
+        {
+            const uint64_t LastActive{
+                std::max(it->second.LastChanged, it->second.LastTouched)};
+            if (LastActive + 2 < generation)
+            {
+                it = activities.erase(it);
+                m_spillPending[shardIndex] = true;
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+    void GOLGrid::FreezeRegion(
+        size_t shardIndex,
+        const RegionKey& region,
+        RegionActivity& activity,
+        uint64_t generation)
+    {
+        //
+        // With period 2, the next generation repeats the changes of the
+        // previous one.
+        //
+        FrozenRegion frozen;
+        frozen.FreezeGeneration = generation;
+        frozen.Toggles = std::move(activity.Changes[(generation + 1) & 1]);
+        for (const auto& Toggle : frozen.Toggles)
+        {
+            if (Toggle.Alive) { frozen.ToggleSummary.Add(Toggle.Address); }
+            else              { frozen.ToggleSummary.Remove(Toggle.Address); }
+        }
+        m_frozenToggleSummaries[shardIndex][generation & 1].Merge(
+            frozen.ToggleSummary);
+
+        //
+        // This generation's changes queued themselves and their neighbors,
+        // all inside the region. Nothing else in it is queued, since nothing
+        // outside has touched it lately.
+        //
+        auto& storage = m_shards[shardIndex];
+        for (const auto& Change : activity.Changes[generation & 1])
+        {
+            auto changeIt = storage.Find(Change.Address);
+            if (changeIt != storage.end()) { changeIt->second.Dirty = false; }
+
+            for (const auto& Offset : NeighborOffsets)
+            {
+                auto neighborIt = storage.Find(Change.Address + Offset);
+                if (neighborIt != storage.end())
+                {
+                    neighborIt->second.Dirty = false;
+                }
+            }
+        }
+
+        m_frozenRegions[shardIndex].emplace(region, std::move(frozen));
+    }
+
+    void GOLGrid::ThawRegions(size_t shardIndex, uint64_t generation)
+    {
+        auto& storage = m_shards[shardIndex];
+        auto& frozenRegions = m_frozenRegions[shardIndex];
+        auto& summary = m_summaries[shardIndex];
+
+        std::vector<RegionKey> regionsToThaw;
+        regionsToThaw.swap(m_regionsToThaw[shardIndex]);
+        for (const auto& Region : regionsToThaw)
+        {
+            auto frozenIt = frozenRegions.find(Region);
+            if (frozenIt == frozenRegions.end()) { continue; }
+
+            const FrozenRegion Frozen{std::move(frozenIt->second)};
+            frozenRegions.erase(frozenIt);
+            RestoreRegion(shardIndex, Region);
+            m_frozenToggleSummaries[shardIndex][Frozen.FreezeGeneration & 1]
+                .Subtract(Frozen.ToggleSummary);
+
+            //
+            // Bring storage into phase, then let the region's oscillators
+            // carry on being evaluated as usual.
+            //
+            const bool OutOfPhase{((generation - Frozen.FreezeGeneration) & 1) != 0};
+            for (const auto& Toggle : Frozen.Toggles)
+            {
+                auto toggleIt = storage.Find(Toggle.Address);
+                assert(toggleIt != storage.end());
+
+                if (OutOfPhase)
+                {
+                    toggleIt->second.Alive = Toggle.Alive;
+                    m_tileIndexes[shardIndex].SetAlive(Toggle.Address, Toggle.Alive);
+                    if (m_detectCycles)
+                    {
+                        if (Toggle.Alive) { summary.Add(Toggle.Address); }
+                        else              { summary.Remove(Toggle.Address); }
+                    }
+
+                    const Cell Toggled{toggleIt->second};
+                    PropagateChange(Toggled, shardIndex);
+                }
+                else
+                {
+                    MarkDirty(shardIndex, toggleIt->second);
+                }
+            }
+
+            //
+            // Don't refreeze straight away.
+            //
+            m_regionActivity[shardIndex][Region].LastTouched = generation;
+        }
+    }
+
+    void GOLGrid::ThawAllRegions()
+    {
+        ForEachShard([&](size_t shardIndex)
+        {
+            for (const auto& [Region, IGNORE] : m_frozenRegions[shardIndex])
+            {
+                m_regionsToThaw[shardIndex].push_back(Region);
+            }
+
+            ThawRegions(shardIndex, m_generation);
+        });
+    }
+
+    bool GOLGrid::IsToggledByFrozenRegion(
+        size_t shardIndex,
+        const CellAddress& address) const
+    {
+        const auto& FrozenRegions = m_frozenRegions[shardIndex];
+        const auto FrozenIt = FrozenRegions.find(RegionOf(address));
+        if (FrozenIt == FrozenRegions.end()) { return false; }
+
+        const auto& Frozen = FrozenIt->second;
+        if (!((m_generation - Frozen.FreezeGeneration) & 1)) { return false; }
+
+        return std::binary_search(
+            std::begin(Frozen.Toggles),
+            std::end(Frozen.Toggles),
+            Cell(address, false, 0),
+            [](const Cell& a, const Cell& b) { return a.Address < b.Address; });
+    }
+
+    void GOLGrid::ApplyFrozenPhases(std::vector<Cell>& sortedCells) const
+    {
+        auto Find = [&sortedCells](const CellAddress& address)
+        {
+            auto it = std::lower_bound(
+                std::begin(sortedCells),
+                std::end(sortedCells),
+                address,
+                [](const Cell& cell, const CellAddress& a)
+                {
+                    return cell.Address < a;
+                });
+            return it != std::end(sortedCells) && it->Address == address ?
+                it :
+                std::end(sortedCells);
+        };
+
+        //
+        // Births may land next to cells storage has since retired.
+        //
+        std::map<CellAddress, uint8_t> missingNeighbors;
+        for (const auto& FrozenRegions : m_frozenRegions)
+        {
+            for (const auto& [IGNORE, Frozen] : FrozenRegions)
+            {
+                if (!((m_generation - Frozen.FreezeGeneration) & 1)) { continue; }
+
+                for (const auto& Toggle : Frozen.Toggles)
+                {
+                    auto toggleIt = Find(Toggle.Address);
+                    assert(toggleIt != std::end(sortedCells));
+                    toggleIt->Alive = Toggle.Alive;
+
+                    for (const auto& Offset : NeighborOffsets)
+                    {
+                        const auto NeighborAddress = Toggle.Address + Offset;
+                        auto neighborIt = Find(NeighborAddress);
+                        if (neighborIt == std::end(sortedCells))
+                        {
+                            assert(Toggle.Alive);
+                            ++missingNeighbors[NeighborAddress];
+                        }
+                        else if (Toggle.Alive)
+                        {
+                            ++neighborIt->NeighborCount;
+                        }
+                        else
+                        {
+                            --neighborIt->NeighborCount;
+                        }
+                    }
+                }
+            }
+        }
+
+        if (missingNeighbors.empty()) { return; }
+
+        const bool DeadCell{false};
+        for (const auto& [Address, NeighborCount] : missingNeighbors)
+        {
+            sortedCells.emplace_back(Address, DeadCell, NeighborCount);
+        }
+        SortByAddress(sortedCells);
+    }
+
+    void GOLGrid::SpillColdRegions(size_t shardIndex)
+    {
+        auto& storage = m_shards[shardIndex];
+        const size_t ShardBudget{m_memoryBudget / m_shards.size()};
+        const size_t MemoryUsage{storage.MemoryUsage()};
+        if (MemoryUsage <= ShardBudget || !m_spillPending[shardIndex]) { return; }
+        m_spillPending[shardIndex] = false;
+
+        //
+        // Spill down to about half the budget, so that passes are rare, then
+        // hand the memory back. Every cell takes about as much room.
+        //
+        const size_t TargetSize{static_cast<size_t>(
+            static_cast<double>(storage.Size()) * static_cast<double>(ShardBudget / 2) /
+            static_cast<double>(MemoryUsage))};
+
+        const auto& Activities = m_regionActivity[shardIndex];
+        auto& spilledRegions = m_spilledRegions[shardIndex];
+        auto& store = *m_spillStores[shardIndex];
+        std::array<uint8_t, SpillStore::SlotSize> slot;
+        const size_t NumSpilled{spilledRegions.size()};
+        m_tileIndexes[shardIndex].ForEachTile([&](const TileIndex::TileKey& region, const TileIndex::Tile&)
+        {
+            //
+            // Recently active regions are left alone. Regions which have been
+            // quiet for long enough aren't queued for evaluation, but check.
+            //
+            if (storage.Size() <= TargetSize ||
+                Activities.count(region) ||
+                spilledRegions.count(region))
+            {
+                return;
+            }
+
+            for (size_t i = 0; i < SpillStore::SlotSize; ++i)
+            {
+                const auto CellIt = storage.Find(RegionCellAddress(region, i));
+                if (CellIt == storage.end())
+                {
+                    slot[i] = 0;
+                    continue;
+                }
+
+                const Cell& Stored = CellIt->second;
+                if (Stored.Dirty) { return; }
+
+                slot[i] = static_cast<uint8_t>(
+                    SpilledCellStored | (Stored.NeighborCount << 1) | Stored.Alive);
+            }
+
+            spilledRegions.emplace(region, store.Store(slot.data()));
+            for (size_t i = 0; i < SpillStore::SlotSize; ++i)
+            {
+                if (slot[i]) { storage.Remove(RegionCellAddress(region, i)); }
+            }
+        });
+
+        //
+        // Passes which find nothing keep the memory, rather than give it back
+        // only to have storage grow into it again.
+        //
+        if (spilledRegions.size() != NumSpilled) { storage.ShrinkToFit(); }
+    }
+
+    void GOLGrid::RestoreRegion(size_t shardIndex, const RegionKey& region)
+    {
+        auto& spilledRegions = m_spilledRegions[shardIndex];
+        if (spilledRegions.empty()) { return; }
+
+        const auto SpilledIt = spilledRegions.find(region);
+        if (SpilledIt == spilledRegions.end()) { return; }
+
+        auto& store = *m_spillStores[shardIndex];
+        auto& storage = m_shards[shardIndex];
+        const uint8_t* pSlot = store.Load(SpilledIt->second);
+        for (size_t i = 0; i < SpillStore::SlotSize; ++i)
+        {
+            if (!pSlot[i]) { continue; }
+
+            storage.Insert(
+                RegionCellAddress(region, i),
+                pSlot[i] & 1,
+                static_cast<uint8_t>((pSlot[i] & ~SpilledCellStored) >> 1));
+        }
+
+        store.Release(SpilledIt->second);
+        spilledRegions.erase(SpilledIt);
+    }
+
+    void GOLGrid::RestoreAllRegions()
+    {
+        ForEachShard([&](size_t shardIndex)
+        {
+            auto& spilledRegions = m_spilledRegions[shardIndex];
+            while (!spilledRegions.empty())
+            {
+                const RegionKey Region{std::begin(spilledRegions)->first};
+                RestoreRegion(shardIndex, Region);
+            }
+        });
+    }
+
+    void GOLGrid::AppendSpilledCells(std::vector<Cell>& cells) const
+    {
+        for (size_t shardIndex = 0; shardIndex < m_shards.size(); ++shardIndex)
+        {
+            for (const auto& [Region, Slot] : m_spilledRegions[shardIndex])
+            {
+                const uint8_t* pSlot = m_spillStores[shardIndex]->Load(Slot);
+                for (size_t i = 0; i < SpillStore::SlotSize; ++i)
+                {
+                    if (!pSlot[i]) { continue; }
+
+                    cells.emplace_back(
+                        RegionCellAddress(Region, i),
+                        (pSlot[i] & 1) != 0,
+                        static_cast<uint8_t>((pSlot[i] & ~SpilledCellStored) >> 1));
+                }
+            }
+        }
+    }
+}
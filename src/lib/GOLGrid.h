@@ -6,18 +6,92 @@
 
 #include "Cell.h"
 #include "CellStorage.h"
+#include "LiveSetHash.h"
+#include "Rule.h"
+#include "TileIndex.h"
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 namespace gol
 {
+    class SpillStore;
+    class ThreadPool;
+
     class GOLGrid
     {
     public:
         //
         // cellAddresses lists all live cells which describes the initial state.
         //
-        GOLGrid(const std::vector<CellAddress>& cellAddresses);
+        // With numThreads > 1, storage is partitioned into spatial shards and
+        // each generation is computed on a pool of that many threads. Results
+        // are identical to the single-threaded path.
+        //
+        GOLGrid(
+            const std::vector<CellAddress>& cellAddresses,
+            size_t numThreads = 1)
+            : GOLGrid(
+                std::begin(cellAddresses),
+                std::end(cellAddresses),
+                numThreads) {}
+
+        //
+        // Same as above, for any range of CellAddress (e.g. a span over a
+        // parser's buffer) without copying it into a vector first.
+        //
+        template<typename AddressIterator>
+        GOLGrid(
+            AddressIterator first,
+            AddressIterator last,
+            size_t numThreads = 1)
+            : GOLGrid(numThreads)
+        {
+            InsertLiveCells(first, last);
+        }
+
+        ~GOLGrid();
+
+        //
+        // Brings the cells in the range to life, as if they had been part of
+        // the initial state. Cells which are already alive, and duplicates
+        // within the range, are ignored.
+        //
+        // Runs in time linear in the size of the range; with random access
+        // iterators and a thread pool, the range is split up in parallel.
+        //
+        template<typename AddressIterator>
+        void InsertLiveCells(AddressIterator first, AddressIterator last)
+        {
+            SetRoutedCells(RouteAddresses(first, last), true);
+        }
+
+        //
+        // Kills the cells in the range, the reverse of InsertLiveCells. Cells
+        // which are already dead are ignored.
+        //
+        template<typename AddressIterator>
+        void RemoveLiveCells(AddressIterator first, AddressIterator last)
+        {
+            SetRoutedCells(RouteAddresses(first, last), false);
+        }
+
+        //
+        // Kills every cell and rewinds to generation 0, keeping the rule,
+        // the thread pool, the settings above and below, and the memory held
+        // by storage and scratch space. Together with InsertLiveCells, this
+        // lets one grid run many patterns in turn without reallocating.
+        //
+        void Clear();
 
         //
         // Advance the generation by one single iteration.
@@ -25,14 +99,480 @@ namespace gol
         void AdvanceGeneration();
 
         //
-        // Retrieve cells for testing, output and debugging. The returned data 
-        // results from a deep copy of the internals.
+        // Advance by an arbitrary number of generations. With cycle detection
+        // on, once the live set is found to repeat (possibly shifted, as with
+        // spaceships) whole periods are skipped by translating the board
+        // rather than computed.
+        //
+        void AdvanceGenerations(uint64_t numGenerations);
+
+        //
+        // The Life-like rule to evolve under, Conway's B3/S23 by default.
+        // Throws std::invalid_argument for rules with B0, which would bring
+        // the whole empty plane to life.
+        //
+        void SetRule(const Rule& rule);
+        const Rule& GetRule() const { return m_rule; }
+
+        //
+        // Cycle detection keeps a translation-aware hash of the live set up
+        // to date, which costs a little per changed cell. Off by default.
+        //
+        void SetCycleDetection(bool enabled);
+
+        //
+        // Period is 0 until a cycle has been found. Offset is how far the
+        // live set moves over one period.
+        //
+        struct Cycle
+        {
+            uint64_t    Period = 0;
+            CellAddress Offset;
+        };
+
+        const Cycle& GetCycle() const { return m_cycle; }
+        uint64_t     GetGeneration() const { return m_generation; }
+
+        //
+        // With region freezing on, the plane is watched in small square
+        // regions. A region whose changes have been repeating with period 2
+        // (blinkers and the like), well away from its border and with nothing
+        // outside disturbing it, is frozen: its cells are no longer evaluated
+        // and its state is derived from the generation's parity instead. The
+        // first outside change to reach its cells thaws it again. Still lifes
+        // already cost nothing, so this leaves only genuinely evolving areas
+        // to compute. Off by default.
+        //
+        // Changes inside frozen regions aren't reported by ForEachChange.
+        //
+        void SetRegionFreezing(bool enabled);
+        size_t GetFrozenRegionCount() const;
+
+        //
+        // With a memory budget, storage that outgrows its share of the budget
+        // spills cold regions: those which nothing has changed or touched for
+        // a few generations, such as still lifes and frozen regions, going by
+        // the same activity tracking region freezing uses. Their cells move
+        // to a backing file in spillDirectory (the system's temporary
+        // directory if empty), 16x16 cells to a compact fixed-size slot, and
+        // are paged back in as soon as a change reaches them. Everything else
+        // (the live cell index, frozen regions' toggles) stays in memory, so
+        // the budget is approximate. 0, the default, means no budget.
+        //
+        // Throws std::runtime_error if the backing file can't be created.
+        // AdvanceGeneration throws it if the file can't grow.
+        //
+        void SetMemoryBudget(
+            size_t numBytes,
+            const std::string& spillDirectory = std::string());
+        size_t GetSpilledRegionCount() const;
+
+        //
+        // Timings and counts for the last generation, for diagnostics. Phase
+        // times are summed over shards. Collecting them costs a few clock
+        // reads per shard and generation, so it's off by default.
+        //
+        struct StepStats
+        {
+            uint64_t ClassifyNanoseconds = 0;
+            uint64_t PropagateNanoseconds = 0;
+            uint64_t RetireNanoseconds = 0;
+            uint64_t FreezeNanoseconds = 0;
+            uint64_t ChangedCells = 0;
+            uint64_t RetiredCells = 0;
+        };
+
+        void SetStepStats(bool enabled) { m_collectStats = enabled; }
+        const StepStats& GetLastStepStats() const { return m_lastStepStats; }
+
+        //
+        // Cells held in storage, live or dead, and the memory they take up.
+        // Spilled cells aren't counted.
+        //
+        size_t GetStoredCellCount() const;
+        size_t GetStorageMemoryUsage() const;
+
+        //
+        // Number of live cells, kept up to date as cells change.
+        //
+        uint64_t GetPopulation() const;
+
+        //
+        // Inclusive bounds of the live cells, read off the edges of the
+        // spatial index. Returns false if there are no live cells.
+        //
+        bool GetBoundingBox(CellAddress& min, CellAddress& max) const;
+
+        //
+        // Live cells within the inclusive rectangle [min, max], sorted by
+        // address. Costs time proportional to the occupied 16x16 tiles the
+        // rectangle overlaps, not to the population.
+        //
+        std::vector<CellAddress> GetLiveCellsInRect(
+            const CellAddress& min,
+            const CellAddress& max) const;
+
+        //
+        // Retrieve cells for testing, output and debugging. The returned data
+        // results from a deep copy of the internals, sorted by address.
         //
         std::vector<Cell> GetLiveCells() const;
         std::vector<Cell> GetAllCells() const;
 
+        //
+        // Calls visitor(const CellAddress&) for every live cell, in place and
+        // without allocating. Order is unspecified.
+        //
+        template<typename Visitor>
+        void ForEachLiveCell(Visitor&& visitor) const
+        {
+            for (size_t shardIndex = 0; shardIndex < m_shards.size(); ++shardIndex)
+            {
+                //
+                // Frozen regions' storage may be a generation out of phase.
+                //
+                const bool HasFrozenRegions{!m_frozenRegions[shardIndex].empty()};
+                for (const auto& [Address, Cell] : m_shards[shardIndex])
+                {
+                    const bool Alive = HasFrozenRegions ?
+                        Cell.Alive != IsToggledByFrozenRegion(shardIndex, Address) :
+                        Cell.Alive != 0;
+                    if (Alive) { visitor(Address); }
+                }
+
+                //
+                // Spilled regions' live cells are still in the index.
+                //
+                const auto& Index = m_tileIndexes[shardIndex];
+                for (const auto& [Region, IGNORE] : m_spilledRegions[shardIndex])
+                {
+                    const auto* pIndexed = Index.FindTile(Region);
+                    if (!pIndexed) { continue; }
+
+                    const auto Tile = CurrentTile(shardIndex, Region, *pIndexed);
+                    for (int64_t row = 0; row < TileIndex::TileSize; ++row)
+                    {
+                        for (int64_t column = 0; column < TileIndex::TileSize; ++column)
+                        {
+                            if ((Tile[row] >> column) & 1)
+                            {
+                                visitor(CellAddress(
+                                    (Region.first << TileIndex::TileShift) + column,
+                                    (Region.second << TileIndex::TileShift) + row));
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        //
+        // Calls visitor(const CellAddress&, bool alive) for every cell which
+        // was born (alive) or died during the last AdvanceGeneration. Order is
+        // unspecified.
+        //
+        template<typename Visitor>
+        void ForEachChange(Visitor&& visitor) const
+        {
+            for (const auto& Changes : m_changes)
+            {
+                for (const auto& Change : Changes)
+                {
+                    visitor(Change.Address, Change.Alive);
+                }
+            }
+        }
+
     private:
-        CellStorage  m_storage;
+        explicit GOLGrid(size_t numThreads);
+
+        //
+        // Addresses grouped first by input chunk, then by owning shard.
+        //
+        using RoutedAddresses = std::vector<std::vector<std::vector<CellAddress>>>;
+
+        //
+        // Outgoing changed cells grouped first by source shard, then by
+        // destination shard.
+        //
+        using Outboxes = std::vector<std::vector<std::vector<Cell>>>;
+
+        template<typename AddressIterator>
+        RoutedAddresses RouteAddresses(AddressIterator first, AddressIterator last);
+
+        void SetRoutedCells(const RoutedAddresses& routedAddresses, bool alive);
+        size_t NumRoutingChunks() const;
+
+        size_t ShardOf(const CellAddress& address) const;
+        size_t ShardOfBlock(int64_t blockX, int64_t blockY) const;
+        void   ParallelFor(
+            size_t numTasks,
+            const std::function<void(size_t)>& task);
+
+        //
+        // The task is passed on by reference, which std::function stores
+        // without allocating however much the task captures.
+        //
+        template<typename ShardTask>
+        void ForEachShard(ShardTask&& shardTask)
+        {
+            ParallelFor(m_shards.size(), std::ref(shardTask));
+        }
+
+        //
+        // The first pass of a generation: evaluates each shard's frontier,
+        // flipping cells and posting their changes. Transitions maps a
+        // Cell::LookupKey() to the next state; there's a specialization for
+        // each common rule and a generic one.
+        //
+        void ClassifyShards(bool collectStats);
+
+        template<typename Transitions>
+        void ClassifyShard(
+            size_t shardIndex,
+            const Transitions& transitions,
+            bool collectStats);
+
+        //
+        // Queues a transitioned cell for every shard owning one of its
+        // neighbors, then (from within the owning shard's task) applies the
+        // neighbor count updates which fall inside that shard.
+        //
+        void PostChange(
+            const Cell& changedCell,
+            std::vector<std::vector<Cell>>& outbox) const;
+        void PropagateChange(const Cell& changedCell, size_t shardIndex);
+        void DrainOutboxes(const Outboxes& outboxes, size_t shardIndex);
+
+        //
+        // Queues a cell of the given shard for evaluation next generation.
+        //
+        void MarkDirty(size_t shardIndex, Cell& cell);
+
+        //
+        // Brent's cycle finding: the live set is remembered at generations
+        // spaced by doubling intervals and every later generation compared
+        // against it, which finds the exact period using constant memory.
+        //
+        void RestartCycleSearch();
+        void ContinueCycleSearch();
+        bool MatchesSavedCells(const CellAddress& offset) const;
+        std::vector<CellAddress> GetSortedLiveAddresses() const;
+
+        LiveSetSummary SummarizeLiveSet() const;
+
+        //
+        // Empties storage and everything derived from it, leaving the
+        // generation and cycle search alone.
+        //
+        void ClearCells();
+
+        //
+        // Moves every live cell by offset, rebuilding storage.
+        //
+        void Translate(const CellAddress& offset);
+
+        //
+        // Region freezing. Regions are small enough to never straddle two
+        // shards, so all of this runs inside the owning shard's task.
+        //
+        using RegionKey = CellAddress;
+        struct RegionKeyHash
+        {
+            size_t operator()(const RegionKey& key) const noexcept;
+        };
+
+        //
+        // Recent changes within a region which is active but not frozen.
+        //
+        struct RegionActivity
+        {
+            //
+            // Sorted changes of the last two generations, by parity.
+            //
+            std::array<std::vector<Cell>, 2> Changes;
+            uint64_t LastChanged = 0;
+            uint64_t LastTouched = 0;
+            uint32_t NumRepeats = 0;
+        };
+
+        struct FrozenRegion
+        {
+            //
+            // Storage holds the region as of FreezeGeneration. Generations an
+            // odd number later have these cells (sorted) in the given state.
+            //
+            std::vector<Cell> Toggles;
+            uint64_t          FreezeGeneration = 0;
+            LiveSetSummary    ToggleSummary;
+        };
+
+        template<typename ValueType>
+        using RegionMap = std::unordered_map<RegionKey, ValueType, RegionKeyHash>;
+
+        void NoteTouch(size_t shardIndex, const RegionKey& region);
+        void TrackRegionActivity(size_t shardIndex, uint64_t generation);
+        void FreezeRegion(
+            size_t shardIndex,
+            const RegionKey& region,
+            RegionActivity& activity,
+            uint64_t generation);
+        void ThawRegions(size_t shardIndex, uint64_t generation);
+        void ThawAllRegions();
+        bool IsToggledByFrozenRegion(
+            size_t shardIndex,
+            const CellAddress& address) const;
+        void ApplyFrozenPhases(std::vector<Cell>& sortedCells) const;
+
+        //
+        // Spilling. Regions only ever move between the storage and the spill
+        // store of their own shard.
+        //
+        bool TracksRegions() const { return m_freezeRegions || m_memoryBudget; }
+        void SpillColdRegions(size_t shardIndex);
+        void RestoreRegion(size_t shardIndex, const RegionKey& region);
+        void RestoreAllRegions();
+        void AppendSpilledCells(std::vector<Cell>& cells) const;
+
+        //
+        // An index tile as of the current generation: frozen regions line up
+        // with tiles, and may be out of phase with what the index recorded.
+        //
+        TileIndex::Tile CurrentTile(
+            size_t shardIndex,
+            const TileIndex::TileKey& key,
+            const TileIndex::Tile& indexed) const;
+
+        Rule                        m_rule = ConwayRule;
+        std::vector<CellStorage>    m_shards;
+
+        //
+        // Per shard, the addresses of cells to evaluate next generation.
+        //
+        std::vector<std::vector<CellAddress>> m_frontiers;
+
+        //
+        // Per shard, the live cells by tile. Tiles never straddle shards.
+        //
+        std::vector<TileIndex> m_tileIndexes;
+
+        //
+        // Per shard, the cells which transitioned last generation.
+        //
+        std::vector<std::vector<Cell>> m_changes;
+
+        //
+        // Per-generation scratch space, kept between generations so that
+        // stepping a settled board doesn't allocate: outboxes, cells to
+        // retire, the frontier being evaluated (swapped with m_frontiers),
+        // changes grouped by region, and per-shard stats.
+        //
+        Outboxes                              m_outboxes;
+        std::vector<std::vector<CellAddress>> m_retiredCells;
+        std::vector<std::vector<CellAddress>> m_evaluating;
+        std::vector<std::vector<Cell>>        m_regionChanges;
+        std::vector<StepStats>                m_shardStats;
+
+        uint64_t m_generation = 0;
+        bool     m_detectCycles = false;
+
+        //
+        // Per shard, a summary of the shard's live cells. Only maintained
+        // while detecting cycles.
+        //
+        std::vector<LiveSetSummary> m_summaries;
+
+        LiveSetSummary           m_savedSummary;
+        std::vector<CellAddress> m_savedCells;
+        uint64_t                 m_savedGeneration = 0;
+        uint64_t                 m_searchInterval = 1;
+        Cycle                    m_cycle;
+
+        //
+        // Set when cells were inserted or removed: the search restarts from
+        // the board as it stands at the next step.
+        //
+        bool m_cycleSearchPending = false;
+
+        bool m_freezeRegions = false;
+
+        //
+        // Per shard: recently active regions, frozen regions, regions to thaw
+        // at the end of this generation, and the summed ToggleSummary of the
+        // frozen regions by the parity of their freeze generation.
+        //
+        std::vector<RegionMap<RegionActivity>> m_regionActivity;
+        std::vector<RegionMap<FrozenRegion>>   m_frozenRegions;
+        std::vector<std::vector<RegionKey>>    m_regionsToThaw;
+        std::vector<std::array<LiveSetSummary, 2>> m_frozenToggleSummaries;
+
+        size_t m_memoryBudget = 0;
+
+        //
+        // Per shard: the store, the slot of each spilled region, whether any
+        // region has gone quiet since the last look for regions to spill, and
+        // anything a spill threw, to be rethrown outside the pool. Storage
+        // over budget is only searched again once there's something new to
+        // find, so that the active cells alone outgrowing the budget don't
+        // cost a search every generation.
+        //
+        std::vector<std::unique_ptr<SpillStore>> m_spillStores;
+        std::vector<RegionMap<size_t>>           m_spilledRegions;
+        std::vector<uint8_t>                     m_spillPending;
+        std::vector<std::exception_ptr>          m_spillFailures;
+
+        bool      m_collectStats = false;
+        StepStats m_lastStepStats;
+
+        std::unique_ptr<ThreadPool> m_pool;
     };
-}
 
+    template<typename AddressIterator>
+    GOLGrid::RoutedAddresses GOLGrid::RouteAddresses(
+        AddressIterator first,
+        AddressIterator last)
+    {
+        using Category =
+            typename std::iterator_traits<AddressIterator>::iterator_category;
+
+        //
+        // Sort the addresses into per-shard buckets. Random access ranges are
+        // cut into chunks which are routed concurrently, each into its own
+        // set of buckets.
+        //
+        if constexpr (std::is_base_of_v<std::random_access_iterator_tag, Category>)
+        {
+            const size_t NumAddresses{static_cast<size_t>(last - first)};
+            const size_t NumChunks{NumRoutingChunks()};
+            RoutedAddresses routedAddresses(
+                NumChunks,
+                std::vector<std::vector<CellAddress>>(m_shards.size()));
+            ParallelFor(NumChunks, [&](size_t chunkIndex)
+            {
+                auto& buckets = routedAddresses[chunkIndex];
+                const auto ChunkFirst = first + NumAddresses * chunkIndex / NumChunks;
+                const auto ChunkLast = first + NumAddresses * (chunkIndex + 1) / NumChunks;
+                for (auto it = ChunkFirst; it != ChunkLast; ++it)
+                {
+                    const CellAddress& Address = *it;
+                    buckets[ShardOf(Address)].push_back(Address);
+                }
+            });
+
+            return routedAddresses;
+        }
+        else
+        {
+            RoutedAddresses routedAddresses(
+                1,
+                std::vector<std::vector<CellAddress>>(m_shards.size()));
+            for (; first != last; ++first)
+            {
+                const CellAddress& Address = *first;
+                routedAddresses[0][ShardOf(Address)].push_back(Address);
+            }
+
+            return routedAddresses;
+        }
+    }
+}
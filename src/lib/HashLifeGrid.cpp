@@ -0,0 +1,504 @@
+#include "HashLifeGrid.h"
+
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+
+namespace
+{
+    //
+    // A level-L root spans [-2^(L-1), 2^(L-1)) on both axes. A level-64 root
+    // would need 2^63 as a coordinate, so the largest is level 63 and cells
+    // beyond [-2^62, 2^62) can't be held at all. Stepping 2^k generations
+    // needs a root of at least level k + 3 with the pattern inside the
+    // middle quarter of it, so nothing beyond [-2^60, 2^60) can be stepped.
+    //
+    constexpr uint32_t MaxLevel{63};
+    constexpr uint32_t MaxStepLog{MaxLevel - 3};
+    constexpr uint32_t MinRootLevel{3};
+
+    constexpr size_t NodesPerBlock{size_t(1) << 16};
+    constexpr size_t DefaultNodeLimit{size_t(1) << 22};
+    constexpr size_t InitialBuckets{size_t(1) << 16};
+}
+
+namespace gol
+{
+    namespace
+    {
+        size_t HashChildren(
+            const void* nw,
+            const void* ne,
+            const void* sw,
+            const void* se)
+        {
+            uint64_t h = reinterpret_cast<uintptr_t>(nw);
+            h = h * 0x9E3779B97F4A7C15ull + reinterpret_cast<uintptr_t>(ne);
+            h = h * 0x9E3779B97F4A7C15ull + reinterpret_cast<uintptr_t>(sw);
+            h = h * 0x9E3779B97F4A7C15ull + reinterpret_cast<uintptr_t>(se);
+            h ^= h >> 29;
+            h *= 0xBF58476D1CE4E5B9ull;
+            h ^= h >> 32;
+            return static_cast<size_t>(h);
+        }
+    }
+
+    HashLifeGrid::HashLifeGrid(const std::vector<CellAddress>& cellAddresses)
+        : m_buckets(InitialBuckets, nullptr),
+          m_nodeLimit(DefaultNodeLimit),
+          m_deadLeaf(new Node()),
+          m_liveLeaf(new Node())
+    {
+        m_liveLeaf->Population = 1;
+
+        //
+        // Find the smallest root which holds every cell.
+        //
+        uint32_t level{MinRootLevel};
+        for (const auto& Address : cellAddresses)
+        {
+            for (;;)
+            {
+                const int64_t Half{int64_t(1) << (level - 1)};
+                const bool Inside =
+                    Address.first  >= -Half && Address.first  < Half &&
+                    Address.second >= -Half && Address.second < Half;
+                if (Inside) { break; }
+
+                if (++level > MaxLevel)
+                {
+                    throw std::overflow_error(
+                        "Cell address is too far from the origin.");
+                }
+            }
+        }
+
+        std::vector<CellAddress> cells(cellAddresses);
+        const int64_t Half{int64_t(1) << (level - 1)};
+        m_root = Build(
+            level,
+            -Half,
+            -Half,
+            cells.data(),
+            cells.data() + cells.size());
+    }
+
+    HashLifeGrid::~HashLifeGrid() = default;
+
+    void HashLifeGrid::AdvanceGeneration()
+    {
+        AdvanceGenerations(1);
+    }
+
+    void HashLifeGrid::AdvanceGenerations(uint64_t numGenerations)
+    {
+        for (uint32_t bit = 0; bit < 64; ++bit)
+        {
+            if (!((numGenerations >> bit) & 1)) { continue; }
+
+            //
+            // Jumps too large for the address space are taken as several
+            // maximal steps.
+            //
+            const uint32_t StepLog{std::min(bit, MaxStepLog)};
+            const uint64_t NumSteps{uint64_t(1) << (bit - StepLog)};
+            for (uint64_t step = 0; step < NumSteps; ++step)
+            {
+                if (m_numNodes > m_nodeLimit) { CollectGarbage(); }
+
+                PrepareRoot(StepLog);
+                m_root = Successor(m_root, StepLog);
+                m_generation += uint64_t(1) << StepLog;
+            }
+        }
+    }
+
+    std::vector<Cell> HashLifeGrid::GetLiveCells() const
+    {
+        std::vector<CellAddress> addresses;
+        ForEachLiveCell([&addresses](const CellAddress& address)
+        {
+            addresses.push_back(address);
+        });
+
+        std::sort(std::begin(addresses), std::end(addresses));
+
+        //
+        // The quadtree doesn't keep neighbor counts, so reconstruct them from
+        // the sorted live set.
+        //
+        std::vector<Cell> liveCells;
+        liveCells.reserve(addresses.size());
+        for (const auto& Address : addresses)
+        {
+            uint8_t neighborCount{0};
+            for (int64_t dx = -1; dx <= 1; ++dx)
+            {
+                for (int64_t dy = -1; dy <= 1; ++dy)
+                {
+                    if (!dx && !dy) { continue; }
+
+                    neighborCount += std::binary_search(
+                        std::begin(addresses),
+                        std::end(addresses),
+                        CellAddress(Address.first + dx, Address.second + dy));
+                }
+            }
+
+            const bool AliveCell{true};
+            liveCells.emplace_back(Address, AliveCell, neighborCount);
+        }
+
+        return liveCells;
+    }
+
+    uint64_t HashLifeGrid::GetPopulation() const
+    {
+        return m_root->Population;
+    }
+
+    HashLifeGrid::Node* HashLifeGrid::Join(
+        Node* nw,
+        Node* ne,
+        Node* sw,
+        Node* se)
+    {
+        const size_t Hash = HashChildren(nw, ne, sw, se);
+        Node*& bucket = m_buckets[Hash & (m_buckets.size() - 1)];
+        for (Node* pNode = bucket; pNode; pNode = pNode->Next)
+        {
+            if (pNode->NW == nw && pNode->NE == ne &&
+                pNode->SW == sw && pNode->SE == se)
+            {
+                return pNode;
+            }
+        }
+
+        Node* pNode = AllocateNode();
+        pNode->NW = nw;
+        pNode->NE = ne;
+        pNode->SW = sw;
+        pNode->SE = se;
+        pNode->Result = nullptr;
+        pNode->StepResult = nullptr;
+        pNode->Population =
+            nw->Population + ne->Population + sw->Population + se->Population;
+        pNode->Level = nw->Level + 1;
+        pNode->StepLog = 0;
+        pNode->Marked = false;
+
+        pNode->Next = bucket;
+        bucket = pNode;
+        if (m_numNodes > m_buckets.size()) { GrowTable(); }
+
+        return pNode;
+    }
+
+    HashLifeGrid::Node* HashLifeGrid::Empty(uint32_t level)
+    {
+        if (m_emptyNodes.empty()) { m_emptyNodes.push_back(m_deadLeaf.get()); }
+
+        while (m_emptyNodes.size() <= level)
+        {
+            Node* pChild = m_emptyNodes.back();
+            m_emptyNodes.push_back(Join(pChild, pChild, pChild, pChild));
+        }
+
+        return m_emptyNodes[level];
+    }
+
+    HashLifeGrid::Node* HashLifeGrid::Build(
+        uint32_t level,
+        int64_t x0,
+        int64_t y0,
+        CellAddress* pBegin,
+        CellAddress* pEnd)
+    {
+        if (pBegin == pEnd) { return Empty(level); }
+        if (!level) { return m_liveLeaf.get(); }
+
+        //
+        // Split the cells into quadrants in place: first north/south, then
+        // west/east within each half.
+        //
+        const int64_t Half{int64_t(1) << (level - 1)};
+        CellAddress* pSouth = std::partition(
+            pBegin,
+            pEnd,
+            [y0, Half](const CellAddress& a) { return a.second < y0 + Half; });
+        auto SplitWestEast = [x0, Half](CellAddress* pFirst, CellAddress* pLast)
+        {
+            return std::partition(
+                pFirst,
+                pLast,
+                [x0, Half](const CellAddress& a) { return a.first < x0 + Half; });
+        };
+        CellAddress* pNorthEast = SplitWestEast(pBegin, pSouth);
+        CellAddress* pSouthEast = SplitWestEast(pSouth, pEnd);
+
+        Node* nw = Build(level - 1, x0, y0, pBegin, pNorthEast);
+        Node* ne = Build(level - 1, x0 + Half, y0, pNorthEast, pSouth);
+        Node* sw = Build(level - 1, x0, y0 + Half, pSouth, pSouthEast);
+        Node* se = Build(level - 1, x0 + Half, y0 + Half, pSouthEast, pEnd);
+        return Join(nw, ne, sw, se);
+    }
+
+    HashLifeGrid::Node* HashLifeGrid::Successor(Node* node, uint32_t stepLog)
+    {
+        assert(node->Level >= 2 && stepLog <= node->Level - 2);
+
+        if (!node->Population) { return Empty(node->Level - 1); }
+        if (node->Level == 2) { return BaseSuccessor(node); }
+
+        const bool FullStep{stepLog == node->Level - 2};
+        if (FullStep && node->Result) { return node->Result; }
+        if (!FullStep && node->StepResult && node->StepLog == stepLog)
+        {
+            return node->StepResult;
+        }
+
+        //
+        // Nine overlapping level - 1 squares covering the node.
+        //
+        Node* n00 = node->NW;
+        Node* n01 = Join(node->NW->NE, node->NE->NW, node->NW->SE, node->NE->SW);
+        Node* n02 = node->NE;
+        Node* n10 = Join(node->NW->SW, node->NW->SE, node->SW->NW, node->SW->NE);
+        Node* n11 = Center(node);
+        Node* n12 = Join(node->NE->SW, node->NE->SE, node->SE->NW, node->SE->NE);
+        Node* n20 = node->SW;
+        Node* n21 = Join(node->SW->NE, node->SE->NW, node->SW->SE, node->SE->SW);
+        Node* n22 = node->SE;
+
+        //
+        // At full speed, both halves of the step advance 2^(level - 3)
+        // generations. For slower steps, the first half advances the whole
+        // way and the second half just re-centers.
+        //
+        const uint32_t FirstStepLog{FullStep ? node->Level - 3 : stepLog};
+        Node* r00 = Successor(n00, FirstStepLog);
+        Node* r01 = Successor(n01, FirstStepLog);
+        Node* r02 = Successor(n02, FirstStepLog);
+        Node* r10 = Successor(n10, FirstStepLog);
+        Node* r11 = Successor(n11, FirstStepLog);
+        Node* r12 = Successor(n12, FirstStepLog);
+        Node* r20 = Successor(n20, FirstStepLog);
+        Node* r21 = Successor(n21, FirstStepLog);
+        Node* r22 = Successor(n22, FirstStepLog);
+
+        Node* c00 = Join(r00, r01, r10, r11);
+        Node* c01 = Join(r01, r02, r11, r12);
+        Node* c10 = Join(r10, r11, r20, r21);
+        Node* c11 = Join(r11, r12, r21, r22);
+
+        Node* result;
+        if (FullStep)
+        {
+            result = Join(
+                Successor(c00, FirstStepLog),
+                Successor(c01, FirstStepLog),
+                Successor(c10, FirstStepLog),
+                Successor(c11, FirstStepLog));
+            node->Result = result;
+        }
+        else
+        {
+            result = Join(Center(c00), Center(c01), Center(c10), Center(c11));
+            node->StepResult = result;
+            node->StepLog = stepLog;
+        }
+
+        return result;
+    }
+
+    HashLifeGrid::Node* HashLifeGrid::BaseSuccessor(Node* node)
+    {
+        if (node->Result) { return node->Result; }
+
+        //
+        // Unpack the 4x4 square into a bitmask, bit (4 * row + column).
+        //
+        const Node* Quadrants[4] = { node->NW, node->NE, node->SW, node->SE };
+        uint32_t bits{0};
+        for (uint32_t row = 0; row < 4; ++row)
+        {
+            for (uint32_t column = 0; column < 4; ++column)
+            {
+                const Node* pQuadrant = Quadrants[(row / 2) * 2 + column / 2];
+                const Node* Leaves[4] =
+                    { pQuadrant->NW, pQuadrant->NE, pQuadrant->SW, pQuadrant->SE };
+                const Node* pLeaf = Leaves[(row % 2) * 2 + column % 2];
+                bits |= static_cast<uint32_t>(pLeaf->Population) << (4 * row + column);
+            }
+        }
+
+        Node* next[4];
+        for (uint32_t row = 1; row <= 2; ++row)
+        {
+            for (uint32_t column = 1; column <= 2; ++column)
+            {
+                uint32_t neighborCount{0};
+                for (uint32_t r = row - 1; r <= row + 1; ++r)
+                {
+                    for (uint32_t c = column - 1; c <= column + 1; ++c)
+                    {
+                        if (r == row && c == column) { continue; }
+                        neighborCount += (bits >> (4 * r + c)) & 1;
+                    }
+                }
+
+                const bool Alive{((bits >> (4 * row + column)) & 1) != 0};
+                const bool NextAlive{
+                    neighborCount == 3 || (Alive && neighborCount == 2) };
+                next[(row - 1) * 2 + (column - 1)] =
+                    NextAlive ? m_liveLeaf.get() : m_deadLeaf.get();
+            }
+        }
+
+        node->Result = Join(next[0], next[1], next[2], next[3]);
+        return node->Result;
+    }
+
+    HashLifeGrid::Node* HashLifeGrid::Center(Node* node)
+    {
+        return Join(node->NW->SE, node->NE->SW, node->SW->NE, node->SE->NW);
+    }
+
+    void HashLifeGrid::PrepareRoot(uint32_t stepLog)
+    {
+        //
+        // A pattern confined to the middle quarter of the root can't grow
+        // out of the root's RESULT within 2^(level - 3) generations.
+        //
+        while (m_root->Level < stepLog + 3 ||
+               Center(Center(m_root))->Population != m_root->Population)
+        {
+            if (m_root->Level >= MaxLevel)
+            {
+                throw std::overflow_error(
+                    "Pattern has grown past the 64-bit address space.");
+            }
+
+            Expand();
+        }
+    }
+
+    void HashLifeGrid::Expand()
+    {
+        Node* pEmpty = Empty(m_root->Level - 1);
+        m_root = Join(
+            Join(pEmpty, pEmpty, pEmpty, m_root->NW),
+            Join(pEmpty, pEmpty, m_root->NE, pEmpty),
+            Join(pEmpty, m_root->SW, pEmpty, pEmpty),
+            Join(m_root->SE, pEmpty, pEmpty, pEmpty));
+    }
+
+    HashLifeGrid::Node* HashLifeGrid::AllocateNode()
+    {
+        if (!m_freeList)
+        {
+            std::unique_ptr<Node[]> block(new Node[NodesPerBlock]());
+            for (size_t i = 0; i < NodesPerBlock; ++i)
+            {
+                block[i].Next = m_freeList;
+                m_freeList = &block[i];
+            }
+            m_blocks.push_back(std::move(block));
+        }
+
+        Node* pNode = m_freeList;
+        m_freeList = pNode->Next;
+        pNode->InUse = true;
+        ++m_numNodes;
+        return pNode;
+    }
+
+    void HashLifeGrid::InsertIntoTable(Node* node)
+    {
+        const size_t Hash = HashChildren(node->NW, node->NE, node->SW, node->SE);
+        Node*& bucket = m_buckets[Hash & (m_buckets.size() - 1)];
+        node->Next = bucket;
+        bucket = node;
+    }
+
+    void HashLifeGrid::GrowTable()
+    {
+        std::vector<Node*> oldBuckets(m_buckets.size() * 2, nullptr);
+        oldBuckets.swap(m_buckets);
+        for (Node* pHead : oldBuckets)
+        {
+            while (pHead)
+            {
+                Node* pNext = pHead->Next;
+                InsertIntoTable(pHead);
+                pHead = pNext;
+            }
+        }
+    }
+
+    void HashLifeGrid::CollectGarbage()
+    {
+        Mark(m_root);
+        for (Node* pEmpty : m_emptyNodes) { Mark(pEmpty); }
+
+        //
+        // Sweep unreachable nodes onto the free list.
+        //
+        for (auto& block : m_blocks)
+        {
+            for (size_t i = 0; i < NodesPerBlock; ++i)
+            {
+                Node& node = block[i];
+                if (!node.InUse || node.Marked) { continue; }
+
+                node.InUse = false;
+                node.Next = m_freeList;
+                m_freeList = &node;
+                --m_numNodes;
+            }
+        }
+
+        //
+        // Forget memoized results which were just reclaimed, and rebuild the
+        // hash chains from the survivors.
+        //
+        std::fill(std::begin(m_buckets), std::end(m_buckets), nullptr);
+        for (auto& block : m_blocks)
+        {
+            for (size_t i = 0; i < NodesPerBlock; ++i)
+            {
+                Node& node = block[i];
+                if (!node.InUse) { continue; }
+
+                if (node.Result && node.Result->Level && !node.Result->InUse)
+                {
+                    node.Result = nullptr;
+                }
+                if (node.StepResult && node.StepResult->Level &&
+                    !node.StepResult->InUse)
+                {
+                    node.StepResult = nullptr;
+                }
+
+                node.Marked = false;
+                InsertIntoTable(&node);
+            }
+        }
+
+        //
+        // Leave headroom so collection doesn't immediately run again.
+        //
+        m_nodeLimit = std::max(m_nodeLimit, m_numNodes * 2);
+    }
+
+    void HashLifeGrid::Mark(Node* node)
+    {
+        if (!node->Level || node->Marked) { return; }
+
+        node->Marked = true;
+        Mark(node->NW);
+        Mark(node->NE);
+        Mark(node->SW);
+        Mark(node->SE);
+    }
+}
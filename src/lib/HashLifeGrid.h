@@ -0,0 +1,192 @@
+//
+// HashLife engine for the Game of Life.
+//
+// The plane is represented as a quadtree whose nodes are hash-consed: any two
+// identical squares anywhere in the universe, at any point in time, share a
+// single node. Each node memoizes its RESULT -- the center half of the square
+// advanced 2^(level - 2) generations -- so repeated structure in space and time
+// is only ever computed once, and a single call can jump the universe forward
+// by an arbitrary power of two generations.
+//
+// Unreferenced nodes are reclaimed by a mark-and-sweep pass between steps
+// whenever the node table grows past a limit.
+//
+
+#pragma once
+
+#include "Cell.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace gol
+{
+    class HashLifeGrid
+    {
+    public:
+        //
+        // cellAddresses lists all live cells which describes the initial state.
+        // Throws std::overflow_error if a cell lies outside [-2^62, 2^62) on
+        // either axis.
+        //
+        HashLifeGrid(const std::vector<CellAddress>& cellAddresses);
+        ~HashLifeGrid();
+
+        HashLifeGrid(const HashLifeGrid&) = delete;
+        HashLifeGrid& operator=(const HashLifeGrid&) = delete;
+
+        //
+        // Advance the generation by one single iteration.
+        //
+        void AdvanceGeneration();
+
+        //
+        // Advance by an arbitrary number of generations, in at most one
+        // quadtree step per set bit of numGenerations.
+        //
+        // Both throw std::overflow_error once the pattern has a cell outside
+        // [-2^60, 2^60) on either axis, since a step needs a margin around
+        // the pattern which would not fit in 64-bit addresses. Steps taken
+        // before the throw are kept.
+        //
+        void AdvanceGenerations(uint64_t numGenerations);
+
+        //
+        // Retrieve live cells for testing and output, sorted by address.
+        //
+        std::vector<Cell> GetLiveCells() const;
+
+        //
+        // Calls visitor for every live cell by walking the quadtree, without
+        // materializing the live set. Order is unspecified.
+        //
+        template<typename Visitor>
+        void ForEachLiveCell(Visitor&& visitor) const;
+
+        uint64_t GetGeneration() const { return m_generation; }
+        uint64_t GetPopulation() const;
+        size_t   GetNodeCount() const { return m_numNodes; }
+
+        //
+        // Garbage collection runs between steps once more than this many
+        // nodes are alive.
+        //
+        void SetNodeLimit(size_t nodeLimit) { m_nodeLimit = nodeLimit; }
+
+    private:
+        struct Node
+        {
+            Node*    NW;
+            Node*    NE;
+            Node*    SW;
+            Node*    SE;
+
+            //
+            // Result memoizes the center advanced 2^(Level - 2) generations.
+            // StepResult memoizes a slower step of 2^StepLog generations,
+            // used while the requested jump is smaller than this node's
+            // natural step.
+            //
+            Node*    Result;
+            Node*    StepResult;
+
+            //
+            // Hash chain link while in use, free list link otherwise.
+            //
+            Node*    Next;
+
+            uint64_t Population;
+            uint32_t Level;
+            uint32_t StepLog;
+            bool     InUse;
+            bool     Marked;
+        };
+
+        //
+        // Depth is bounded by the root level, so the recursion stays shallow.
+        //
+        template<typename Visitor>
+        void ForEachLiveCellIn(
+            const Node* pNode,
+            int64_t x0,
+            int64_t y0,
+            Visitor& visitor) const;
+
+        Node* Join(Node* nw, Node* ne, Node* sw, Node* se);
+        Node* Empty(uint32_t level);
+        Node* Build(
+            uint32_t level,
+            int64_t x0,
+            int64_t y0,
+            CellAddress* pBegin,
+            CellAddress* pEnd);
+
+        //
+        // Returns the level - 1 center of node advanced 2^stepLog generations.
+        // Requires stepLog <= level - 2.
+        //
+        Node* Successor(Node* node, uint32_t stepLog);
+        Node* BaseSuccessor(Node* node);
+        Node* Center(Node* node);
+
+        //
+        // Pads the root with empty space until the pattern is guaranteed to
+        // stay inside the root's RESULT for 2^stepLog generations.
+        //
+        void PrepareRoot(uint32_t stepLog);
+        void Expand();
+
+        Node* AllocateNode();
+        void  InsertIntoTable(Node* node);
+        void  GrowTable();
+        void  CollectGarbage();
+        void  Mark(Node* node);
+
+        Node*    m_root = nullptr;
+        uint64_t m_generation = 0;
+
+        //
+        // Hash-consed node table: chained buckets, with nodes carved out of
+        // fixed-size blocks and recycled through a free list.
+        //
+        std::vector<Node*>                   m_buckets;
+        std::vector<std::unique_ptr<Node[]>> m_blocks;
+        Node*                                m_freeList = nullptr;
+        size_t                               m_numNodes = 0;
+        size_t                               m_nodeLimit;
+
+        std::unique_ptr<Node> m_deadLeaf;
+        std::unique_ptr<Node> m_liveLeaf;
+        std::vector<Node*>    m_emptyNodes;
+    };
+
+    template<typename Visitor>
+    void HashLifeGrid::ForEachLiveCell(Visitor&& visitor) const
+    {
+        const int64_t Half{int64_t(1) << (m_root->Level - 1)};
+        ForEachLiveCellIn(m_root, -Half, -Half, visitor);
+    }
+
+    template<typename Visitor>
+    void HashLifeGrid::ForEachLiveCellIn(
+        const Node* pNode,
+        int64_t x0,
+        int64_t y0,
+        Visitor& visitor) const
+    {
+        if (!pNode->Population) { return; }
+        if (!pNode->Level)
+        {
+            visitor(CellAddress(x0, y0));
+            return;
+        }
+
+        const int64_t ChildSize{int64_t(1) << (pNode->Level - 1)};
+        ForEachLiveCellIn(pNode->NW, x0, y0, visitor);
+        ForEachLiveCellIn(pNode->NE, x0 + ChildSize, y0, visitor);
+        ForEachLiveCellIn(pNode->SW, x0, y0 + ChildSize, visitor);
+        ForEachLiveCellIn(pNode->SE, x0 + ChildSize, y0 + ChildSize, visitor);
+    }
+}
@@ -0,0 +1,360 @@
+#include "LifeParser.h"
+#include "MappedFile.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+    //
+    // Below this size, splitting the input isn't worth the thread handoff.
+    //
+    constexpr size_t MinChunkBytes{size_t(1) << 20};
+    constexpr size_t ChunksPerThread{4};
+
+    struct ChunkResult
+    {
+        std::vector<gol::CellAddress> Cells;
+        size_t                        NumLines = 0;
+        bool                          Failed = false;
+        size_t                        ErrorLine = 0;
+        std::string                   ErrorMessage;
+    };
+
+    bool IsBlank(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\r';
+    }
+
+    const char* SkipBlanks(const char* pCursor, const char* pEnd)
+    {
+        while (pCursor != pEnd && IsBlank(*pCursor)) { ++pCursor; }
+        return pCursor;
+    }
+
+    //
+    // Parses whole lines in [pBegin, pEnd). Line numbers are relative to the
+    // start of the chunk.
+    //
+    void ParseChunk(const char* pBegin, const char* pEnd, ChunkResult& result)
+    {
+        const char* pLine = pBegin;
+        while (pLine != pEnd)
+        {
+            const char* pNewline = static_cast<const char*>(
+                std::memchr(pLine, '\n', static_cast<size_t>(pEnd - pLine)));
+            const char* pLineEnd = pNewline ? pNewline : pEnd;
+            ++result.NumLines;
+
+            const char* pCursor = SkipBlanks(pLine, pLineEnd);
+            if (pCursor != pLineEnd && *pCursor != '#')
+            {
+                int64_t x{0};
+                int64_t y{0};
+                const auto XResult = std::from_chars(pCursor, pLineEnd, x);
+                pCursor = SkipBlanks(XResult.ptr, pLineEnd);
+
+                const bool Separated{pCursor != XResult.ptr};
+                const auto YResult = std::from_chars(pCursor, pLineEnd, y);
+                pCursor = SkipBlanks(YResult.ptr, pLineEnd);
+
+                const bool Valid =
+                    XResult.ec == std::errc() &&
+                    Separated &&
+                    YResult.ec == std::errc() &&
+                    pCursor == pLineEnd;
+                if (!Valid)
+                {
+                    result.Failed = true;
+                    result.ErrorLine = result.NumLines;
+                    result.ErrorMessage =
+                        "Expected two integer coordinates, got \"" +
+                        std::string(pLine, pLineEnd) + "\"";
+                    return;
+                }
+
+                result.Cells.emplace_back(x, y);
+            }
+
+            pLine = pNewline ? pNewline + 1 : pEnd;
+        }
+    }
+
+    //
+    // Checks the signature line, returning the start of the body, or null
+    // after filling in error.
+    //
+    const char* CheckSignature(const char* pData, size_t size, gol::LifeParseError& error)
+    {
+        auto Fail = [&error]() -> const char*
+        {
+            error.Line = 1;
+            error.Message = "Invalid GOL format! Expected \"" +
+                            std::string(gol::LifeSignature) + "\" signature.";
+            return nullptr;
+        };
+
+        //
+        // An empty file maps to a null pointer, which memchr mustn't be given
+        // even with a zero size.
+        //
+        if (!size) { return Fail(); }
+
+        const char* pEnd = pData + size;
+        const char* pSignatureEnd = static_cast<const char*>(
+            std::memchr(pData, '\n', size));
+        const char* pBody = pSignatureEnd ? pSignatureEnd + 1 : pEnd;
+        if (!pSignatureEnd) { pSignatureEnd = pEnd; }
+
+        const size_t SignatureLength{std::strlen(gol::LifeSignature)};
+        const char* pTrimmedEnd = pSignatureEnd;
+        while (pTrimmedEnd != pData && IsBlank(pTrimmedEnd[-1])) { --pTrimmedEnd; }
+        const bool SignatureMatches =
+            static_cast<size_t>(pTrimmedEnd - pData) == SignatureLength &&
+            std::equal(pData, pTrimmedEnd, gol::LifeSignature);
+        if (!SignatureMatches) { return Fail(); }
+
+        return pBody;
+    }
+
+    //
+    // Splits [pBody, pEnd) into roughly equal chunks, nudging each boundary
+    // forward to just past the next newline. Returns numChunks + 1 boundaries.
+    //
+    std::vector<const char*> SplitIntoChunks(
+        const char* pBody,
+        const char* pEnd,
+        size_t numChunks)
+    {
+        const size_t BodySize{static_cast<size_t>(pEnd - pBody)};
+        std::vector<const char*> boundaries{pBody};
+        for (size_t i = 1; i < numChunks; ++i)
+        {
+            const char* pTarget = std::max(
+                boundaries.back(),
+                pBody + BodySize * i / numChunks);
+            const char* pNewline = static_cast<const char*>(
+                std::memchr(pTarget, '\n', static_cast<size_t>(pEnd - pTarget)));
+            boundaries.push_back(pNewline ? pNewline + 1 : pEnd);
+        }
+        boundaries.push_back(pEnd);
+
+        return boundaries;
+    }
+}
+
+namespace gol
+{
+    const char* const LifeSignature = "#Life 1.06";
+
+    bool ParseLifeFile(
+        const std::string& path,
+        std::vector<CellAddress>& cells,
+        LifeParseError& error,
+        size_t numThreads)
+    {
+        MappedFile file;
+        if (!file.Open(path, error.Message))
+        {
+            error.Line = 0;
+            return false;
+        }
+
+        return ParseLifeText(file.Data(), file.Size(), cells, error, numThreads);
+    }
+
+    bool ParseLifeText(
+        const char* pData,
+        size_t size,
+        std::vector<CellAddress>& cells,
+        LifeParseError& error,
+        size_t numThreads)
+    {
+        const char* pBody = CheckSignature(pData, size, error);
+        if (!pBody) { return false; }
+
+        const char* pEnd = pData + size;
+        const size_t BodySize{static_cast<size_t>(pEnd - pBody)};
+        const size_t NumThreads{std::max<size_t>(numThreads, 1)};
+        const size_t NumChunks{std::max<size_t>(
+            1,
+            std::min(NumThreads * ChunksPerThread, BodySize / MinChunkBytes))};
+        const auto Boundaries = SplitIntoChunks(pBody, pEnd, NumChunks);
+
+        std::vector<ChunkResult> results(NumChunks);
+        auto ParseOneChunk = [&Boundaries, &results](size_t chunkIndex)
+        {
+            ParseChunk(
+                Boundaries[chunkIndex],
+                Boundaries[chunkIndex + 1],
+                results[chunkIndex]);
+        };
+
+        if (NumChunks > 1 && NumThreads > 1)
+        {
+            ThreadPool pool(NumThreads);
+            pool.ParallelFor(NumChunks, ParseOneChunk);
+        }
+        else
+        {
+            for (size_t i = 0; i < NumChunks; ++i) { ParseOneChunk(i); }
+        }
+
+        //
+        // Report the first malformed line in file order. Line 1 is the
+        // signature.
+        //
+        size_t lineOffset{1};
+        size_t numCells{0};
+        for (const auto& Result : results)
+        {
+            if (Result.Failed)
+            {
+                error.Line = lineOffset + Result.ErrorLine;
+                error.Message = Result.ErrorMessage;
+                return false;
+            }
+
+            lineOffset += Result.NumLines;
+            numCells += Result.Cells.size();
+        }
+
+        cells.reserve(cells.size() + numCells);
+        for (const auto& Result : results)
+        {
+            cells.insert(
+                std::end(cells),
+                std::begin(Result.Cells),
+                std::end(Result.Cells));
+        }
+
+        return true;
+    }
+
+    bool ParseLifeFileInChunks(
+        const std::string& path,
+        const std::function<void(const std::vector<CellAddress>&)>& onChunk,
+        LifeParseError& error,
+        size_t numThreads)
+    {
+        MappedFile file;
+        if (!file.Open(path, error.Message))
+        {
+            error.Line = 0;
+            return false;
+        }
+
+        return ParseLifeTextInChunks(
+            file.Data(),
+            file.Size(),
+            onChunk,
+            error,
+            numThreads);
+    }
+
+    bool ParseLifeTextInChunks(
+        const char* pData,
+        size_t size,
+        const std::function<void(const std::vector<CellAddress>&)>& onChunk,
+        LifeParseError& error,
+        size_t numThreads)
+    {
+        const char* pBody = CheckSignature(pData, size, error);
+        if (!pBody) { return false; }
+
+        //
+        // Chunks are kept small whatever the thread count, so that the first
+        // one is handed over soon.
+        //
+        const char* pEnd = pData + size;
+        const size_t BodySize{static_cast<size_t>(pEnd - pBody)};
+        const size_t NumThreads{std::max<size_t>(numThreads, 1)};
+        const size_t NumChunks{std::max<size_t>(1, BodySize / MinChunkBytes)};
+        const auto Boundaries = SplitIntoChunks(pBody, pEnd, NumChunks);
+
+        //
+        // The parser thread marks chunks ready as they finish, in whatever
+        // order the pool gets to them; this thread hands them over in file
+        // order. Once the consumer gives up, the remaining chunks are skipped.
+        //
+        std::vector<ChunkResult> results(NumChunks);
+        std::vector<bool> ready(NumChunks, false);
+        std::mutex readyMutex;
+        std::condition_variable readyCondition;
+        std::atomic<bool> abandoned{false};
+
+        auto ParseOneChunk = [&](size_t chunkIndex)
+        {
+            if (!abandoned)
+            {
+                ParseChunk(
+                    Boundaries[chunkIndex],
+                    Boundaries[chunkIndex + 1],
+                    results[chunkIndex]);
+            }
+
+            std::lock_guard<std::mutex> lock(readyMutex);
+            ready[chunkIndex] = true;
+            readyCondition.notify_all();
+        };
+
+        std::thread parser([&]()
+        {
+            if (NumChunks > 1 && NumThreads > 1)
+            {
+                ThreadPool pool(NumThreads);
+                pool.ParallelFor(NumChunks, ParseOneChunk);
+            }
+            else
+            {
+                for (size_t i = 0; i < NumChunks; ++i) { ParseOneChunk(i); }
+            }
+        });
+
+        auto StopParser = [&]()
+        {
+            abandoned = true;
+            parser.join();
+        };
+
+        size_t lineOffset{1};
+        for (size_t chunkIndex = 0; chunkIndex < NumChunks; ++chunkIndex)
+        {
+            {
+                std::unique_lock<std::mutex> lock(readyMutex);
+                readyCondition.wait(lock, [&]() { return ready[chunkIndex]; });
+            }
+
+            auto& result = results[chunkIndex];
+            if (result.Failed)
+            {
+                StopParser();
+                error.Line = lineOffset + result.ErrorLine;
+                error.Message = result.ErrorMessage;
+                return false;
+            }
+
+            try
+            {
+                onChunk(result.Cells);
+            }
+            catch (...)
+            {
+                StopParser();
+                throw;
+            }
+
+            lineOffset += result.NumLines;
+            std::vector<CellAddress>().swap(result.Cells);
+        }
+
+        parser.join();
+        return true;
+    }
+}
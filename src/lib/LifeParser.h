@@ -0,0 +1,83 @@
+//
+// Reader for the Life 1.06 format: a "#Life 1.06" signature line followed by
+// one "x y" pair of live cell coordinates per line.
+//
+// Files are memory-mapped, split into chunks at line boundaries and the chunks
+// parsed concurrently with std::from_chars, which is locale-independent and
+// doesn't go through iostreams.
+//
+
+#pragma once
+
+#include "Cell.h"
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace gol
+{
+    extern const char* const LifeSignature;
+
+    struct LifeParseError
+    {
+        //
+        // 1-based line number of the first offending line, or 0 when the
+        // problem isn't tied to a line (e.g. the file couldn't be opened).
+        //
+        size_t      Line = 0;
+        std::string Message;
+    };
+
+    //
+    // Parse a Life 1.06 file, appending its cells to `cells`. Blank lines and
+    // lines starting with '#' after the signature are skipped.
+    //
+    // Returns false and fills in error if the file can't be read or any line
+    // is malformed; cells is left untouched in that case.
+    //
+    bool ParseLifeFile(
+        const std::string& path,
+        std::vector<CellAddress>& cells,
+        LifeParseError& error,
+        size_t numThreads = 1);
+
+    //
+    // As above, for Life 1.06 text already in memory.
+    //
+    bool ParseLifeText(
+        const char* pData,
+        size_t size,
+        std::vector<CellAddress>& cells,
+        LifeParseError& error,
+        size_t numThreads = 1);
+
+    //
+    // Parses a Life 1.06 file like ParseLifeFile, but without waiting for
+    // the whole file. The file is split into chunks, which are parsed on
+    // background threads. onChunk receives each chunk's cells on the calling
+    // thread, in file order, once that chunk is parsed. The caller can
+    // consume one chunk, e.g. insert it into a grid, while later ones are
+    // still being parsed.
+    //
+    // Returns false and fills in error if the file can't be read or a line
+    // is malformed. Chunks before the malformed line may already have been
+    // handed over by then.
+    //
+    bool ParseLifeFileInChunks(
+        const std::string& path,
+        const std::function<void(const std::vector<CellAddress>&)>& onChunk,
+        LifeParseError& error,
+        size_t numThreads = 1);
+
+    //
+    // As above, for Life 1.06 text already in memory.
+    //
+    bool ParseLifeTextInChunks(
+        const char* pData,
+        size_t size,
+        const std::function<void(const std::vector<CellAddress>&)>& onChunk,
+        LifeParseError& error,
+        size_t numThreads = 1);
+}
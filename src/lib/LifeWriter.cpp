@@ -0,0 +1,76 @@
+#include "LifeWriter.h"
+#include "LifeParser.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+namespace
+{
+    //
+    // Newline, two 20-character int64 values and a separator.
+    //
+    constexpr size_t MaxCellBytes{1 + 20 + 1 + 20};
+}
+
+namespace gol
+{
+    LifeWriter::LifeWriter(std::FILE* pFile, size_t bufferSize)
+        : m_pFile(pFile),
+          m_buffer(std::max(bufferSize, MaxCellBytes))
+    {
+    }
+
+    LifeWriter::~LifeWriter()
+    {
+        Flush();
+    }
+
+    void LifeWriter::WriteSignature()
+    {
+        const size_t Length{std::strlen(LifeSignature)};
+        MakeRoom(Length + 1);
+        std::memcpy(m_buffer.data() + m_used, LifeSignature, Length);
+        m_used += Length;
+        m_buffer[m_used++] = '\n';
+    }
+
+    void LifeWriter::WriteCell(const CellAddress& address)
+    {
+        MakeRoom(MaxCellBytes);
+
+        char* pCursor = m_buffer.data() + m_used;
+        char* pEnd = m_buffer.data() + m_buffer.size();
+        if (!m_firstCell) { *pCursor++ = '\n'; }
+        m_firstCell = false;
+
+        pCursor = std::to_chars(pCursor, pEnd, address.first).ptr;
+        *pCursor++ = ' ';
+        pCursor = std::to_chars(pCursor, pEnd, address.second).ptr;
+
+        m_used = static_cast<size_t>(pCursor - m_buffer.data());
+    }
+
+    bool LifeWriter::Flush()
+    {
+        if (m_used)
+        {
+            const size_t Written{std::fwrite(m_buffer.data(), 1, m_used, m_pFile)};
+            m_good = m_good && Written == m_used;
+            m_used = 0;
+        }
+
+        m_good = m_good && std::fflush(m_pFile) == 0;
+        return m_good;
+    }
+
+    void LifeWriter::MakeRoom(size_t numBytes)
+    {
+        if (m_buffer.size() - m_used < numBytes)
+        {
+            const size_t Written{std::fwrite(m_buffer.data(), 1, m_used, m_pFile)};
+            m_good = m_good && Written == m_used;
+            m_used = 0;
+        }
+    }
+}
@@ -0,0 +1,57 @@
+//
+// Buffered writer for the Life 1.06 format.
+//
+// Coordinates are formatted with std::to_chars straight into a large buffer
+// which is handed to the C runtime in big blocks, so writing millions of cells
+// costs a handful of write calls rather than several stream operations each.
+//
+
+#pragma once
+
+#include "Cell.h"
+
+#include <cstddef>
+#include <cstdio>
+#include <vector>
+
+namespace gol
+{
+    class LifeWriter
+    {
+    public:
+        static constexpr size_t DefaultBufferSize{size_t(1) << 20};
+
+        explicit LifeWriter(std::FILE* pFile, size_t bufferSize = DefaultBufferSize);
+
+        //
+        // Flushes whatever is still buffered.
+        //
+        ~LifeWriter();
+
+        LifeWriter(const LifeWriter&) = delete;
+        LifeWriter& operator=(const LifeWriter&) = delete;
+
+        void WriteSignature();
+
+        //
+        // Cells are newline-separated; there is no newline after the last
+        // one.
+        //
+        void WriteCell(const CellAddress& address);
+
+        //
+        // Returns false if any write so far has failed.
+        //
+        bool Flush();
+        bool Good() const noexcept { return m_good; }
+
+    private:
+        void MakeRoom(size_t numBytes);
+
+        std::FILE*        m_pFile;
+        std::vector<char> m_buffer;
+        size_t            m_used = 0;
+        bool              m_firstCell = true;
+        bool              m_good = true;
+    };
+}
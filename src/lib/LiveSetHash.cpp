@@ -0,0 +1,176 @@
+#include "LiveSetHash.h"
+
+#include <cstddef>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace
+{
+    constexpr uint64_t Prime{(uint64_t(1) << 61) - 1};
+
+    //
+    // Arbitrary bases; anything other than 0 and 1 works.
+    //
+    constexpr uint64_t BaseX{0x0A3B195B7D4F2C61ull};
+    constexpr uint64_t BaseY{0x1C4E6F80927A3B15ull};
+
+    uint64_t MulMod(uint64_t a, uint64_t b)
+    {
+#if defined(_MSC_VER) && !defined(__clang__)
+        uint64_t high;
+        const uint64_t Low{_umul128(a, b, &high)};
+#else
+        const unsigned __int128 Product{static_cast<unsigned __int128>(a) * b};
+        const uint64_t Low{static_cast<uint64_t>(Product)};
+        uint64_t high{static_cast<uint64_t>(Product >> 64)};
+#endif
+        //
+        // 2^64 is 8 modulo the prime, and both inputs are below 2^61, so
+        // the high word folds in with a shift.
+        //
+        uint64_t result = (Low & Prime) + (Low >> 61) + (high << 3);
+        result = (result & Prime) + (result >> 61);
+        return result >= Prime ? result - Prime : result;
+    }
+
+    uint64_t AddMod(uint64_t a, uint64_t b)
+    {
+        const uint64_t Sum{a + b};
+        return Sum >= Prime ? Sum - Prime : Sum;
+    }
+
+    uint64_t PowMod(uint64_t base, uint64_t exponent)
+    {
+        uint64_t result{1};
+        for (; exponent; exponent >>= 1)
+        {
+            if (exponent & 1) { result = MulMod(result, base); }
+            base = MulMod(base, base);
+        }
+        return result;
+    }
+
+    //
+    // Powers of a base for every byte of a 64-bit exponent, so that raising
+    // the base to any coordinate takes eight lookups rather than sixty-odd
+    // squarings.
+    //
+    struct PowerTable
+    {
+        explicit PowerTable(uint64_t base)
+        {
+            uint64_t bytePower{base};
+            for (size_t byteIndex = 0; byteIndex < 8; ++byteIndex)
+            {
+                uint64_t power{1};
+                for (size_t value = 0; value < 256; ++value)
+                {
+                    Powers[byteIndex][value] = power;
+                    power = MulMod(power, bytePower);
+                }
+                bytePower = power;
+            }
+
+            //
+            // A negative coordinate reads as its value plus 2^64, so that
+            // much has to be divided back out. bytePower is now base^(2^64);
+            // Fermat's little theorem gives its inverse.
+            //
+            NegativeCorrection = PowMod(bytePower, Prime - 2);
+        }
+
+        uint64_t Power(int64_t exponent) const
+        {
+            const uint64_t Bits{static_cast<uint64_t>(exponent)};
+            uint64_t result = exponent < 0 ? NegativeCorrection : 1;
+            for (size_t byteIndex = 0; byteIndex < 8; ++byteIndex)
+            {
+                result = MulMod(
+                    result,
+                    Powers[byteIndex][(Bits >> (8 * byteIndex)) & 0xFF]);
+            }
+            return result;
+        }
+
+        uint64_t Powers[8][256];
+        uint64_t NegativeCorrection;
+    };
+
+    uint64_t Term(int64_t x, int64_t y)
+    {
+        static const PowerTable TableX(BaseX % Prime);
+        static const PowerTable TableY(BaseY % Prime);
+        return MulMod(TableX.Power(x), TableY.Power(y));
+    }
+}
+
+namespace gol
+{
+    void LiveSetSummary::Add(const CellAddress& address)
+    {
+        ++Population;
+        SumX += static_cast<uint64_t>(address.first);
+        SumY += static_cast<uint64_t>(address.second);
+        Hash = AddMod(Hash, Term(address.first, address.second));
+    }
+
+    void LiveSetSummary::Remove(const CellAddress& address)
+    {
+        --Population;
+        SumX -= static_cast<uint64_t>(address.first);
+        SumY -= static_cast<uint64_t>(address.second);
+        Hash = AddMod(Hash, Prime - Term(address.first, address.second));
+    }
+
+    void LiveSetSummary::Merge(const LiveSetSummary& other)
+    {
+        Population += other.Population;
+        SumX += other.SumX;
+        SumY += other.SumY;
+        Hash = AddMod(Hash, other.Hash);
+    }
+
+    void LiveSetSummary::Subtract(const LiveSetSummary& other)
+    {
+        Population -= other.Population;
+        SumX -= other.SumX;
+        SumY -= other.SumY;
+        Hash = AddMod(Hash, Prime - other.Hash);
+    }
+
+    bool MatchesTranslated(
+        const LiveSetSummary& from,
+        const LiveSetSummary& to,
+        CellAddress& offset)
+    {
+        if (from.Population != to.Population) { return false; }
+        if (!from.Population)
+        {
+            offset = CellAddress(0, 0);
+            return true;
+        }
+
+        //
+        // Shifting every cell by (dx, dy) moves the sums by exactly
+        // population * (dx, dy).
+        //
+        const int64_t Population{static_cast<int64_t>(from.Population)};
+        const int64_t DeltaX{static_cast<int64_t>(to.SumX - from.SumX)};
+        const int64_t DeltaY{static_cast<int64_t>(to.SumY - from.SumY)};
+        if (Population < 0 || DeltaX % Population || DeltaY % Population)
+        {
+            return false;
+        }
+
+        const CellAddress Candidate(DeltaX / Population, DeltaY / Population);
+        if (MulMod(from.Hash, Term(Candidate.first, Candidate.second)) != to.Hash)
+        {
+            return false;
+        }
+
+        offset = Candidate;
+        return true;
+    }
+}
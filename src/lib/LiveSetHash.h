@@ -0,0 +1,46 @@
+//
+// Translation-aware fingerprint of a set of live cells, for spotting repeats.
+//
+// The hash of a set is the sum over its cells of A^x * B^y modulo the
+// Mersenne prime 2^61 - 1. Adding or removing a cell adds or subtracts one
+// term, so the hash is cheap to maintain as cells change, and shifting every
+// cell by (dx, dy) multiplies the hash by A^dx * B^dy. Alongside the hash the
+// population and coordinate sums are kept, which pin down the only shift that
+// could possibly map one set onto another.
+//
+
+#pragma once
+
+#include "Cell.h"
+
+#include <cstdint>
+
+namespace gol
+{
+    struct LiveSetSummary
+    {
+        uint64_t Population = 0;
+
+        //
+        // Coordinate sums wrap modulo 2^64; only their differences matter.
+        //
+        uint64_t SumX = 0;
+        uint64_t SumY = 0;
+        uint64_t Hash = 0;
+
+        void Add(const CellAddress& address);
+        void Remove(const CellAddress& address);
+        void Merge(const LiveSetSummary& other);
+        void Subtract(const LiveSetSummary& other);
+    };
+
+    //
+    // Returns true if `to` may be `from` shifted by some offset, which is
+    // stored in offset. Sets which compare equal here are identical up to
+    // translation with overwhelming probability, but not certainty.
+    //
+    bool MatchesTranslated(
+        const LiveSetSummary& from,
+        const LiveSetSummary& to,
+        CellAddress& offset);
+}
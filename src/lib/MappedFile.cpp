@@ -0,0 +1,97 @@
+#include "MappedFile.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace gol
+{
+    MappedFile::~MappedFile()
+    {
+        Close();
+    }
+
+    bool MappedFile::Open(const std::string& path, std::string& error)
+    {
+        Close();
+
+#if !defined(_WIN32)
+        const int Fd = ::open(path.c_str(), O_RDONLY);
+        if (Fd < 0)
+        {
+            error = "Could not open " + path + ": " + std::strerror(errno);
+            return false;
+        }
+
+        struct stat fileStat;
+        if (::fstat(Fd, &fileStat) != 0)
+        {
+            error = "Could not stat " + path + ": " + std::strerror(errno);
+            ::close(Fd);
+            return false;
+        }
+
+        m_size = static_cast<size_t>(fileStat.st_size);
+        if (m_size)
+        {
+            void* pMapping = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, Fd, 0);
+            if (pMapping == MAP_FAILED)
+            {
+                error = "Could not map " + path + ": " + std::strerror(errno);
+                ::close(Fd);
+                m_size = 0;
+                return false;
+            }
+
+            //
+            // Readers walk the file front to back.
+            //
+            ::madvise(pMapping, m_size, MADV_SEQUENTIAL);
+            m_pData = static_cast<const char*>(pMapping);
+            m_mapped = true;
+        }
+
+        //
+        // The mapping outlives the descriptor.
+        //
+        ::close(Fd);
+        return true;
+#else
+        std::ifstream in(path, std::ios::binary);
+        if (!in)
+        {
+            error = "Could not open " + path;
+            return false;
+        }
+
+        m_buffer.assign(
+            std::istreambuf_iterator<char>(in),
+            std::istreambuf_iterator<char>());
+        m_pData = m_buffer.data();
+        m_size = m_buffer.size();
+        return true;
+#endif
+    }
+
+    void MappedFile::Close()
+    {
+#if !defined(_WIN32)
+        if (m_mapped)
+        {
+            ::munmap(const_cast<char*>(m_pData), m_size);
+        }
+#endif
+        m_buffer.clear();
+        m_pData = nullptr;
+        m_size = 0;
+        m_mapped = false;
+    }
+}
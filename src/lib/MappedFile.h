@@ -0,0 +1,38 @@
+//
+// Read-only view of a whole file. Memory-mapped on POSIX systems; elsewhere
+// the file is simply read into a buffer.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace gol
+{
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        //
+        // Returns false and fills in error on failure.
+        //
+        bool Open(const std::string& path, std::string& error);
+        void Close();
+
+        const char* Data() const noexcept { return m_pData; }
+        size_t      Size() const noexcept { return m_size; }
+
+    private:
+        const char*       m_pData = nullptr;
+        size_t            m_size = 0;
+        bool              m_mapped = false;
+        std::vector<char> m_buffer;
+    };
+}
@@ -0,0 +1,121 @@
+#include "Rule.h"
+
+#include <algorithm>
+#include <cctype>
+
+namespace
+{
+    struct NamedRule
+    {
+        const char* pName;
+        gol::Rule   Rule;
+    };
+
+    const NamedRule NamedRules[] = {
+        { "life",     gol::ConwayRule },
+        { "highlife", gol::HighLifeRule },
+        { "seeds",    gol::SeedsRule },
+        { "daynight", gol::DayAndNightRule },
+    };
+
+    //
+    // Reads neighbor counts up to the next '/' or the end of the text.
+    //
+    bool ParseCounts(
+        const std::string& text,
+        size_t& position,
+        uint16_t& counts)
+    {
+        counts = 0;
+        for (; position < text.size() && text[position] != '/'; ++position)
+        {
+            const char Digit{text[position]};
+            if (Digit < '0' || Digit > '8') { return false; }
+            counts |= uint16_t(1) << (Digit - '0');
+        }
+
+        return true;
+    }
+}
+
+namespace gol
+{
+    bool ParseRule(const std::string& text, Rule& rule, std::string& error)
+    {
+        std::string lowered(text);
+        std::transform(
+            std::begin(lowered),
+            std::end(lowered),
+            std::begin(lowered),
+            [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+        for (const auto& Named : NamedRules)
+        {
+            if (lowered == Named.pName)
+            {
+                rule = Named.Rule;
+                return true;
+            }
+        }
+
+        Rule parsed;
+        bool seenBirth{false};
+        bool seenSurvival{false};
+        size_t position{0};
+        for (size_t part = 0; part < 2; ++part)
+        {
+            if (part == 1)
+            {
+                if (position >= lowered.size() || lowered[position] != '/')
+                {
+                    error = "Expected B<digits>/S<digits>: " + text;
+                    return false;
+                }
+                ++position;
+            }
+
+            const char Kind = position < lowered.size() ? lowered[position++] : '\0';
+            bool& seen = Kind == 'b' ? seenBirth : seenSurvival;
+            uint16_t& counts = Kind == 'b' ? parsed.Birth : parsed.Survival;
+            if ((Kind != 'b' && Kind != 's') || seen ||
+                !ParseCounts(lowered, position, counts))
+            {
+                error = "Expected B<digits>/S<digits>: " + text;
+                return false;
+            }
+            seen = true;
+        }
+
+        if (position != lowered.size())
+        {
+            error = "Expected B<digits>/S<digits>: " + text;
+            return false;
+        }
+
+        if (parsed.Birth & 1)
+        {
+            error = "Rules with B0 aren't supported: " + text;
+            return false;
+        }
+
+        rule = parsed;
+        return true;
+    }
+
+    std::string ToString(const Rule& rule)
+    {
+        std::string text{"B"};
+        for (int count = 0; count <= 8; ++count)
+        {
+            if (rule.Birth & (1 << count)) { text += static_cast<char>('0' + count); }
+        }
+
+        text += "/S";
+        for (int count = 0; count <= 8; ++count)
+        {
+            if (rule.Survival & (1 << count)) { text += static_cast<char>('0' + count); }
+        }
+
+        return text;
+    }
+}
@@ -0,0 +1,62 @@
+//
+// Life-like cellular automaton rules in B/S notation: "B36/S23" means a dead
+// cell with 3 or 6 live neighbors is born, and a live cell with 2 or 3 live
+// neighbors survives. Conway's Game of Life is B3/S23.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace gol
+{
+    struct Rule
+    {
+        //
+        // Bit n is set if n live neighbors cause a birth or allow survival.
+        //
+        uint16_t Birth = 0;
+        uint16_t Survival = 0;
+
+        //
+        // Next states for every Cell::LookupKey(), one bit each: births in the
+        // low half, survivals in the high half.
+        //
+        constexpr uint32_t Transitions() const
+        {
+            return uint32_t(Birth) | (uint32_t(Survival) << 16);
+        }
+
+        constexpr bool operator==(const Rule& other) const
+        {
+            return Birth == other.Birth && Survival == other.Survival;
+        }
+        constexpr bool operator!=(const Rule& other) const
+        {
+            return !(*this == other);
+        }
+    };
+
+    constexpr Rule ConwayRule{1 << 3, (1 << 2) | (1 << 3)};
+    constexpr Rule HighLifeRule{(1 << 3) | (1 << 6), (1 << 2) | (1 << 3)};
+    constexpr Rule SeedsRule{1 << 2, 0};
+    constexpr Rule DayAndNightRule{
+        (1 << 3) | (1 << 6) | (1 << 7) | (1 << 8),
+        (1 << 3) | (1 << 4) | (1 << 6) | (1 << 7) | (1 << 8)};
+
+    //
+    // Accepts B/S notation in either order and any case ("B36/S23",
+    // "s23/b36"), or one of the names life, highlife, seeds and daynight.
+    // Rules with B0 are rejected: they would bring the whole empty plane to
+    // life.
+    //
+    // Returns false and fills in error if the text isn't a supported rule.
+    //
+    bool ParseRule(const std::string& text, Rule& rule, std::string& error);
+
+    //
+    // Canonical B/S notation, e.g. "B36/S23".
+    //
+    std::string ToString(const Rule& rule);
+}
@@ -0,0 +1,134 @@
+#include "ShardTransport.h"
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#if !defined(_WIN32)
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+#if !defined(_WIN32)
+    //
+    // A peer which has exited must show up as an error, not kill the process
+    // with SIGPIPE.
+    //
+#if defined(MSG_NOSIGNAL)
+    constexpr int SendFlags{MSG_NOSIGNAL};
+#else
+    constexpr int SendFlags{0};
+#endif
+
+    class SocketChannel : public gol::ShardChannel
+    {
+    public:
+        explicit SocketChannel(int fd)
+            : m_fd(fd) {}
+
+        ~SocketChannel() override { ::close(m_fd); }
+
+        SocketChannel(const SocketChannel&) = delete;
+        SocketChannel& operator=(const SocketChannel&) = delete;
+
+        void Send(const std::vector<char>& message) override
+        {
+            //
+            // An 8-byte little-endian length, then the message itself.
+            //
+            char header[sizeof(uint64_t)];
+            const uint64_t Size{message.size()};
+            for (size_t i = 0; i < sizeof(header); ++i)
+            {
+                header[i] = static_cast<char>(Size >> (8 * i));
+            }
+
+            SendAll(header, sizeof(header));
+            SendAll(message.data(), message.size());
+        }
+
+        void Receive(std::vector<char>& message) override
+        {
+            char header[sizeof(uint64_t)];
+            ReceiveAll(header, sizeof(header));
+
+            uint64_t size{0};
+            for (size_t i = 0; i < sizeof(header); ++i)
+            {
+                size |= uint64_t(static_cast<uint8_t>(header[i])) << (8 * i);
+            }
+
+            message.resize(static_cast<size_t>(size));
+            ReceiveAll(message.data(), message.size());
+        }
+
+    private:
+        void SendAll(const char* pData, size_t size)
+        {
+            while (size)
+            {
+                const ssize_t Sent{::send(m_fd, pData, size, SendFlags)};
+                if (Sent < 0)
+                {
+                    if (errno == EINTR) { continue; }
+                    throw std::runtime_error(
+                        std::string("Could not send to a shard: ") + std::strerror(errno));
+                }
+
+                pData += Sent;
+                size -= static_cast<size_t>(Sent);
+            }
+        }
+
+        void ReceiveAll(char* pData, size_t size)
+        {
+            while (size)
+            {
+                const ssize_t Received{::recv(m_fd, pData, size, 0)};
+                if (Received < 0)
+                {
+                    if (errno == EINTR) { continue; }
+                    throw std::runtime_error(
+                        std::string("Could not receive from a shard: ") + std::strerror(errno));
+                }
+
+                if (Received == 0)
+                {
+                    throw std::runtime_error("A shard closed its channel.");
+                }
+
+                pData += Received;
+                size -= static_cast<size_t>(Received);
+            }
+        }
+
+        int m_fd;
+    };
+#endif
+}
+
+namespace gol
+{
+    ShardChannelPair CreateSocketChannelPair()
+    {
+#if !defined(_WIN32)
+        int fds[2];
+        if (::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0)
+        {
+            throw std::runtime_error(
+                std::string("Could not create a socket pair: ") + std::strerror(errno));
+        }
+
+        return ShardChannelPair(
+            std::make_unique<SocketChannel>(fds[0]),
+            std::make_unique<SocketChannel>(fds[1]));
+#else
+        throw std::runtime_error("Socket channels aren't supported on this platform.");
+#endif
+    }
+}
@@ -0,0 +1,44 @@
+//
+// Message channels between the processes of a sharded run (see Sharded.h).
+//
+// A channel carries whole messages, each an arbitrary run of bytes, in order
+// and in both directions. Both ends of a pair are created up front by the
+// coordinator and handed out across fork(), so a transport has to be
+// something a child process inherits: the first one is a Unix domain socket
+// pair. Others (shared memory rings, TCP between machines) only need to
+// provide the same two calls.
+//
+
+#pragma once
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace gol
+{
+    class ShardChannel
+    {
+    public:
+        virtual ~ShardChannel() = default;
+
+        //
+        // Send blocks until the whole message has been handed over, and
+        // Receive until a whole message has arrived, replacing message's
+        // contents. Both throw std::runtime_error if the other end has gone
+        // away or the transport fails.
+        //
+        virtual void Send(const std::vector<char>& message) = 0;
+        virtual void Receive(std::vector<char>& message) = 0;
+    };
+
+    using ShardChannelPair =
+        std::pair<std::unique_ptr<ShardChannel>, std::unique_ptr<ShardChannel>>;
+
+    //
+    // Two connected ends of a Unix domain stream socket. Messages are framed
+    // with their length. Throws std::runtime_error if the sockets can't be
+    // created, or where they aren't available.
+    //
+    ShardChannelPair CreateSocketChannelPair();
+}
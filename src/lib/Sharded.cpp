@@ -0,0 +1,787 @@
+#include "Sharded.h"
+#include "CellEncoding.h"
+#include "GOLGrid.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#if !defined(_WIN32)
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#if !defined(_WIN32)
+namespace
+{
+    using gol::CellAddress;
+    using gol::ShardChannel;
+
+    constexpr int64_t MinCoordinate{std::numeric_limits<int64_t>::min()};
+    constexpr int64_t MaxCoordinate{std::numeric_limits<int64_t>::max()};
+
+    //
+    // Workers send the coordinator at most this many samples of where their
+    // cells lie.
+    //
+    constexpr size_t MaxSamples{256};
+
+    //
+    // The strips are redrawn once the busiest worker carries more than 5/4
+    // of the average.
+    //
+    constexpr uint64_t ImbalanceNumerator{5};
+    constexpr uint64_t ImbalanceDenominator{4};
+
+    //
+    // Every message from the coordinator to a worker starts with one of
+    // these. The worker answers Strip with the cells it gives up, Run with a
+    // report of its load, and Finish with its live cells; Cells gets no
+    // answer.
+    //
+    enum class Command : char
+    {
+        Strip,
+        Cells,
+        Run,
+        Finish
+    };
+
+    //
+    // Every message from a worker to the coordinator starts with one of
+    // these. A worker which fails sends Failed followed by the reason, or
+    // NeighborLost followed by the neighbor's index when its link to that
+    // neighbor broke, which most likely means the neighbor failed first.
+    // Either way it then exits.
+    //
+    enum class Reply : char
+    {
+        Ok,
+        Failed,
+        NeighborLost
+    };
+
+    struct NeighborLost : std::runtime_error
+    {
+        NeighborLost(size_t neighbor, const std::string& what)
+            : std::runtime_error(what),
+              Neighbor(neighbor) {}
+
+        size_t Neighbor;
+    };
+
+    void PutSigned(std::vector<char>& out, int64_t value)
+    {
+        gol::PutVarint(out, gol::ZigZag(static_cast<uint64_t>(value)));
+    }
+
+    void PutCells(std::vector<char>& out, const std::vector<CellAddress>& cells)
+    {
+        gol::PutVarint(out, cells.size());
+        gol::PutSortedAddresses(out, cells);
+    }
+
+    //
+    // Reads fields back out of a message, throwing if it runs short.
+    //
+    class MessageReader
+    {
+    public:
+        explicit MessageReader(const std::vector<char>& message)
+            : m_pCursor(message.data()),
+              m_pEnd(message.data() + message.size()) {}
+
+        uint64_t GetUnsigned()
+        {
+            uint64_t value{0};
+            Check(m_pCursor = gol::GetVarint(m_pCursor, m_pEnd, value));
+            return value;
+        }
+
+        int64_t GetSigned()
+        {
+            return static_cast<int64_t>(gol::UnZigZag(GetUnsigned()));
+        }
+
+        std::vector<CellAddress> GetCells()
+        {
+            const uint64_t NumCells{GetUnsigned()};
+            std::vector<CellAddress> cells;
+            cells.reserve(static_cast<size_t>(std::min<uint64_t>(
+                NumCells,
+                static_cast<uint64_t>(m_pEnd - m_pCursor))));
+            Check(m_pCursor = gol::GetSortedAddresses(m_pCursor, m_pEnd, NumCells, cells));
+            Check(cells.size() == NumCells);
+            return cells;
+        }
+
+    private:
+        static void Check(bool ok)
+        {
+            if (!ok) { throw std::runtime_error("Malformed message between shards."); }
+        }
+
+        const char* m_pCursor;
+        const char* m_pEnd;
+    };
+
+    std::vector<CellAddress> CellsInColumns(
+        const gol::GOLGrid& grid,
+        int64_t minX,
+        int64_t maxX)
+    {
+        return grid.GetLiveCellsInRect(
+            CellAddress(minX, MinCoordinate),
+            CellAddress(maxX, MaxCoordinate));
+    }
+
+    //
+    // One worker process: owns the cells in columns [m_minX, m_maxX], plus
+    // the halo columns on either side when it has neighbors there.
+    //
+    class ShardWorker
+    {
+    public:
+        ShardWorker(
+            const gol::ShardedSettings& settings,
+            size_t index,
+            ShardChannel& coordinator,
+            ShardChannel* pLeft,
+            ShardChannel* pRight)
+            : m_grid(std::vector<CellAddress>(), settings.NumThreads),
+              m_index(index),
+              m_coordinator(coordinator),
+              m_pLeft(pLeft),
+              m_pRight(pRight)
+        {
+            m_grid.SetRule(settings.Rule);
+        }
+
+        //
+        // Carries out commands until told to finish.
+        //
+        void Serve()
+        {
+            std::vector<char> message;
+            for (;;)
+            {
+                m_coordinator.Receive(message);
+                if (message.empty())
+                {
+                    throw std::runtime_error("Empty message from the coordinator.");
+                }
+
+                const Command Received{static_cast<Command>(message[0])};
+                message.erase(std::begin(message));
+                MessageReader reader(message);
+
+                std::vector<char> reply{static_cast<char>(Reply::Ok)};
+                switch (Received)
+                {
+                case Command::Strip:
+                {
+                    const int64_t MinX{reader.GetSigned()};
+                    const int64_t MaxX{reader.GetSigned()};
+                    PutCells(reply, SetStrip(MinX, MaxX));
+                    m_coordinator.Send(reply);
+                    break;
+                }
+                case Command::Cells:
+                {
+                    const auto Cells = reader.GetCells();
+                    m_grid.InsertLiveCells(std::begin(Cells), std::end(Cells));
+                    ExchangeHalos();
+                    break;
+                }
+                case Command::Run:
+                {
+                    const uint64_t NumGenerations{reader.GetUnsigned()};
+                    for (uint64_t i = 0; i < NumGenerations; ++i)
+                    {
+                        m_grid.AdvanceGeneration();
+                        ExchangeHalos();
+                    }
+                    Report(reply);
+                    m_coordinator.Send(reply);
+                    break;
+                }
+                case Command::Finish:
+                    PutCells(reply, CellsInColumns(m_grid, m_minX, m_maxX));
+                    m_coordinator.Send(reply);
+                    return;
+                default:
+                    throw std::runtime_error("Unknown command from the coordinator.");
+                }
+            }
+        }
+
+    private:
+        //
+        // Drops the halos, and hands back the owned cells which fall outside
+        // the new strip.
+        //
+        std::vector<CellAddress> SetStrip(int64_t minX, int64_t maxX)
+        {
+            std::vector<CellAddress> outgoing;
+            if (minX > m_minX)
+            {
+                outgoing = CellsInColumns(m_grid, m_minX, std::min(minX - 1, m_maxX));
+            }
+            if (maxX < m_maxX)
+            {
+                const auto Right = CellsInColumns(m_grid, std::max(maxX + 1, m_minX), m_maxX);
+                outgoing.insert(std::end(outgoing), std::begin(Right), std::end(Right));
+            }
+
+            const int64_t KeepMinX{std::max(minX, m_minX)};
+            const int64_t KeepMaxX{std::min(maxX, m_maxX)};
+            std::vector<CellAddress> removals;
+            if (KeepMinX > MinCoordinate)
+            {
+                removals = CellsInColumns(m_grid, MinCoordinate, KeepMinX - 1);
+            }
+            if (KeepMaxX < MaxCoordinate)
+            {
+                const auto Right = CellsInColumns(m_grid, KeepMaxX + 1, MaxCoordinate);
+                removals.insert(std::end(removals), std::begin(Right), std::end(Right));
+            }
+            if (!removals.empty())
+            {
+                m_grid.RemoveLiveCells(std::begin(removals), std::end(removals));
+            }
+
+            m_minX = minX;
+            m_maxX = maxX;
+            return outgoing;
+        }
+
+        //
+        // Links between neighbors are taken in two phases, those to the right
+        // of even workers and then those to the right of odd ones. On each
+        // link the left worker sends first and the right one receives first,
+        // so no two processes wait on each other.
+        //
+        void ExchangeHalos()
+        {
+            std::vector<char> leftEdge;
+            std::vector<char> rightEdge;
+            if (m_pLeft) { PutCells(leftEdge, CellsInColumns(m_grid, m_minX, m_minX)); }
+            if (m_pRight) { PutCells(rightEdge, CellsInColumns(m_grid, m_maxX, m_maxX)); }
+
+            std::vector<char> fromLeft;
+            std::vector<char> fromRight;
+            size_t neighbor{m_index};
+            try
+            {
+                for (size_t phase = 0; phase < 2; ++phase)
+                {
+                    if (m_pRight && m_index % 2 == phase)
+                    {
+                        neighbor = m_index + 1;
+                        m_pRight->Send(rightEdge);
+                        m_pRight->Receive(fromRight);
+                    }
+                    if (m_pLeft && m_index % 2 != phase)
+                    {
+                        neighbor = m_index - 1;
+                        m_pLeft->Receive(fromLeft);
+                        m_pLeft->Send(leftEdge);
+                    }
+                }
+            }
+            catch (std::runtime_error& e)
+            {
+                throw NeighborLost(neighbor, e.what());
+            }
+
+            //
+            // The halo columns have stepped without their outer neighbors, so
+            // they're replaced, and anything they brought to life in the
+            // column beyond is killed.
+            //
+            std::vector<CellAddress> births;
+            std::vector<CellAddress> deaths;
+            auto RefreshHalo = [&](const std::vector<char>& edge, int64_t haloX, bool hasStrayColumn, int64_t strayX)
+            {
+                const auto Received = MessageReader(edge).GetCells();
+                const auto Current = CellsInColumns(m_grid, haloX, haloX);
+                std::set_difference(
+                    std::begin(Received), std::end(Received),
+                    std::begin(Current), std::end(Current),
+                    std::back_inserter(births));
+                std::set_difference(
+                    std::begin(Current), std::end(Current),
+                    std::begin(Received), std::end(Received),
+                    std::back_inserter(deaths));
+
+                if (hasStrayColumn)
+                {
+                    const auto Strays = CellsInColumns(m_grid, strayX, strayX);
+                    deaths.insert(std::end(deaths), std::begin(Strays), std::end(Strays));
+                }
+            };
+
+            if (m_pLeft)
+            {
+                RefreshHalo(fromLeft, m_minX - 1, m_minX > MinCoordinate + 1, m_minX - 2);
+            }
+            if (m_pRight)
+            {
+                RefreshHalo(fromRight, m_maxX + 1, m_maxX < MaxCoordinate - 1, m_maxX + 2);
+            }
+
+            if (!deaths.empty()) { m_grid.RemoveLiveCells(std::begin(deaths), std::end(deaths)); }
+            if (!births.empty()) { m_grid.InsertLiveCells(std::begin(births), std::end(births)); }
+        }
+
+        //
+        // The number of owned cells, then the columns of an evenly spread
+        // selection of them, taken in storage order.
+        //
+        void Report(std::vector<char>& reply) const
+        {
+            uint64_t numHaloCells{0};
+            if (m_pLeft) { numHaloCells += CellsInColumns(m_grid, m_minX - 1, m_minX - 1).size(); }
+            if (m_pRight) { numHaloCells += CellsInColumns(m_grid, m_maxX + 1, m_maxX + 1).size(); }
+            const uint64_t Population{m_grid.GetPopulation() - numHaloCells};
+
+            const uint64_t Stride{std::max<uint64_t>(1, Population / MaxSamples)};
+            std::vector<int64_t> samples;
+            uint64_t numOwned{0};
+            m_grid.ForEachLiveCell([&](const CellAddress& address)
+            {
+                if (address.first < m_minX || address.first > m_maxX) { return; }
+                if (numOwned++ % Stride == 0 && samples.size() < MaxSamples)
+                {
+                    samples.push_back(address.first);
+                }
+            });
+
+            gol::PutVarint(reply, Population);
+            gol::PutVarint(reply, samples.size());
+            for (const int64_t X : samples) { PutSigned(reply, X); }
+        }
+
+        gol::GOLGrid  m_grid;
+        size_t        m_index;
+        ShardChannel& m_coordinator;
+        ShardChannel* m_pLeft;
+        ShardChannel* m_pRight;
+
+        //
+        // Everything belongs to a worker until it's given a strip.
+        //
+        int64_t       m_minX = MinCoordinate;
+        int64_t       m_maxX = MaxCoordinate;
+    };
+
+    struct Sample
+    {
+        int64_t X;
+        double  Weight;
+    };
+
+    //
+    // Strip i + 1 starts at cuts[i]. Cuts fall at the weighted quantiles of
+    // the samples and are kept strictly increasing, so no strip is empty.
+    //
+    std::vector<int64_t> CutsFromSamples(std::vector<Sample> samples, size_t numWorkers)
+    {
+        std::sort(
+            std::begin(samples),
+            std::end(samples),
+            [](const Sample& a, const Sample& b) { return a.X < b.X; });
+
+        double total{0};
+        for (const auto& Current : samples) { total += Current.Weight; }
+
+        std::vector<int64_t> cuts(numWorkers - 1, 0);
+        double cumulative{0};
+        size_t sampleIndex{0};
+        for (size_t i = 0; i < cuts.size(); ++i)
+        {
+            const double Target{total * static_cast<double>(i + 1) / static_cast<double>(numWorkers)};
+            while (sampleIndex < samples.size() && cumulative + samples[sampleIndex].Weight <= Target)
+            {
+                cumulative += samples[sampleIndex++].Weight;
+            }
+
+            if (sampleIndex < samples.size()) { cuts[i] = samples[sampleIndex].X; }
+            else if (!samples.empty())        { cuts[i] = samples.back().X; }
+
+            if (i == 0)
+            {
+                cuts[i] = std::max(cuts[i], MinCoordinate + 1);
+            }
+            else if (cuts[i] <= cuts[i - 1])
+            {
+                cuts[i] = cuts[i - 1] + 1;
+            }
+        }
+
+        return cuts;
+    }
+
+    size_t OwnerOf(const std::vector<int64_t>& cuts, int64_t x)
+    {
+        return static_cast<size_t>(
+            std::upper_bound(std::begin(cuts), std::end(cuts), x) - std::begin(cuts));
+    }
+
+    //
+    // Waits for every worker to exit. Returns false if any of them failed.
+    //
+    bool ReapWorkers(std::vector<pid_t>& workers)
+    {
+        bool succeeded{true};
+        for (const pid_t Worker : workers)
+        {
+            int status{0};
+            while (::waitpid(Worker, &status, 0) < 0 && errno == EINTR) {}
+            succeeded = succeeded && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+        }
+
+        workers.clear();
+        return succeeded;
+    }
+
+    //
+    // The coordinator's side of the run. Owns its ends of the channels to the
+    // workers, and the workers themselves: however it leaves, they're closed
+    // and reaped.
+    //
+    class Coordinator
+    {
+    public:
+        Coordinator(std::vector<std::unique_ptr<ShardChannel>> channels, std::vector<pid_t> workers)
+            : m_channels(std::move(channels)),
+              m_workers(std::move(workers)) {}
+
+        ~Coordinator()
+        {
+            m_channels.clear();
+            ReapWorkers(m_workers);
+        }
+
+        Coordinator(const Coordinator&) = delete;
+        Coordinator& operator=(const Coordinator&) = delete;
+
+        //
+        // Hands every worker its strip, collects the cells that no longer
+        // belong to it, and deals those and the extra cells out to their
+        // owners.
+        //
+        void Distribute(const std::vector<int64_t>& cuts, const std::vector<CellAddress>& extraCells)
+        {
+            const size_t NumWorkers{m_channels.size()};
+            for (size_t i = 0; i < NumWorkers; ++i)
+            {
+                std::vector<char> message{static_cast<char>(Command::Strip)};
+                PutSigned(message, i == 0 ? MinCoordinate : cuts[i - 1]);
+                PutSigned(message, i + 1 == NumWorkers ? MaxCoordinate : cuts[i] - 1);
+                Send(i, message);
+            }
+
+            std::vector<std::vector<CellAddress>> incoming(NumWorkers);
+            auto Deal = [&](const CellAddress& address)
+            {
+                incoming[OwnerOf(cuts, address.first)].push_back(address);
+            };
+
+            std::vector<char> reply;
+            for (size_t i = 0; i < NumWorkers; ++i)
+            {
+                Receive(i, reply);
+                for (const auto& Address : MessageReader(reply).GetCells()) { Deal(Address); }
+            }
+            for (const auto& Address : extraCells) { Deal(Address); }
+
+            for (size_t i = 0; i < NumWorkers; ++i)
+            {
+                auto& cells = incoming[i];
+                std::sort(std::begin(cells), std::end(cells));
+                cells.erase(std::unique(std::begin(cells), std::end(cells)), std::end(cells));
+
+                std::vector<char> message{static_cast<char>(Command::Cells)};
+                PutCells(message, cells);
+                Send(i, message);
+            }
+        }
+
+        //
+        // Returns each worker's population, and fills in samples.
+        //
+        std::vector<uint64_t> Run(uint64_t numGenerations, std::vector<Sample>& samples)
+        {
+            std::vector<char> message{static_cast<char>(Command::Run)};
+            gol::PutVarint(message, numGenerations);
+            for (size_t i = 0; i < m_channels.size(); ++i) { Send(i, message); }
+
+            std::vector<uint64_t> populations;
+            samples.clear();
+            for (size_t i = 0; i < m_channels.size(); ++i)
+            {
+                Receive(i, message);
+                MessageReader reader(message);
+                const uint64_t Population{reader.GetUnsigned()};
+                const uint64_t NumSamples{reader.GetUnsigned()};
+                for (uint64_t i = 0; i < NumSamples; ++i)
+                {
+                    samples.push_back({
+                        reader.GetSigned(),
+                        static_cast<double>(Population) / static_cast<double>(NumSamples) });
+                }
+                populations.push_back(Population);
+            }
+
+            return populations;
+        }
+
+        //
+        // Strips are in column order, so the workers' sorted cells are too
+        // when put end to end.
+        //
+        std::vector<CellAddress> Finish()
+        {
+            std::vector<char> message{static_cast<char>(Command::Finish)};
+            for (size_t i = 0; i < m_channels.size(); ++i) { Send(i, message); }
+
+            std::vector<CellAddress> liveCells;
+            for (size_t i = 0; i < m_channels.size(); ++i)
+            {
+                Receive(i, message);
+                const auto Cells = MessageReader(message).GetCells();
+                liveCells.insert(std::end(liveCells), std::begin(Cells), std::end(Cells));
+            }
+
+            m_channels.clear();
+            if (!ReapWorkers(m_workers)) { throw std::runtime_error("A shard worker failed."); }
+            return liveCells;
+        }
+
+    private:
+        void Send(size_t worker, const std::vector<char>& message)
+        {
+            try
+            {
+                m_channels[worker]->Send(message);
+            }
+            catch (std::runtime_error&)
+            {
+                //
+                // The worker has gone away, perhaps leaving the reason on
+                // its channel. Receive throws either way, once it gets to
+                // the reason or the end.
+                //
+                std::vector<char> reply;
+                for (;;) { Receive(worker, reply); }
+            }
+        }
+
+        //
+        // Strips the worker's Reply, throwing if it reports a failure. A
+        // worker which lost a neighbor is passed over for the neighbor, so
+        // that the failure which started it all is the one reported; depth
+        // stops a pair of workers which lost each other from going round.
+        //
+        void Receive(size_t worker, std::vector<char>& message, size_t depth = 0)
+        {
+            const std::string Worker{"Shard worker " + std::to_string(worker)};
+            try
+            {
+                m_channels[worker]->Receive(message);
+            }
+            catch (std::runtime_error& e)
+            {
+                throw std::runtime_error(Worker + " stopped responding: " + e.what());
+            }
+
+            if (message.empty())
+            {
+                throw std::runtime_error("Malformed message between shards.");
+            }
+
+            const Reply Received{static_cast<Reply>(message[0])};
+            message.erase(std::begin(message));
+            if (Received == Reply::Ok) { return; }
+
+            if (Received == Reply::NeighborLost)
+            {
+                const uint64_t Neighbor{MessageReader(message).GetUnsigned()};
+                if (Neighbor >= m_channels.size() || depth >= m_channels.size())
+                {
+                    throw std::runtime_error(Worker + " lost its link to a neighbor.");
+                }
+
+                std::vector<char> reply;
+                for (;;) { Receive(static_cast<size_t>(Neighbor), reply, depth + 1); }
+            }
+
+            throw std::runtime_error(
+                Worker + " failed: " + std::string(std::begin(message), std::end(message)));
+        }
+
+        std::vector<std::unique_ptr<ShardChannel>> m_channels;
+        std::vector<pid_t>                         m_workers;
+    };
+}
+#endif
+
+namespace gol
+{
+    ShardedResult RunSharded(
+        const std::vector<CellAddress>& cellAddresses,
+        const ShardedSettings& settings)
+    {
+        if (!settings.NumWorkers || !settings.RebalanceEvery || !settings.NumThreads)
+        {
+            throw std::invalid_argument(
+                "A sharded run needs at least one worker, thread and generation between load checks.");
+        }
+        if (settings.Rule.Birth & 1)
+        {
+            throw std::invalid_argument("Rules with B0 aren't supported.");
+        }
+
+#if !defined(_WIN32)
+        const size_t NumWorkers{settings.NumWorkers};
+        std::vector<ShardChannelPair> toWorkers;
+        std::vector<ShardChannelPair> links;
+        for (size_t i = 0; i < NumWorkers; ++i)
+        {
+            toWorkers.push_back(settings.CreateChannels());
+            if (i + 1 < NumWorkers) { links.push_back(settings.CreateChannels()); }
+        }
+
+        //
+        // Anything buffered would otherwise be written once by every worker.
+        //
+        std::fflush(nullptr);
+
+        std::vector<pid_t> workers;
+        for (size_t i = 0; i < NumWorkers; ++i)
+        {
+            const pid_t Pid{::fork()};
+            if (Pid == 0)
+            {
+                //
+                // Each worker keeps its own ends and closes everything else,
+                // so that a process exiting is seen as the end of its
+                // channels. It never returns into the caller's code.
+                //
+                // A failure is passed on to the coordinator, which reports it
+                // to the caller.
+                //
+                int status{0};
+                auto pCoordinator = std::move(toWorkers[i].second);
+                try
+                {
+                    auto pLeft = i > 0 ? std::move(links[i - 1].second) : nullptr;
+                    auto pRight = i + 1 < NumWorkers ? std::move(links[i].first) : nullptr;
+                    toWorkers.clear();
+                    links.clear();
+
+                    ShardWorker(settings, i, *pCoordinator, pLeft.get(), pRight.get()).Serve();
+                }
+                catch (std::exception& e)
+                {
+                    status = 1;
+                    std::vector<char> failure;
+                    if (const auto* pLost = dynamic_cast<const NeighborLost*>(&e))
+                    {
+                        failure.push_back(static_cast<char>(Reply::NeighborLost));
+                        gol::PutVarint(failure, pLost->Neighbor);
+                    }
+                    else
+                    {
+                        const std::string Reason{e.what()};
+                        failure.push_back(static_cast<char>(Reply::Failed));
+                        failure.insert(std::end(failure), std::begin(Reason), std::end(Reason));
+                    }
+
+                    try
+                    {
+                        pCoordinator->Send(failure);
+                    }
+                    catch (std::exception&)
+                    {
+                        //
+                        // The coordinator has gone too, so there's no one
+                        // left to tell.
+                        //
+                    }
+                }
+                ::_exit(status);
+            }
+
+            if (Pid < 0)
+            {
+                const std::string Error{std::strerror(errno)};
+                toWorkers.clear();
+                links.clear();
+                ReapWorkers(workers);
+                throw std::runtime_error("Could not start a shard worker: " + Error);
+            }
+
+            workers.push_back(Pid);
+        }
+
+        std::vector<std::unique_ptr<ShardChannel>> channels;
+        for (auto& pair : toWorkers) { channels.push_back(std::move(pair.first)); }
+        toWorkers.clear();
+        links.clear();
+
+        Coordinator coordinator(std::move(channels), std::move(workers));
+
+        std::vector<Sample> samples;
+        samples.reserve(cellAddresses.size());
+        for (const auto& Address : cellAddresses) { samples.push_back({ Address.first, 1.0 }); }
+        auto cuts = CutsFromSamples(std::move(samples), NumWorkers);
+        coordinator.Distribute(cuts, cellAddresses);
+
+        ShardedResult result;
+        for (uint64_t remaining = settings.NumGenerations; remaining;)
+        {
+            const uint64_t NumGenerations{std::min(remaining, settings.RebalanceEvery)};
+            const auto Populations = coordinator.Run(NumGenerations, samples);
+            remaining -= NumGenerations;
+            if (!remaining) { break; }
+
+            uint64_t total{0};
+            uint64_t busiest{0};
+            for (const uint64_t Population : Populations)
+            {
+                total += Population;
+                busiest = std::max(busiest, Population);
+            }
+
+            if (busiest * NumWorkers * ImbalanceDenominator <= total * ImbalanceNumerator)
+            {
+                continue;
+            }
+
+            auto newCuts = CutsFromSamples(std::move(samples), NumWorkers);
+            if (newCuts == cuts) { continue; }
+
+            cuts = std::move(newCuts);
+            coordinator.Distribute(cuts, {});
+            ++result.NumRebalances;
+        }
+
+        result.LiveCells = coordinator.Finish();
+        return result;
+#else
+        (void)cellAddresses;
+        throw std::runtime_error("Sharded runs aren't supported on this platform.");
+#endif
+    }
+}
@@ -0,0 +1,79 @@
+//
+// Sharded runs: one pattern split across several worker processes, for boards
+// too big or too busy for one process.
+//
+// The plane is cut into vertical strips, each owned by a worker which runs
+// the sparse engine (GOLGrid) on its own cells. A worker also holds a copy of
+// the column just outside each edge of its strip, the halo: with those, every
+// cell it owns steps exactly as it would on a single board. After each
+// generation, neighboring workers swap their edge columns to refresh each
+// other's halos, and clear away whatever grew out of the stale halo, so
+// births on one side of a boundary show up on the other within the
+// generation.
+//
+// A coordinator (the calling process) hands out the cells, and every so
+// often collects each worker's population and a sample of where its cells
+// lie. If the busiest worker carries more than its share, the strips are
+// redrawn at quantiles of the sample and the cells which changed hands are
+// routed to their new owners through the coordinator.
+//
+// Cycle detection and region freezing are off in the workers, since no worker
+// sees the whole board. Only available where fork() is.
+//
+
+#pragma once
+
+#include "Cell.h"
+#include "Rule.h"
+#include "ShardTransport.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace gol
+{
+    struct ShardedSettings
+    {
+        size_t   NumWorkers = 2;
+        uint64_t NumGenerations = 0;
+        gol::Rule Rule = ConwayRule;
+
+        //
+        // How many generations go by between load checks.
+        //
+        uint64_t RebalanceEvery = 64;
+
+        //
+        // Threads per worker.
+        //
+        size_t   NumThreads = 1;
+
+        //
+        // Makes the channel between two processes.
+        //
+        std::function<ShardChannelPair()> CreateChannels = CreateSocketChannelPair;
+    };
+
+    struct ShardedResult
+    {
+        //
+        // Sorted by address.
+        //
+        std::vector<CellAddress> LiveCells;
+
+        size_t NumRebalances = 0;
+    };
+
+    //
+    // Runs settings.NumGenerations generations of the given live cells and
+    // returns the final live cells, the same as a single GOLGrid would.
+    // Throws std::invalid_argument for bad settings, and std::runtime_error
+    // if the workers can't be started or one of them fails, naming the
+    // worker and the reason it gave.
+    //
+    ShardedResult RunSharded(
+        const std::vector<CellAddress>& cellAddresses,
+        const ShardedSettings& settings);
+}
@@ -0,0 +1,128 @@
+#include "SpillStore.h"
+
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#if !defined(_WIN32)
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    //
+    // 16 MB at a time, so the file is mapped in a handful of large pieces.
+    //
+    constexpr size_t ExtentSlots{size_t(1) << 16};
+    constexpr size_t ExtentBytes{ExtentSlots * gol::SpillStore::SlotSize};
+}
+
+namespace gol
+{
+    SpillStore::SpillStore(const std::string& directory)
+    {
+#if !defined(_WIN32)
+        std::string path = directory.empty() ? std::string(".") : directory;
+        if (path.back() != '/') { path += '/'; }
+        path += "gol-spill-XXXXXX";
+
+        m_fd = ::mkstemp(&path[0]);
+        if (m_fd < 0)
+        {
+            throw std::runtime_error(
+                "Could not create a spill file in " + directory + ": " +
+                std::strerror(errno));
+        }
+
+        ::unlink(path.c_str());
+#else
+        (void)directory;
+#endif
+    }
+
+    SpillStore::~SpillStore()
+    {
+#if !defined(_WIN32)
+        for (uint8_t* pExtent : m_extents) { ::munmap(pExtent, ExtentBytes); }
+        if (m_fd >= 0) { ::close(m_fd); }
+#endif
+    }
+
+    size_t SpillStore::Store(const uint8_t* pData)
+    {
+        size_t slot;
+        if (!m_freeSlots.empty())
+        {
+            slot = m_freeSlots.back();
+            m_freeSlots.pop_back();
+        }
+        else
+        {
+            if (m_numSlots == m_extents.size() * ExtentSlots) { Grow(); }
+            slot = m_numSlots++;
+        }
+
+        std::memcpy(SlotData(slot), pData, SlotSize);
+        return slot;
+    }
+
+    const uint8_t* SpillStore::Load(size_t slot) const
+    {
+        assert(slot < m_numSlots);
+        return SlotData(slot);
+    }
+
+    void SpillStore::Release(size_t slot)
+    {
+        assert(slot < m_numSlots);
+        m_freeSlots.push_back(slot);
+    }
+
+    void SpillStore::Clear()
+    {
+        m_freeSlots.clear();
+        m_numSlots = 0;
+    }
+
+    uint8_t* SpillStore::SlotData(size_t slot) const
+    {
+        return m_extents[slot / ExtentSlots] + (slot % ExtentSlots) * SlotSize;
+    }
+
+    void SpillStore::Grow()
+    {
+#if !defined(_WIN32)
+        const off_t Offset{static_cast<off_t>(m_extents.size() * ExtentBytes)};
+        if (::ftruncate(m_fd, Offset + static_cast<off_t>(ExtentBytes)) != 0)
+        {
+            throw std::runtime_error(
+                std::string("Could not grow the spill file: ") + std::strerror(errno));
+        }
+
+        void* pMapping = ::mmap(
+            nullptr,
+            ExtentBytes,
+            PROT_READ | PROT_WRITE,
+            MAP_SHARED,
+            m_fd,
+            Offset);
+        if (pMapping == MAP_FAILED)
+        {
+            throw std::runtime_error(
+                std::string("Could not map the spill file: ") + std::strerror(errno));
+        }
+
+        //
+        // Slots come back in no particular order.
+        //
+        ::madvise(pMapping, ExtentBytes, MADV_RANDOM);
+        m_extents.push_back(static_cast<uint8_t*>(pMapping));
+#else
+        m_buffers.push_back(std::make_unique<uint8_t[]>(ExtentBytes));
+        m_extents.push_back(m_buffers.back().get());
+#endif
+    }
+}
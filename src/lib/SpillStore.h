@@ -0,0 +1,70 @@
+//
+// Fixed-size slots in a backing file, for keeping cold parts of a pattern out
+// of the heap.
+//
+// The file is created in a given directory and unlinked straight away, so it
+// disappears with the process however that ends. It grows in extents of many
+// slots, each memory-mapped shared: a slot written here is a page of the file,
+// which the kernel writes back and evicts under memory pressure like any
+// other cached file data, rather than keeping it in anonymous memory. Where
+// memory mapping isn't available the extents are plain heap buffers.
+//
+// Released slots are reused before the file grows. Not thread-safe; give each
+// thread its own store.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace gol
+{
+    class SpillStore
+    {
+    public:
+        static constexpr size_t SlotSize{256};
+
+        //
+        // Throws std::runtime_error if the backing file can't be created.
+        //
+        explicit SpillStore(const std::string& directory);
+        ~SpillStore();
+
+        SpillStore(const SpillStore&) = delete;
+        SpillStore& operator=(const SpillStore&) = delete;
+
+        //
+        // Copies SlotSize bytes into a free slot and returns its index.
+        // Throws std::runtime_error if the file can't grow.
+        //
+        size_t Store(const uint8_t* pData);
+
+        //
+        // The contents of a slot in use. Valid until the slot is released.
+        //
+        const uint8_t* Load(size_t slot) const;
+
+        void Release(size_t slot);
+
+        //
+        // Releases every slot, keeping the file for reuse.
+        //
+        void Clear();
+
+        size_t SlotsInUse() const noexcept { return m_numSlots - m_freeSlots.size(); }
+
+    private:
+        uint8_t* SlotData(size_t slot) const;
+        void     Grow();
+
+        int                                     m_fd = -1;
+        std::vector<uint8_t*>                   m_extents;
+        std::vector<std::unique_ptr<uint8_t[]>> m_buffers;
+        std::vector<size_t>                     m_freeSlots;
+        size_t                                  m_numSlots = 0;
+    };
+}
@@ -0,0 +1,95 @@
+#include "StatsWriter.h"
+
+#include <charconv>
+#include <cstring>
+
+namespace gol
+{
+    StatsWriter::StatsWriter(std::FILE* pFile, size_t bufferSize)
+        : m_pFile(pFile),
+          m_bufferSize(bufferSize)
+    {
+        m_buffer.reserve(m_bufferSize);
+    }
+
+    StatsWriter::~StatsWriter()
+    {
+        Flush();
+    }
+
+    void StatsWriter::WriteGeneration(const GenerationStats& stats)
+    {
+        //
+        // Engine names are plain identifiers, so they need no escaping.
+        //
+        const char* const Prefix = "{\"generation\":";
+        m_buffer.insert(
+            std::end(m_buffer),
+            Prefix,
+            Prefix + std::strlen(Prefix));
+
+        char number[20];
+        char* pEnd = std::to_chars(number, number + sizeof(number), stats.Generation).ptr;
+        m_buffer.insert(std::end(m_buffer), number, pEnd);
+
+        const char* const EngineField = ",\"engine\":\"";
+        m_buffer.insert(
+            std::end(m_buffer),
+            EngineField,
+            EngineField + std::strlen(EngineField));
+        m_buffer.insert(
+            std::end(m_buffer),
+            stats.pEngine,
+            stats.pEngine + std::strlen(stats.pEngine));
+        m_buffer.push_back('"');
+
+        WriteField("wall_ns", stats.WallNanoseconds);
+        WriteField("live_cells", stats.LiveCells);
+        WriteField("allocations", stats.Allocations);
+        WriteField("allocated_bytes", stats.AllocatedBytes);
+        if (stats.HasPhases)
+        {
+            WriteField("classify_ns", stats.ClassifyNanoseconds);
+            WriteField("propagate_ns", stats.PropagateNanoseconds);
+            WriteField("retire_ns", stats.RetireNanoseconds);
+            WriteField("freeze_ns", stats.FreezeNanoseconds);
+            WriteField("stored_cells", stats.StoredCells);
+            WriteField("changed_cells", stats.ChangedCells);
+            WriteField("retired_cells", stats.RetiredCells);
+            WriteField("storage_bytes", stats.StorageBytes);
+            WriteField("frozen_regions", stats.FrozenRegions);
+        }
+
+        m_buffer.push_back('}');
+        m_buffer.push_back('\n');
+
+        if (m_buffer.size() >= m_bufferSize) { Flush(); }
+    }
+
+    bool StatsWriter::Flush()
+    {
+        if (!m_buffer.empty())
+        {
+            const size_t Written{
+                std::fwrite(m_buffer.data(), 1, m_buffer.size(), m_pFile)};
+            m_good = m_good && Written == m_buffer.size();
+            m_buffer.clear();
+        }
+
+        m_good = m_good && std::fflush(m_pFile) == 0;
+        return m_good;
+    }
+
+    void StatsWriter::WriteField(const char* pName, uint64_t value)
+    {
+        m_buffer.push_back(',');
+        m_buffer.push_back('"');
+        m_buffer.insert(std::end(m_buffer), pName, pName + std::strlen(pName));
+        m_buffer.push_back('"');
+        m_buffer.push_back(':');
+
+        char number[20];
+        char* pEnd = std::to_chars(number, number + sizeof(number), value).ptr;
+        m_buffer.insert(std::end(m_buffer), number, pEnd);
+    }
+}
@@ -0,0 +1,75 @@
+//
+// Per-generation runtime metrics, written as JSON lines: one flat object per
+// generation, e.g.
+//     {"generation":12,"engine":"sparse","wall_ns":48211,"live_cells":116,...}
+//
+// Fields which an engine can't provide are left out of its lines rather than
+// written as zero.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace gol
+{
+    struct GenerationStats
+    {
+        uint64_t    Generation = 0;
+        const char* pEngine = "";
+        uint64_t    WallNanoseconds = 0;
+        uint64_t    LiveCells = 0;
+        uint64_t    Allocations = 0;
+        uint64_t    AllocatedBytes = 0;
+
+        //
+        // Sparse engine only: see GOLGrid::StepStats.
+        //
+        bool     HasPhases = false;
+        uint64_t ClassifyNanoseconds = 0;
+        uint64_t PropagateNanoseconds = 0;
+        uint64_t RetireNanoseconds = 0;
+        uint64_t FreezeNanoseconds = 0;
+        uint64_t StoredCells = 0;
+        uint64_t ChangedCells = 0;
+        uint64_t RetiredCells = 0;
+        uint64_t StorageBytes = 0;
+        uint64_t FrozenRegions = 0;
+    };
+
+    class StatsWriter
+    {
+    public:
+        static constexpr size_t DefaultBufferSize{size_t(1) << 16};
+
+        explicit StatsWriter(std::FILE* pFile, size_t bufferSize = DefaultBufferSize);
+
+        //
+        // Flushes whatever is still buffered.
+        //
+        ~StatsWriter();
+
+        StatsWriter(const StatsWriter&) = delete;
+        StatsWriter& operator=(const StatsWriter&) = delete;
+
+        void WriteGeneration(const GenerationStats& stats);
+
+        //
+        // Returns false if any write so far has failed.
+        //
+        bool Flush();
+        bool Good() const noexcept { return m_good; }
+
+    private:
+        void WriteField(const char* pName, uint64_t value);
+
+        std::FILE*        m_pFile;
+        size_t            m_bufferSize;
+        std::vector<char> m_buffer;
+        bool              m_good = true;
+    };
+}
@@ -0,0 +1,147 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+namespace gol
+{
+    ThreadPool::ThreadPool(size_t numThreads)
+    {
+        const size_t NumQueues{std::max<size_t>(numThreads, 1)};
+        for (size_t i = 0; i < NumQueues; ++i)
+        {
+            m_queues.push_back(std::make_unique<WorkerQueue>());
+        }
+
+        //
+        // Worker 0 is whichever thread calls ParallelFor.
+        //
+        for (size_t i = 1; i < NumQueues; ++i)
+        {
+            m_threads.emplace_back(&ThreadPool::WorkerLoop, this, i);
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_wakeCondition.notify_all();
+
+        for (auto& thread : m_threads) { thread.join(); }
+    }
+
+    void ThreadPool::ParallelFor(
+        size_t numTasks,
+        const std::function<void(size_t)>& task)
+    {
+        if (!numTasks) { return; }
+
+        if (m_threads.empty())
+        {
+            for (size_t i = 0; i < numTasks; ++i) { task(i); }
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_pTask = &task;
+            m_remaining = numTasks;
+
+            //
+            // Deal out contiguous runs of tasks so neighboring indices tend
+            // to land on the same worker.
+            //
+            const size_t NumQueues{m_queues.size()};
+            for (size_t queueIndex = 0; queueIndex < NumQueues; ++queueIndex)
+            {
+                const size_t First{numTasks * queueIndex / NumQueues};
+                const size_t Last{numTasks * (queueIndex + 1) / NumQueues};
+
+                auto& queue = *m_queues[queueIndex];
+                std::lock_guard<std::mutex> queueLock(queue.Mutex);
+                for (size_t i = First; i < Last; ++i)
+                {
+                    queue.Tasks.push_back(i);
+                }
+            }
+
+            ++m_epoch;
+        }
+        m_wakeCondition.notify_all();
+
+        while (RunOneTask(0)) {}
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_doneCondition.wait(lock, [this] { return m_remaining == 0; });
+        m_pTask = nullptr;
+    }
+
+    void ThreadPool::WorkerLoop(size_t workerIndex)
+    {
+        size_t lastEpoch{0};
+        for (;;)
+        {
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_wakeCondition.wait(
+                    lock,
+                    [this, lastEpoch]
+                    {
+                        return m_stopping || m_epoch != lastEpoch;
+                    });
+
+                if (m_stopping) { return; }
+                lastEpoch = m_epoch;
+            }
+
+            while (RunOneTask(workerIndex)) {}
+        }
+    }
+
+    bool ThreadPool::RunOneTask(size_t workerIndex)
+    {
+        size_t taskIndex{0};
+        bool found{false};
+
+        {
+            auto& ownQueue = *m_queues[workerIndex];
+            std::lock_guard<std::mutex> lock(ownQueue.Mutex);
+            if (!ownQueue.Tasks.empty())
+            {
+                taskIndex = ownQueue.Tasks.back();
+                ownQueue.Tasks.pop_back();
+                found = true;
+            }
+        }
+
+        for (size_t offset = 1; !found && offset < m_queues.size(); ++offset)
+        {
+            auto& victimQueue = *m_queues[(workerIndex + offset) % m_queues.size()];
+            std::lock_guard<std::mutex> lock(victimQueue.Mutex);
+            if (!victimQueue.Tasks.empty())
+            {
+                taskIndex = victimQueue.Tasks.front();
+                victimQueue.Tasks.pop_front();
+                found = true;
+            }
+        }
+
+        if (!found) { return false; }
+
+        //
+        // Tasks are only queued after m_pTask is published, and the queue
+        // mutex orders the two, so this always sees the current loop body.
+        //
+        (*m_pTask)(taskIndex);
+
+        if (m_remaining.fetch_sub(1) == 1)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_doneCondition.notify_all();
+        }
+
+        return true;
+    }
+}
@@ -0,0 +1,71 @@
+//
+// A small work-stealing thread pool for data-parallel loops.
+//
+// Each worker owns a deque of task indices. Workers pop from the back of their
+// own deque and, once it runs dry, steal from the front of other workers'
+// deques, so uneven tasks (e.g. a dense spatial bucket next to an empty one)
+// still keep every thread busy.
+//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace gol
+{
+    class ThreadPool
+    {
+    public:
+        //
+        // The calling thread takes part in every loop, so a pool of
+        // numThreads spawns numThreads - 1 workers.
+        //
+        explicit ThreadPool(size_t numThreads);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        size_t Size() const noexcept { return m_queues.size(); }
+
+        //
+        // Runs task(i) for every i in [0, numTasks) and blocks until all of
+        // them have finished. Not reentrant.
+        //
+        void ParallelFor(size_t numTasks, const std::function<void(size_t)>& task);
+
+    private:
+        struct WorkerQueue
+        {
+            std::mutex         Mutex;
+            std::deque<size_t> Tasks;
+        };
+
+        void WorkerLoop(size_t workerIndex);
+
+        //
+        // Runs one task from the worker's own queue or, failing that, one
+        // stolen from another. Returns false if every queue is empty.
+        //
+        bool RunOneTask(size_t workerIndex);
+
+        std::vector<std::unique_ptr<WorkerQueue>> m_queues;
+        std::vector<std::thread>                  m_threads;
+
+        std::mutex                          m_mutex;
+        std::condition_variable             m_wakeCondition;
+        std::condition_variable             m_doneCondition;
+        const std::function<void(size_t)>*  m_pTask = nullptr;
+        size_t                              m_epoch = 0;
+        bool                                m_stopping = false;
+        std::atomic<size_t>                 m_remaining{0};
+    };
+}
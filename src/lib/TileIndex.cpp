@@ -0,0 +1,60 @@
+#include "TileIndex.h"
+
+#include <cassert>
+
+namespace gol
+{
+    size_t TileIndex::TileKeyHash::operator()(const TileKey& key) const noexcept
+    {
+        return static_cast<size_t>(HashCoordinates(key.first, key.second));
+    }
+
+    void TileIndex::SetAlive(const CellAddress& address, bool alive)
+    {
+        const TileKey Key{TileKeyOf(address)};
+        const uint16_t Bit = uint16_t(1u << (address.first & (TileSize - 1)));
+        const size_t Row{static_cast<size_t>(address.second & (TileSize - 1))};
+
+        if (alive)
+        {
+            auto [tileIt, inserted] = m_tiles.try_emplace(Key);
+            if (inserted)
+            {
+                m_byColumn.insert(Key);
+                m_byRow.insert(Key);
+            }
+
+            assert(!(tileIt->second[Row] & Bit));
+            tileIt->second[Row] |= Bit;
+            ++m_population;
+            return;
+        }
+
+        auto tileIt = m_tiles.find(Key);
+        assert(tileIt != m_tiles.end() && (tileIt->second[Row] & Bit));
+
+        auto& tile = tileIt->second;
+        tile[Row] &= uint16_t(~Bit);
+        --m_population;
+
+        if (!tile[Row])
+        {
+            for (const uint16_t Bits : tile)
+            {
+                if (Bits) { return; }
+            }
+
+            m_tiles.erase(tileIt);
+            m_byColumn.erase(Key);
+            m_byRow.erase(Key);
+        }
+    }
+
+    void TileIndex::Clear()
+    {
+        m_tiles.clear();
+        m_byColumn.clear();
+        m_byRow.clear();
+        m_population = 0;
+    }
+}
@@ -0,0 +1,192 @@
+//
+// Spatial index of live cells, for range queries, bounding boxes and
+// population counts which don't have to scan every cell.
+//
+// The plane is divided into 16x16 tiles, each holding a bitmap of its live
+// cells. Tiles with at least one live cell are kept in a hash table, for
+// updating a cell in constant time, and in two ordered sets of tile keys, one
+// by column and one by row. A rectangle query walks the ordered set over just
+// the tile columns it spans, so it costs time proportional to the occupied
+// tiles it overlaps rather than to the population or the rectangle's area.
+// The outermost tiles give the bounding box.
+//
+// The index doesn't know what's live on its own; its owner reports every
+// birth and death.
+//
+
+#pragma once
+
+#include "Cell.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <set>
+#include <unordered_map>
+
+namespace gol
+{
+    class TileIndex
+    {
+    public:
+        static constexpr int64_t TileShift{4};
+        static constexpr int64_t TileSize{int64_t(1) << TileShift};
+
+        //
+        // Row r holds the cells at y = origin.y + r; bit c of a row is the
+        // cell at x = origin.x + c. A tile's origin is its key shifted left
+        // by TileShift.
+        //
+        using Tile = std::array<uint16_t, TileSize>;
+        using TileKey = CellAddress;
+
+        static TileKey TileKeyOf(const CellAddress& address)
+        {
+            return { address.first >> TileShift, address.second >> TileShift };
+        }
+
+        TileIndex() = default;
+
+        //
+        // Containers allocate from the index's own pool, so it stays put.
+        //
+        TileIndex(const TileIndex&) = delete;
+        TileIndex& operator=(const TileIndex&) = delete;
+
+        //
+        // Records a birth (alive) or a death. The cell must currently be in
+        // the other state.
+        //
+        void SetAlive(const CellAddress& address, bool alive);
+
+        void Clear();
+
+        size_t Population() const noexcept { return m_population; }
+
+        //
+        // The tile with the given key, or nullptr if it has no live cells.
+        //
+        const Tile* FindTile(const TileKey& key) const
+        {
+            const auto It = m_tiles.find(key);
+            return It != m_tiles.end() ? &It->second : nullptr;
+        }
+
+        //
+        // Calls visitor(const TileKey&, const Tile&) for every occupied tile,
+        // in no particular order.
+        //
+        template<typename Visitor>
+        void ForEachTile(Visitor&& visitor) const
+        {
+            for (const auto& [Key, Tile] : m_tiles) { visitor(Key, Tile); }
+        }
+
+        //
+        // Calls visitor(const TileKey&, const Tile&) for every occupied tile
+        // overlapping the inclusive tile rectangle [minKey, maxKey], column by
+        // column.
+        //
+        template<typename Visitor>
+        void ForEachTileInRect(
+            const TileKey& minKey,
+            const TileKey& maxKey,
+            Visitor&& visitor) const;
+
+        //
+        // The occupied tiles with the smallest and largest column and row
+        // keys, in that order, in a form suited to finding the exact extent:
+        // visitor(const TileKey&, const Tile&) is called for every tile in
+        // the given extreme column (edge 0 or 1) or row (edge 2 or 3) until it
+        // returns true, moving one column or row inwards each time all of
+        // them return false. Does nothing when the index is empty.
+        //
+        template<typename Visitor>
+        void ScanFromEdge(size_t edge, Visitor&& visitor) const;
+
+    private:
+        struct TileKeyHash
+        {
+            size_t operator()(const TileKey& key) const noexcept;
+        };
+
+        //
+        // Orders keys by row first, for the row set.
+        //
+        struct RowOrder
+        {
+            bool operator()(const TileKey& a, const TileKey& b) const noexcept
+            {
+                return a.second != b.second ? a.second < b.second : a.first < b.first;
+            }
+        };
+
+        //
+        // Declared first so that it outlives the containers.
+        //
+        std::pmr::unsynchronized_pool_resource m_pool;
+
+        std::pmr::unordered_map<TileKey, Tile, TileKeyHash> m_tiles{&m_pool};
+        std::pmr::set<TileKey>                             m_byColumn{&m_pool};
+        std::pmr::set<TileKey, RowOrder>                   m_byRow{&m_pool};
+        size_t                                             m_population = 0;
+    };
+
+    template<typename Visitor>
+    void TileIndex::ForEachTileInRect(
+        const TileKey& minKey,
+        const TileKey& maxKey,
+        Visitor&& visitor) const
+    {
+        auto it = m_byColumn.lower_bound(minKey);
+        while (it != m_byColumn.end() && it->first <= maxKey.first)
+        {
+            if (it->second < minKey.second)
+            {
+                it = m_byColumn.lower_bound(TileKey(it->first, minKey.second));
+            }
+            else if (it->second > maxKey.second)
+            {
+                //
+                // Skip the rest of this column, or stop at the last one.
+                //
+                if (it->first == maxKey.first) { break; }
+                it = m_byColumn.lower_bound(TileKey(it->first + 1, minKey.second));
+            }
+            else
+            {
+                visitor(*it, m_tiles.find(*it)->second);
+                ++it;
+            }
+        }
+    }
+
+    template<typename Visitor>
+    void TileIndex::ScanFromEdge(size_t edge, Visitor&& visitor) const
+    {
+        auto Scan = [this, &visitor](auto first, auto last, auto lineOf)
+        {
+            while (first != last)
+            {
+                const int64_t Line{lineOf(*first)};
+                bool found{false};
+                for (; first != last && lineOf(*first) == Line; ++first)
+                {
+                    found = visitor(*first, m_tiles.find(*first)->second) || found;
+                }
+                if (found) { return; }
+            }
+        };
+
+        auto ColumnOf = [](const TileKey& key) { return key.first; };
+        auto RowOf = [](const TileKey& key) { return key.second; };
+        switch (edge)
+        {
+        case 0: Scan(m_byColumn.begin(), m_byColumn.end(), ColumnOf); break;
+        case 1: Scan(m_byColumn.rbegin(), m_byColumn.rend(), ColumnOf); break;
+        case 2: Scan(m_byRow.begin(), m_byRow.end(), RowOf); break;
+        default: Scan(m_byRow.rbegin(), m_byRow.rend(), RowOf); break;
+        }
+    }
+}
@@ -0,0 +1,300 @@
+#include "TiledGrid.h"
+
+#include <algorithm>
+
+namespace
+{
+    using gol::TiledGrid;
+
+    constexpr int64_t TileSize{TiledGrid::TileSize};
+    constexpr int64_t TileMask{TileSize - 1};
+    constexpr size_t HaloRows{TileSize + 2};
+
+    TiledGrid::TileKey TileKeyOf(const gol::CellAddress& address)
+    {
+        return { address.first >> TiledGrid::TileShift,
+                 address.second >> TiledGrid::TileShift };
+    }
+
+    //
+    // A tile plus a one-cell border borrowed from its eight neighbors.
+    // Index i of each array corresponds to tile row i - 1. West and East hold
+    // the single cell just outside the tile on that row, as a 0 or 1.
+    //
+    struct Halo
+    {
+        uint64_t Rows[HaloRows];
+        uint64_t West[HaloRows];
+        uint64_t East[HaloRows];
+    };
+
+    void GatherHalo(
+        const TiledGrid::TileMap& tiles,
+        const TiledGrid::TileKey& key,
+        const TiledGrid::Tile& tile,
+        Halo& halo)
+    {
+        const TiledGrid::Tile* neighbors[3][3];
+        for (int64_t dy = -1; dy <= 1; ++dy)
+        {
+            for (int64_t dx = -1; dx <= 1; ++dx)
+            {
+                auto it = tiles.find({ key.first + dx, key.second + dy });
+                neighbors[dy + 1][dx + 1] =
+                    it != std::end(tiles) ? &it->second : nullptr;
+            }
+        }
+
+        auto RowOf = [&neighbors](int64_t dx, int64_t dy, int64_t row)
+        {
+            const auto* pTile = neighbors[dy + 1][dx + 1];
+            return pTile ? (*pTile)[row] : 0;
+        };
+
+        halo.Rows[0] = RowOf(0, -1, TileMask);
+        halo.West[0] = RowOf(-1, -1, TileMask) >> 63;
+        halo.East[0] = RowOf(1, -1, TileMask) & 1;
+        for (int64_t row = 0; row < TileSize; ++row)
+        {
+            halo.Rows[row + 1] = tile[row];
+            halo.West[row + 1] = RowOf(-1, 0, row) >> 63;
+            halo.East[row + 1] = RowOf(1, 0, row) & 1;
+        }
+        halo.Rows[HaloRows - 1] = RowOf(0, 1, 0);
+        halo.West[HaloRows - 1] = RowOf(-1, 1, 0) >> 63;
+        halo.East[HaloRows - 1] = RowOf(1, 1, 0) & 1;
+    }
+
+    void FullAdd(
+        uint64_t a, uint64_t b, uint64_t c,
+        uint64_t& sum, uint64_t& carry)
+    {
+        const uint64_t Partial = a ^ b;
+        sum = Partial ^ c;
+        carry = (a & b) | (Partial & c);
+    }
+
+    void HalfAdd(uint64_t a, uint64_t b, uint64_t& sum, uint64_t& carry)
+    {
+        sum = a ^ b;
+        carry = a & b;
+    }
+
+    //
+    // Computes the neighbor count of every cell in a tile row at once. Bit c
+    // of planes[k] is bit k of the neighbor count for the cell in column c.
+    //
+    void NeighborCountPlanes(const Halo& halo, int64_t row, uint64_t planes[4])
+    {
+        uint64_t neighbors[8];
+        size_t n = 0;
+        for (int64_t i = row; i < row + 3; ++i)
+        {
+            const uint64_t Row = halo.Rows[i];
+            neighbors[n++] = (Row << 1) | halo.West[i];
+            neighbors[n++] = (Row >> 1) | (halo.East[i] << 63);
+
+            //
+            // The cell itself isn't its own neighbor.
+            //
+            if (i != row + 1) { neighbors[n++] = Row; }
+        }
+
+        //
+        // Eight one-bit inputs, summed with a tree of adders into four bit
+        // planes.
+        //
+        uint64_t onesA, twosA, onesB, twosB, onesC, twosC;
+        FullAdd(neighbors[0], neighbors[1], neighbors[2], onesA, twosA);
+        FullAdd(neighbors[3], neighbors[4], neighbors[5], onesB, twosB);
+        HalfAdd(neighbors[6], neighbors[7], onesC, twosC);
+
+        uint64_t twosD;
+        FullAdd(onesA, onesB, onesC, planes[0], twosD);
+
+        uint64_t twosPartial, foursA, foursB;
+        FullAdd(twosA, twosB, twosC, twosPartial, foursA);
+        HalfAdd(twosPartial, twosD, planes[1], foursB);
+        HalfAdd(foursA, foursB, planes[2], planes[3]);
+    }
+
+    uint64_t NextRow(const Halo& halo, int64_t row)
+    {
+        uint64_t planes[4];
+        NeighborCountPlanes(halo, row, planes);
+
+        //
+        // B3/S23: alive next generation with exactly three neighbors, or with
+        // exactly two if already alive.
+        //
+        const uint64_t Alive = halo.Rows[row + 1];
+        return planes[1] & ~planes[2] & ~planes[3] & (planes[0] | Alive);
+    }
+
+    bool TileIsEmpty(const TiledGrid::Tile& tile)
+    {
+        return std::all_of(
+            std::begin(tile),
+            std::end(tile),
+            [](uint64_t row) { return row == 0; });
+    }
+}
+
+namespace gol
+{
+    size_t TiledGrid::TileKeyHash::operator()(const TileKey& key) const noexcept
+    {
+        return static_cast<size_t>(HashCoordinates(key.first, key.second));
+    }
+
+    TiledGrid::TiledGrid(const std::vector<CellAddress>& cellAddresses)
+    {
+        for (const auto& Address : cellAddresses) { SetAlive(Address); }
+    }
+
+    void TiledGrid::AdvanceGeneration()
+    {
+        AddBorderTiles();
+
+        //
+        // Compute every tile's next state before writing any of them back, so
+        // that halos are always gathered from the current generation.
+        //
+        std::vector<Tile> nextTiles(m_tiles.size());
+        Halo halo;
+        size_t index{0};
+        for (const auto& [Key, CurrentTile] : m_tiles)
+        {
+            GatherHalo(m_tiles, Key, CurrentTile, halo);
+
+            auto& nextTile = nextTiles[index++];
+            for (int64_t row = 0; row < TileSize; ++row)
+            {
+                nextTile[row] = NextRow(halo, row);
+            }
+        }
+
+        index = 0;
+        for (auto it = std::begin(m_tiles); it != std::end(m_tiles);)
+        {
+            const auto& NextTile = nextTiles[index++];
+            if (TileIsEmpty(NextTile))
+            {
+                it = m_tiles.erase(it);
+            }
+            else
+            {
+                it->second = NextTile;
+                ++it;
+            }
+        }
+    }
+
+    std::vector<Cell> TiledGrid::GetLiveCells() const
+    {
+        std::vector<Cell> liveCells;
+        Halo halo;
+        for (const auto& [Key, CurrentTile] : m_tiles)
+        {
+            GatherHalo(m_tiles, Key, CurrentTile, halo);
+
+            const int64_t OriginX{Key.first << TileShift};
+            const int64_t OriginY{Key.second << TileShift};
+            for (int64_t row = 0; row < TileSize; ++row)
+            {
+                uint64_t bits = CurrentTile[row];
+                if (!bits) { continue; }
+
+                uint64_t planes[4];
+                NeighborCountPlanes(halo, row, planes);
+                for (int64_t column = 0; column < TileSize; ++column)
+                {
+                    if (!((bits >> column) & 1)) { continue; }
+
+                    uint8_t neighborCount{0};
+                    for (int plane = 0; plane < 4; ++plane)
+                    {
+                        neighborCount |=
+                            ((planes[plane] >> column) & 1) << plane;
+                    }
+
+                    const bool AliveCell{true};
+                    liveCells.emplace_back(
+                        CellAddress(OriginX + column, OriginY + row),
+                        AliveCell,
+                        neighborCount);
+                }
+            }
+        }
+
+        std::sort(
+            std::begin(liveCells),
+            std::end(liveCells),
+            [](const Cell& a, const Cell& b) { return a.Address < b.Address; });
+        return liveCells;
+    }
+
+    size_t TiledGrid::MemoryFootprint() const
+    {
+        //
+        // Tile payload plus the key, bucket pointer and next pointer of each
+        // hash node.
+        //
+        const size_t PerTile{sizeof(TileMap::value_type) + 2 * sizeof(void*)};
+        return m_tiles.size() * PerTile +
+               m_tiles.bucket_count() * sizeof(void*);
+    }
+
+    void TiledGrid::SetAlive(const CellAddress& address)
+    {
+        //
+        // operator[] value-initializes new tiles, i.e. all dead.
+        //
+        auto& tile = m_tiles[TileKeyOf(address)];
+        tile[address.second & TileMask] |= uint64_t(1) << (address.first & TileMask);
+    }
+
+    void TiledGrid::AddBorderTiles()
+    {
+        std::vector<TileKey> missingKeys;
+        for (const auto& [Key, CurrentTile] : m_tiles)
+        {
+            uint64_t westColumn{0};
+            uint64_t eastColumn{0};
+            for (const auto Row : CurrentTile)
+            {
+                westColumn |= Row & 1;
+                eastColumn |= Row >> 63;
+            }
+
+            const bool Touches[3][3] = {
+                { westColumn && CurrentTile[0] & 1,
+                  CurrentTile[0] != 0,
+                  eastColumn && CurrentTile[0] >> 63 },
+                { westColumn != 0, false, eastColumn != 0 },
+                { westColumn && CurrentTile[TileMask] & 1,
+                  CurrentTile[TileMask] != 0,
+                  eastColumn && CurrentTile[TileMask] >> 63 },
+            };
+
+            for (int64_t dy = -1; dy <= 1; ++dy)
+            {
+                for (int64_t dx = -1; dx <= 1; ++dx)
+                {
+                    if (!Touches[dy + 1][dx + 1]) { continue; }
+
+                    const TileKey NeighborKey(Key.first + dx, Key.second + dy);
+                    if (m_tiles.find(NeighborKey) == std::end(m_tiles))
+                    {
+                        missingKeys.push_back(NeighborKey);
+                    }
+                }
+            }
+        }
+
+        //
+        // Don't mess with the container while iterating through it.
+        //
+        for (const auto& MissingKey : missingKeys) { m_tiles[MissingKey]; }
+    }
+}
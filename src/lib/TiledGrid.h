@@ -0,0 +1,110 @@
+//
+// Alternative board representation for the Game of Life: the infinite plane is
+// carved into 64x64 tiles, each stored as a bit-packed bitboard and keyed by
+// its tile coordinate. Only tiles which contain live cells (or which live
+// cells may spill into) are kept.
+//
+// Rather than tracking neighbor counts per cell, each generation is computed
+// 64 cells at a time by adding up shifted copies of the rows with bitwise full
+// adders. Neighboring tiles contribute a one-cell halo around each tile.
+//
+
+#pragma once
+
+#include "Cell.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace gol
+{
+    class TiledGrid
+    {
+    public:
+        //
+        // cellAddresses lists all live cells which describes the initial state.
+        //
+        TiledGrid(const std::vector<CellAddress>& cellAddresses);
+
+        //
+        // Advance the generation by one single iteration.
+        //
+        void AdvanceGeneration();
+
+        //
+        // Retrieve live cells for testing and output, sorted by address.
+        // Neighbor counts are reconstructed from the bitboards.
+        //
+        std::vector<Cell> GetLiveCells() const;
+
+        //
+        // Calls visitor(const CellAddress&) for every live cell, straight off
+        // the bitboards. Order is unspecified.
+        //
+        template<typename Visitor>
+        void ForEachLiveCell(Visitor&& visitor) const;
+
+        //
+        // Approximate number of bytes held by tile storage.
+        //
+        size_t MemoryFootprint() const;
+
+        static constexpr int64_t TileShift{6};
+        static constexpr int64_t TileSize{int64_t(1) << TileShift};
+
+        //
+        // Row r holds the cells at y = origin.y + r; bit c of a row is the
+        // cell at x = origin.x + c.
+        //
+        using Tile = std::array<uint64_t, TileSize>;
+
+        //
+        // Tile coordinates are cell coordinates shifted right by TileShift, so
+        // a tile's origin is its key shifted back left.
+        //
+        using TileKey = CellAddress;
+        struct TileKeyHash
+        {
+            size_t operator()(const TileKey& key) const noexcept;
+        };
+        using TileMap = std::unordered_map<TileKey, Tile, TileKeyHash>;
+
+    private:
+        void SetAlive(const CellAddress& address);
+
+        //
+        // Adds empty tiles next to any tile with live cells on its border so
+        // that births across tile boundaries have somewhere to land.
+        //
+        void AddBorderTiles();
+
+        TileMap m_tiles;
+    };
+
+    template<typename Visitor>
+    void TiledGrid::ForEachLiveCell(Visitor&& visitor) const
+    {
+        for (const auto& [Key, CurrentTile] : m_tiles)
+        {
+            const int64_t OriginX{Key.first << TileShift};
+            const int64_t OriginY{Key.second << TileShift};
+            for (int64_t row = 0; row < TileSize; ++row)
+            {
+                //
+                // Stop as soon as the remaining bits of the row are all dead.
+                //
+                int64_t column{0};
+                for (uint64_t bits = CurrentTile[row]; bits; bits >>= 1, ++column)
+                {
+                    if (bits & 1)
+                    {
+                        visitor(CellAddress(OriginX + column, OriginY + row));
+                    }
+                }
+            }
+        }
+    }
+}
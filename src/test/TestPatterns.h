@@ -0,0 +1,93 @@
+//
+// Helpers shared by the tests: random soups to run, and the live cells and
+// output files to compare runs by.
+//
+
+#pragma once
+
+#include <lib/Cell.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+//
+// Cells of the square from minCoordinate to maxCoordinate on both axes, each
+// alive with the given probability. The same seed gives the same soup.
+//
+inline
+std::vector<gol::CellAddress> GenerateSoup(
+    int64_t minCoordinate,
+    int64_t maxCoordinate,
+    double density,
+    uint64_t seed)
+{
+    std::mt19937_64 rng(seed);
+    std::bernoulli_distribution alive(density);
+
+    std::vector<gol::CellAddress> cells;
+    for (int64_t y = minCoordinate; y <= maxCoordinate; ++y)
+    {
+        for (int64_t x = minCoordinate; x <= maxCoordinate; ++x)
+        {
+            if (alive(rng)) { cells.emplace_back(x, y); }
+        }
+    }
+
+    return cells;
+}
+
+inline
+std::vector<gol::CellAddress> AddressesOf(const std::vector<gol::Cell>& cells)
+{
+    std::vector<gol::CellAddress> addresses;
+    for (const auto& Cell : cells) { addresses.push_back(Cell.Address); }
+    return addresses;
+}
+
+//
+// The live cells of any grid with a ForEachLiveCell visitor, sorted.
+//
+template<typename GridType>
+std::vector<gol::CellAddress> SortedLiveCells(const GridType& grid)
+{
+    std::vector<gol::CellAddress> addresses;
+    grid.ForEachLiveCell([&addresses](const gol::CellAddress& address)
+    {
+        addresses.push_back(address);
+    });
+    std::sort(std::begin(addresses), std::end(addresses));
+    return addresses;
+}
+
+inline
+std::string ReadAll(const std::string& path)
+{
+    std::ifstream in(path, std::ios::binary);
+    return std::string(
+        std::istreambuf_iterator<char>(in),
+        std::istreambuf_iterator<char>());
+}
+
+//
+// Everything written to pFile so far, from the start.
+//
+inline
+std::string ReadAll(std::FILE* pFile)
+{
+    std::rewind(pFile);
+
+    std::string contents;
+    char buffer[4096];
+    for (size_t read; (read = std::fread(buffer, 1, sizeof(buffer), pFile));)
+    {
+        contents.append(buffer, read);
+    }
+
+    return contents;
+}
@@ -0,0 +1,173 @@
+#include <gtest/gtest.h>
+
+#include <lib/Batch.h>
+#include <lib/Cell.h>
+#include <lib/GOLGrid.h>
+
+#include "TestPatterns.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+static
+void WriteLifeFile(const std::string& path, const std::vector<gol::CellAddress>& cells)
+{
+    std::ofstream out(path, std::ios::binary);
+    out << "#Life 1.06\n";
+    for (const auto& Address : cells)
+    {
+        out << Address.first << " " << Address.second << "\n";
+    }
+}
+
+TEST(BatchTests, ClearedGridMatchesFreshGrid)
+{
+    const auto First = GenerateSoup(-20, 20, 0.4, 1);
+    const auto Second = GenerateSoup(-15, 15, 0.4, 2);
+
+    gol::GOLGrid reusedGrid(First);
+    reusedGrid.SetCycleDetection(true);
+    reusedGrid.SetRegionFreezing(true);
+    reusedGrid.AdvanceGenerations(500);
+
+    reusedGrid.Clear();
+    ASSERT_EQ(reusedGrid.GetGeneration(), 0u);
+    ASSERT_TRUE(reusedGrid.GetLiveCells().empty());
+    ASSERT_EQ(reusedGrid.GetFrozenRegionCount(), 0u);
+
+    reusedGrid.InsertLiveCells(std::begin(Second), std::end(Second));
+    gol::GOLGrid freshGrid(Second);
+    freshGrid.SetCycleDetection(true);
+    freshGrid.SetRegionFreezing(true);
+
+    reusedGrid.AdvanceGenerations(1000);
+    freshGrid.AdvanceGenerations(1000);
+    ASSERT_EQ(reusedGrid.GetGeneration(), freshGrid.GetGeneration());
+    ASSERT_EQ(reusedGrid.GetCycle().Period, freshGrid.GetCycle().Period);
+    ASSERT_EQ(SortedLiveCells(reusedGrid), SortedLiveCells(freshGrid));
+}
+
+TEST(BatchTests, ReportsEveryPatternInOrder)
+{
+    //
+    // Inputs are listed relative to the manifest, and one of them is missing.
+    //
+    const std::string Directory{testing::TempDir() + "gol_batch"};
+    std::filesystem::create_directories(Directory);
+
+    const size_t NumPatterns{24};
+    const size_t MissingIndex{5};
+    std::vector<std::vector<gol::CellAddress>> patterns;
+    {
+        std::ofstream manifest(Directory + "/manifest.txt");
+        manifest << "# soups\n\n";
+        for (size_t i = 0; i < NumPatterns; ++i)
+        {
+            const std::string Name{"soup" + std::to_string(i) + ".life"};
+            manifest << Name << "\n";
+
+            patterns.push_back(GenerateSoup(0, 11, 0.45, 100 + i));
+            if (i != MissingIndex)
+            {
+                WriteLifeFile(Directory + "/" + Name, patterns.back());
+            }
+        }
+    }
+
+    std::vector<std::string> inputs;
+    std::string error;
+    ASSERT_TRUE(gol::ReadBatchInputs(Directory + "/manifest.txt", inputs, error)) << error;
+    ASSERT_EQ(inputs.size(), NumPatterns);
+
+    gol::BatchSettings settings;
+    settings.NumGenerations = 300;
+    settings.NumThreads = 4;
+    settings.KeepLiveCells = true;
+
+    std::vector<size_t> order;
+    std::vector<gol::BatchResult> results;
+    gol::RunBatch(inputs, settings, [&](size_t index, const gol::BatchResult& result)
+    {
+        order.push_back(index);
+        results.push_back(result);
+    });
+
+    ASSERT_EQ(order.size(), NumPatterns);
+    for (size_t i = 0; i < NumPatterns; ++i)
+    {
+        ASSERT_EQ(order[i], i);
+        if (i == MissingIndex)
+        {
+            ASSERT_FALSE(results[i].Error.empty());
+            continue;
+        }
+
+        gol::GOLGrid grid(patterns[i]);
+        for (size_t generation = 0; generation < settings.NumGenerations; ++generation)
+        {
+            grid.AdvanceGeneration();
+        }
+
+        const auto Expected = SortedLiveCells(grid);
+        ASSERT_TRUE(results[i].Error.empty()) << results[i].Error;
+        ASSERT_EQ(results[i].Generation, settings.NumGenerations);
+        ASSERT_EQ(results[i].Population, Expected.size());
+        ASSERT_EQ(results[i].LiveCells, Expected) << i;
+    }
+
+    std::filesystem::remove_all(Directory);
+}
+
+TEST(BatchTests, ListsDirectories)
+{
+    const std::string Directory{testing::TempDir() + "gol_batch_directory"};
+    std::filesystem::create_directories(Directory);
+    WriteLifeFile(Directory + "/b.life", { { 0, 0 } });
+    WriteLifeFile(Directory + "/a.life", { { 0, 0 } });
+    WriteLifeFile(Directory + "/notes.txt", { { 0, 0 } });
+
+    std::vector<std::string> inputs;
+    std::string error;
+    ASSERT_TRUE(gol::ReadBatchInputs(Directory, inputs, error)) << error;
+    ASSERT_EQ(inputs.size(), 2u);
+    ASSERT_EQ(std::filesystem::path(inputs[0]).filename(), "a.life");
+    ASSERT_EQ(std::filesystem::path(inputs[1]).filename(), "b.life");
+
+    std::filesystem::remove_all(Directory);
+    ASSERT_FALSE(gol::ReadBatchInputs(Directory + "/manifest.txt", inputs, error));
+}
+
+TEST(BatchTests, WritesJsonLines)
+{
+    const std::string Path{testing::TempDir() + "gol_batch.jsonl"};
+    {
+        std::unique_ptr<std::FILE, int(*)(std::FILE*)> pFile(
+            std::fopen(Path.c_str(), "wb"),
+            &std::fclose);
+        ASSERT_TRUE(pFile);
+
+        gol::BatchWriter writer(pFile.get());
+
+        gol::BatchResult blinker;
+        blinker.Generation = 10;
+        blinker.Population = 3;
+        blinker.Cycle.Period = 2;
+        blinker.LiveCells = { { -1, 0 }, { 0, 0 }, { 1, 0 } };
+        writer.WriteResult("blinker.life", blinker);
+
+        gol::BatchResult failure;
+        failure.Error = "Could not open \"x\\y\"\n";
+        writer.WriteResult("x\\y", failure);
+        ASSERT_TRUE(writer.Flush());
+    }
+
+    ASSERT_EQ(
+        ReadAll(Path),
+        "{\"input\":\"blinker.life\",\"generation\":10,\"population\":3,"
+        "\"period\":2,\"dx\":0,\"dy\":0,\"cells\":[[-1,0],[0,0],[1,0]]}\n"
+        "{\"input\":\"x\\\\y\",\"error\":\"Could not open \\\"x\\\\y\\\"\\u000a\"}\n");
+    std::remove(Path.c_str());
+}
@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+
+#include <lib/Cell.h>
+#include <lib/Checkpoint.h>
+#include <lib/GOLGrid.h>
+
+#include "TestPatterns.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+static
+std::string CheckpointPath(const std::string& name)
+{
+    return testing::TempDir() + "gol_" + name + ".ckpt";
+}
+
+TEST(CheckpointTests, RoundTripsExtremeCoordinates)
+{
+    const std::vector<gol::CellAddress> Cells = {
+        { INT64_MAX, INT64_MIN }, { 0, 0 }, { INT64_MIN, INT64_MAX },
+        { -1, 5 }, { -1, -5 }, { INT64_MIN, INT64_MIN }
+    };
+    const std::string Path = CheckpointPath("extreme");
+
+    std::string error;
+    ASSERT_TRUE(gol::SaveCheckpoint(
+        Path, 12345, gol::CheckpointEngine::HashLife, Cells, error)) << error;
+
+    gol::CheckpointInfo info;
+    std::vector<gol::CellAddress> loaded;
+    ASSERT_TRUE(gol::LoadCheckpoint(Path, info, loaded, error)) << error;
+
+    auto expected = Cells;
+    std::sort(std::begin(expected), std::end(expected));
+    ASSERT_EQ(loaded, expected);
+    ASSERT_EQ(info.Generation, 12345u);
+    ASSERT_EQ(info.Engine, gol::CheckpointEngine::HashLife);
+    ASSERT_EQ(info.NumCells, Cells.size());
+    ASSERT_EQ(info.Min, gol::CellAddress(INT64_MIN, INT64_MIN));
+    ASSERT_EQ(info.Max, gol::CellAddress(INT64_MAX, INT64_MAX));
+
+    std::remove(Path.c_str());
+}
+
+//
+// Stopping, checkpointing and resuming must land on the same state as an
+// uninterrupted run.
+//
+TEST(CheckpointTests, ResumedRunMatchesUninterrupted)
+{
+    const auto InitialCells = GenerateSoup(-40, 40, 0.3, 5);
+    const std::string Path = CheckpointPath("resume");
+
+    gol::GOLGrid grid(InitialCells);
+    for (size_t i = 0; i < 30; ++i) { grid.AdvanceGeneration(); }
+
+    std::vector<gol::CellAddress> liveCells;
+    grid.ForEachLiveCell([&liveCells](const gol::CellAddress& address)
+    {
+        liveCells.push_back(address);
+    });
+
+    std::string error;
+    ASSERT_TRUE(gol::SaveCheckpoint(
+        Path, 30, gol::CheckpointEngine::Sparse, liveCells, error)) << error;
+
+    gol::CheckpointInfo info;
+    std::vector<gol::CellAddress> loaded;
+    ASSERT_TRUE(gol::LoadCheckpoint(Path, info, loaded, error)) << error;
+    ASSERT_EQ(info.Generation, 30u);
+
+    gol::GOLGrid resumedGrid(loaded);
+    for (size_t i = 0; i < 30; ++i)
+    {
+        grid.AdvanceGeneration();
+        resumedGrid.AdvanceGeneration();
+    }
+
+    const auto Expected = grid.GetAllCells();
+    const auto Actual = resumedGrid.GetAllCells();
+    ASSERT_EQ(Expected.size(), Actual.size());
+    for (size_t i = 0; i < Expected.size(); ++i)
+    {
+        ASSERT_EQ(Expected[i].Address, Actual[i].Address);
+        ASSERT_EQ(Expected[i].Alive, Actual[i].Alive);
+        ASSERT_EQ(Expected[i].NeighborCount, Actual[i].NeighborCount);
+    }
+
+    std::remove(Path.c_str());
+}
+
+TEST(CheckpointTests, RejectsCorruptFiles)
+{
+    const std::string Path = CheckpointPath("corrupt");
+
+    std::string error;
+    ASSERT_TRUE(gol::SaveCheckpoint(
+        Path,
+        1,
+        gol::CheckpointEngine::Sparse,
+        GenerateSoup(-10, 10, 0.5, 3),
+        error)) << error;
+
+    std::vector<char> contents;
+    {
+        std::FILE* pFile = std::fopen(Path.c_str(), "rb");
+        ASSERT_NE(pFile, nullptr);
+        for (int c; (c = std::fgetc(pFile)) != EOF;)
+        {
+            contents.push_back(static_cast<char>(c));
+        }
+        std::fclose(pFile);
+    }
+
+    auto WriteAndLoad = [&Path](const std::vector<char>& bytes)
+    {
+        std::FILE* pFile = std::fopen(Path.c_str(), "wb");
+        std::fwrite(bytes.data(), 1, bytes.size(), pFile);
+        std::fclose(pFile);
+
+        gol::CheckpointInfo info;
+        std::vector<gol::CellAddress> cells;
+        std::string loadError;
+        return gol::LoadCheckpoint(Path, info, cells, loadError);
+    };
+
+    ASSERT_TRUE(WriteAndLoad(contents));
+
+    auto truncated = contents;
+    truncated.pop_back();
+    ASSERT_FALSE(WriteAndLoad(truncated));
+
+    auto badMagic = contents;
+    badMagic[0] = 'X';
+    ASSERT_FALSE(WriteAndLoad(badMagic));
+
+    ASSERT_FALSE(WriteAndLoad({}));
+
+    std::remove(Path.c_str());
+}
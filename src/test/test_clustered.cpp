@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+
+#include <lib/Cell.h>
+#include <lib/ClusteredGrid.h>
+#include <lib/GOLGrid.h>
+
+#include "TestPatterns.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+
+static
+void AddShifted(
+    std::vector<gol::CellAddress>& cells,
+    const std::vector<gol::CellAddress>& pattern,
+    int64_t dx,
+    int64_t dy)
+{
+    for (const auto& Address : pattern)
+    {
+        cells.emplace_back(Address.first + dx, Address.second + dy);
+    }
+}
+
+class ClusteredGridTests : public ::testing::TestWithParam<size_t> {};
+
+//
+// Soups far apart, two gliders which fly apart and split into two clusters,
+// and two which meet head on and merge into one.
+//
+TEST_P(ClusteredGridTests, MatchesSparseGrid)
+{
+    const std::vector<gol::CellAddress> Glider = {
+        { 1, 0 }, { 2, 1 }, { 0, 2 }, { 1, 2 }, { 2, 2 }
+    };
+    const std::vector<gol::CellAddress> OppositeGlider = {
+        { 1, 2 }, { 0, 1 }, { 2, 0 }, { 1, 0 }, { 0, 0 }
+    };
+
+    std::vector<gol::CellAddress> initialCells;
+    AddShifted(initialCells, GenerateSoup(0, 15, 0.4, 3), 0, 0);
+    AddShifted(initialCells, GenerateSoup(0, 15, 0.4, 4), 2000000000000, -2000000000000);
+    AddShifted(initialCells, OppositeGlider, 5000, 0);
+    AddShifted(initialCells, Glider, 5010, 10);
+    AddShifted(initialCells, Glider, -700, -700);
+    AddShifted(initialCells, OppositeGlider, -300, -300);
+
+    gol::GOLGrid sparseGrid(initialCells);
+    gol::ClusteredGrid clusteredGrid(initialCells, GetParam());
+    const size_t InitialClusters{clusteredGrid.GetClusterCount()};
+    ASSERT_EQ(InitialClusters, 5u);
+
+    size_t maxClusters{0};
+    for (size_t generation = 0; generation < 800; ++generation)
+    {
+        const auto Expected = sparseGrid.GetLiveCells();
+        const auto Actual = clusteredGrid.GetLiveCells();
+        ASSERT_EQ(Expected.size(), Actual.size()) << "generation " << generation;
+        for (size_t i = 0; i < Expected.size(); ++i)
+        {
+            ASSERT_EQ(Expected[i].Address, Actual[i].Address);
+            ASSERT_EQ(Expected[i].NeighborCount, Actual[i].NeighborCount);
+        }
+
+        maxClusters = std::max(maxClusters, clusteredGrid.GetClusterCount());
+        sparseGrid.AdvanceGeneration();
+        clusteredGrid.AdvanceGeneration();
+    }
+
+    ASSERT_GT(maxClusters, InitialClusters);
+    ASSERT_LT(clusteredGrid.GetClusterCount(), maxClusters);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    ThreadCounts,
+    ClusteredGridTests,
+    ::testing::Values(1, 4));
+
+TEST(ClusteredGridTests, MergesClustersWhichCouldInteract)
+{
+    //
+    // Two blocks 40 cells apart are too close to keep on separate boards;
+    // two blocks 1000 cells apart aren't.
+    //
+    const std::vector<gol::CellAddress> Block = {
+        { 0, 0 }, { 1, 0 }, { 0, 1 }, { 1, 1 }
+    };
+
+    std::vector<gol::CellAddress> near;
+    AddShifted(near, Block, 0, 0);
+    AddShifted(near, Block, 40, 0);
+    ASSERT_EQ(gol::ClusteredGrid(near).GetClusterCount(), 1u);
+
+    std::vector<gol::CellAddress> far;
+    AddShifted(far, Block, 0, 0);
+    AddShifted(far, Block, 1000, 0);
+    ASSERT_EQ(gol::ClusteredGrid(far).GetClusterCount(), 2u);
+}
+
+TEST(ClusteredGridTests, RejectsCellsAtEdgeOfPlane)
+{
+    const std::vector<gol::CellAddress> Cells = { { INT64_MAX, 0 } };
+    ASSERT_THROW(gol::ClusteredGrid grid(Cells), std::out_of_range);
+}
@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+
+#include <lib/Cell.h>
+#include <lib/GOLGrid.h>
+#include <lib/HashLifeGrid.h>
+
+#include "TestPatterns.h"
+
+#include <string>
+
+TEST(CycleDetectionTests, FindsBlinkerPeriod)
+{
+    gol::GOLGrid grid({ { -1, 0 }, { 0, 0 }, { 1, 0 } });
+    grid.SetCycleDetection(true);
+    grid.AdvanceGenerations(10);
+
+    ASSERT_EQ(grid.GetCycle().Period, 2u);
+    ASSERT_EQ(grid.GetCycle().Offset, gol::CellAddress(0, 0));
+    ASSERT_EQ(grid.GetGeneration(), 10u);
+}
+
+//
+// A glider repeats shifted by one cell diagonally every four generations, so
+// a huge jump lands it far away without computing the generations between.
+//
+TEST(CycleDetectionTests, SkipsAheadForSpaceships)
+{
+    const std::vector<gol::CellAddress> Glider = {
+        { 0, 1 }, { 1, 2 }, { 2, 0 }, { 2, 1 }, { 2, 2 }
+    };
+    const uint64_t NumGenerations{1000000000003};
+
+    gol::GOLGrid grid(Glider, 2);
+    grid.SetCycleDetection(true);
+    grid.AdvanceGenerations(NumGenerations);
+
+    ASSERT_EQ(grid.GetCycle().Period, 4u);
+    ASSERT_EQ(grid.GetCycle().Offset, gol::CellAddress(1, 1));
+    ASSERT_EQ(grid.GetGeneration(), NumGenerations);
+
+    gol::HashLifeGrid hashLifeGrid(Glider);
+    hashLifeGrid.AdvanceGenerations(NumGenerations);
+    ASSERT_EQ(
+        AddressesOf(grid.GetLiveCells()),
+        AddressesOf(hashLifeGrid.GetLiveCells()));
+
+    //
+    // The rebuilt board keeps evolving normally.
+    //
+    grid.AdvanceGeneration();
+    hashLifeGrid.AdvanceGeneration();
+    ASSERT_EQ(
+        AddressesOf(grid.GetLiveCells()),
+        AddressesOf(hashLifeGrid.GetLiveCells()));
+}
+
+TEST(CycleDetectionTests, MatchesSteppingAfterSettling)
+{
+    //
+    // The pi-heptomino settles into still lifes and blinkers without
+    // emitting any gliders, so the whole board ends up periodic.
+    //
+    const std::vector<gol::CellAddress> PiHeptomino = {
+        { 0, 0 }, { 1, 0 }, { 2, 0 }, { 0, 1 }, { 2, 1 }, { 0, 2 }, { 2, 2 }
+    };
+
+    gol::GOLGrid detectingGrid(PiHeptomino);
+    detectingGrid.SetCycleDetection(true);
+    detectingGrid.AdvanceGenerations(1001);
+
+    gol::GOLGrid steppingGrid(PiHeptomino);
+    for (size_t i = 0; i < 1001; ++i) { steppingGrid.AdvanceGeneration(); }
+
+    ASSERT_NE(detectingGrid.GetCycle().Period, 0u);
+    ASSERT_EQ(
+        AddressesOf(detectingGrid.GetLiveCells()),
+        AddressesOf(steppingGrid.GetLiveCells()));
+}
+
+TEST(CycleDetectionTests, InsertingCellsForgetsCycle)
+{
+    gol::GOLGrid grid({ { 0, 0 }, { 1, 0 }, { 0, 1 }, { 1, 1 } });
+    grid.SetCycleDetection(true);
+    grid.AdvanceGenerations(3);
+    ASSERT_EQ(grid.GetCycle().Period, 1u);
+
+    const std::vector<gol::CellAddress> Blinker = {
+        { 10, 0 }, { 11, 0 }, { 12, 0 }
+    };
+    grid.InsertLiveCells(std::begin(Blinker), std::end(Blinker));
+    ASSERT_EQ(grid.GetCycle().Period, 0u);
+
+    grid.AdvanceGenerations(5);
+    ASSERT_EQ(grid.GetCycle().Period, 2u);
+}
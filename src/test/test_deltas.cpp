@@ -0,0 +1,199 @@
+#include <gtest/gtest.h>
+
+#include <lib/Cell.h>
+#include <lib/DeltaStream.h>
+#include <lib/GOLGrid.h>
+
+#include "TestPatterns.h"
+
+#include <cstdio>
+#include <limits>
+#include <set>
+#include <string>
+
+static
+void RecordGeneration(
+    const gol::GOLGrid& grid,
+    uint64_t generation,
+    gol::DeltaWriter& writer)
+{
+    std::vector<gol::CellAddress> births;
+    std::vector<gol::CellAddress> deaths;
+    grid.ForEachChange([&](const gol::CellAddress& address, bool alive)
+    {
+        (alive ? births : deaths).push_back(address);
+    });
+
+    writer.WriteGeneration(generation, births, deaths);
+}
+
+TEST(DeltaStreamTests, WritesBlinkerAsText)
+{
+    std::FILE* pFile = std::tmpfile();
+    ASSERT_NE(pFile, nullptr);
+
+    {
+        gol::GOLGrid grid({ { -1, 0 }, { 0, 0 }, { 1, 0 } });
+        gol::DeltaWriter writer(pFile, gol::DeltaFormat::Text);
+
+        std::vector<gol::CellAddress> births = { { 1, 0 }, { 0, 0 }, { -1, 0 } };
+        std::vector<gol::CellAddress> deaths;
+        writer.WriteGeneration(0, births, deaths);
+
+        grid.AdvanceGeneration();
+        RecordGeneration(grid, 1, writer);
+        ASSERT_TRUE(writer.Flush());
+    }
+
+    const std::string Expected =
+        "#Life deltas\n"
+        "G 0\n"
+        "+-1 0\n"
+        "+0 0\n"
+        "+1 0\n"
+        "G 1\n"
+        "+0 -1\n"
+        "+0 1\n"
+        "--1 0\n"
+        "-1 0\n";
+    ASSERT_EQ(ReadAll(pFile), Expected);
+
+    std::fclose(pFile);
+}
+
+//
+// Replaying the binary stream must reproduce every generation of a threaded
+// run exactly.
+//
+TEST(DeltaStreamTests, BinaryStreamReconstructsEveryGeneration)
+{
+    const auto InitialCells = GenerateSoup(-40, 40, 0.3, 17);
+    gol::GOLGrid grid(InitialCells, 3);
+
+    std::vector<std::set<gol::CellAddress>> expected;
+    std::FILE* pFile = std::tmpfile();
+    ASSERT_NE(pFile, nullptr);
+
+    {
+        gol::DeltaWriter writer(pFile, gol::DeltaFormat::Binary, 256);
+
+        auto births = InitialCells;
+        std::vector<gol::CellAddress> deaths;
+        writer.WriteGeneration(0, births, deaths);
+
+        for (uint64_t generation = 0; generation <= 60; ++generation)
+        {
+            if (generation)
+            {
+                grid.AdvanceGeneration();
+                RecordGeneration(grid, generation, writer);
+            }
+
+            std::set<gol::CellAddress> liveCells;
+            grid.ForEachLiveCell([&liveCells](const gol::CellAddress& address)
+            {
+                liveCells.insert(address);
+            });
+            expected.push_back(liveCells);
+        }
+    }
+
+    const std::string Stream = ReadAll(pFile);
+    std::fclose(pFile);
+
+    std::set<gol::CellAddress> replayed;
+    uint64_t nextGeneration{0};
+    std::string error;
+    ASSERT_TRUE(gol::ReadDeltaStream(
+        Stream.data(),
+        Stream.size(),
+        [&](uint64_t generation,
+            const std::vector<gol::CellAddress>& births,
+            const std::vector<gol::CellAddress>& deaths)
+        {
+            ASSERT_EQ(generation, nextGeneration);
+            for (const auto& Address : deaths)
+            {
+                ASSERT_EQ(replayed.erase(Address), 1u);
+            }
+            for (const auto& Address : births)
+            {
+                ASSERT_TRUE(replayed.insert(Address).second);
+            }
+            ASSERT_EQ(replayed, expected[nextGeneration]);
+            ++nextGeneration;
+        },
+        error)) << error;
+    ASSERT_EQ(nextGeneration, expected.size());
+
+    ASSERT_FALSE(gol::ReadDeltaStream(
+        Stream.data(),
+        Stream.size() - 1,
+        [](uint64_t,
+           const std::vector<gol::CellAddress>&,
+           const std::vector<gol::CellAddress>&) {},
+        error));
+}
+
+//
+// The text format reads back the same records, down to the most negative
+// coordinates, and rejects lines it doesn't understand.
+//
+TEST(DeltaStreamTests, TextStreamRoundTrips)
+{
+    const int64_t Min{std::numeric_limits<int64_t>::min()};
+    const int64_t Max{std::numeric_limits<int64_t>::max()};
+    const uint64_t LastGeneration{std::numeric_limits<uint64_t>::max()};
+
+    std::FILE* pFile = std::tmpfile();
+    ASSERT_NE(pFile, nullptr);
+
+    {
+        gol::DeltaWriter writer(pFile, gol::DeltaFormat::Text);
+
+        std::vector<gol::CellAddress> births = { { Min, Max }, { 0, Min } };
+        std::vector<gol::CellAddress> deaths;
+        writer.WriteGeneration(0, births, deaths);
+
+        births.clear();
+        deaths = { { Min, Max } };
+        writer.WriteGeneration(LastGeneration, births, deaths);
+        ASSERT_TRUE(writer.Flush());
+    }
+
+    const std::string Stream = ReadAll(pFile);
+    std::fclose(pFile);
+
+    std::vector<uint64_t> generations;
+    std::vector<std::vector<gol::CellAddress>> allBirths;
+    std::vector<std::vector<gol::CellAddress>> allDeaths;
+    std::string error;
+    ASSERT_TRUE(gol::ReadDeltaStream(
+        Stream.data(),
+        Stream.size(),
+        [&](uint64_t generation,
+            const std::vector<gol::CellAddress>& births,
+            const std::vector<gol::CellAddress>& deaths)
+        {
+            generations.push_back(generation);
+            allBirths.push_back(births);
+            allDeaths.push_back(deaths);
+        },
+        error)) << error;
+
+    const std::vector<uint64_t> ExpectedGenerations = { 0, LastGeneration };
+    ASSERT_EQ(generations, ExpectedGenerations);
+    ASSERT_EQ(allBirths[0], (std::vector<gol::CellAddress>{ { Min, Max }, { 0, Min } }));
+    ASSERT_TRUE(allDeaths[0].empty());
+    ASSERT_TRUE(allBirths[1].empty());
+    ASSERT_EQ(allDeaths[1], (std::vector<gol::CellAddress>{ { Min, Max } }));
+
+    const std::string Malformed = "#Life deltas\nG 0\n+1 x\n";
+    ASSERT_FALSE(gol::ReadDeltaStream(
+        Malformed.data(),
+        Malformed.size(),
+        [](uint64_t,
+           const std::vector<gol::CellAddress>&,
+           const std::vector<gol::CellAddress>&) {},
+        error));
+}
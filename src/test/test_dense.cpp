@@ -0,0 +1,268 @@
+#include <gtest/gtest.h>
+
+#include <lib/Cell.h>
+#include <lib/DenseGrid.h>
+#include <lib/GOLGrid.h>
+
+#include "TestPatterns.h"
+
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+
+static
+gol::DenseBounds MakeBounds(
+    int64_t originX,
+    int64_t originY,
+    int64_t width,
+    int64_t height,
+    gol::DenseTopology topology)
+{
+    gol::DenseBounds bounds;
+    bounds.Origin = gol::CellAddress(originX, originY);
+    bounds.Width = width;
+    bounds.Height = height;
+    bounds.Topology = topology;
+    return bounds;
+}
+
+class DenseKernelTests : public ::testing::TestWithParam<gol::DenseGrid::Kernel>
+{
+protected:
+    void SetUp() override
+    {
+        if (!gol::DenseGrid::IsKernelSupported(GetParam()))
+        {
+            GTEST_SKIP() << "Kernel not supported on this CPU.";
+        }
+    }
+};
+
+TEST_P(DenseKernelTests, MatchesSparseGridWithinBounds)
+{
+    //
+    // The soup can't reach the edges of the board in the generations run,
+    // and the board's width isn't a whole number of words.
+    //
+    const auto InitialCells = GenerateSoup(-20, 20, 0.35, 42);
+    gol::GOLGrid sparseGrid(InitialCells);
+    gol::DenseGrid denseGrid(
+        InitialCells,
+        MakeBounds(-101, -99, 203, 201, gol::DenseTopology::Bounded));
+    denseGrid.SetKernel(GetParam());
+
+    for (size_t generation = 0; generation < 150; ++generation)
+    {
+        const auto Expected = sparseGrid.GetLiveCells();
+        const auto Actual = denseGrid.GetLiveCells();
+        ASSERT_EQ(Expected.size(), Actual.size()) << "generation " << generation;
+        for (size_t i = 0; i < Expected.size(); ++i)
+        {
+            ASSERT_EQ(Expected[i].Address, Actual[i].Address);
+            ASSERT_EQ(Expected[i].NeighborCount, Actual[i].NeighborCount);
+        }
+
+        sparseGrid.AdvanceGeneration();
+        denseGrid.AdvanceGeneration();
+    }
+}
+
+TEST_P(DenseKernelTests, GliderWrapsAroundTorus)
+{
+    //
+    // A glider moves one cell diagonally every four generations, so after
+    // 4 * size generations it is back where it started. 64 fills its words
+    // exactly; 70 spills into a second one.
+    //
+    const std::vector<gol::CellAddress> Glider = {
+        { 1, 0 }, { 2, 1 }, { 0, 2 }, { 1, 2 }, { 2, 2 }
+    };
+
+    for (const int64_t Size : { 64, 70 })
+    {
+        gol::DenseGrid grid(
+            Glider,
+            MakeBounds(0, 0, Size, Size, gol::DenseTopology::Torus));
+        grid.SetKernel(GetParam());
+
+        for (int64_t i = 0; i < 4 * Size; ++i)
+        {
+            grid.AdvanceGeneration();
+
+            //
+            // Part way across an edge, the glider is split between opposite
+            // sides of the board.
+            //
+            ASSERT_EQ(grid.GetLiveCells().size(), Glider.size()) << Size << " " << i;
+        }
+
+        std::vector<gol::CellAddress> expected(Glider);
+        std::sort(std::begin(expected), std::end(expected));
+
+        const auto LiveCells = grid.GetLiveCells();
+        for (size_t i = 0; i < expected.size(); ++i)
+        {
+            ASSERT_EQ(LiveCells[i].Address, expected[i]) << Size;
+        }
+    }
+}
+
+//
+// The board is tall enough to be split into strips, and the generation count
+// isn't a multiple of the generations per strip pass.
+//
+TEST_P(DenseKernelTests, BlockedGenerationsMatchSingleSteps)
+{
+    for (const auto Topology : { gol::DenseTopology::Bounded, gol::DenseTopology::Torus })
+    {
+        const auto Bounds = MakeBounds(-1500, -700, 3000, 1500, Topology);
+
+        std::mt19937_64 rng(17);
+        std::bernoulli_distribution alive(0.3);
+        std::vector<gol::CellAddress> initialCells;
+        for (int64_t y = 0; y < Bounds.Height; ++y)
+        {
+            for (int64_t x = 0; x < Bounds.Width; ++x)
+            {
+                if (alive(rng))
+                {
+                    initialCells.emplace_back(Bounds.Origin.first + x, Bounds.Origin.second + y);
+                }
+            }
+        }
+
+        gol::DenseGrid steppedGrid(initialCells, Bounds);
+        gol::DenseGrid blockedGrid(initialCells, Bounds);
+        steppedGrid.SetKernel(GetParam());
+        blockedGrid.SetKernel(GetParam());
+
+        const uint64_t NumGenerations{37};
+        for (uint64_t i = 0; i < NumGenerations; ++i) { steppedGrid.AdvanceGeneration(); }
+        blockedGrid.AdvanceGenerations(NumGenerations);
+
+        std::vector<gol::CellAddress> expected;
+        steppedGrid.ForEachLiveCell([&expected](const gol::CellAddress& address)
+        {
+            expected.push_back(address);
+        });
+        std::vector<gol::CellAddress> actual;
+        blockedGrid.ForEachLiveCell([&actual](const gol::CellAddress& address)
+        {
+            actual.push_back(address);
+        });
+        ASSERT_EQ(actual, expected);
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Kernels,
+    DenseKernelTests,
+    ::testing::Values(gol::DenseGrid::Kernel::Scalar, gol::DenseGrid::Kernel::Avx2));
+
+TEST(DenseGridTests, KernelsAgree)
+{
+    if (!gol::DenseGrid::IsKernelSupported(gol::DenseGrid::Kernel::Avx2))
+    {
+        GTEST_SKIP() << "AVX2 not supported on this CPU.";
+    }
+
+    //
+    // A dense soup filling a torus, wide enough for the vector loop and a
+    // scalar tail.
+    //
+    const auto InitialCells = GenerateSoup(0, 299, 0.5, 7);
+    std::vector<gol::CellAddress> onBoard;
+    std::copy_if(
+        std::begin(InitialCells),
+        std::end(InitialCells),
+        std::back_inserter(onBoard),
+        [](const gol::CellAddress& address) { return address.second < 40; });
+
+    const auto Bounds = MakeBounds(0, 0, 300, 40, gol::DenseTopology::Torus);
+    gol::DenseGrid scalarGrid(onBoard, Bounds);
+    scalarGrid.SetKernel(gol::DenseGrid::Kernel::Scalar);
+    gol::DenseGrid avx2Grid(onBoard, Bounds);
+    avx2Grid.SetKernel(gol::DenseGrid::Kernel::Avx2);
+
+    for (size_t generation = 0; generation < 100; ++generation)
+    {
+        scalarGrid.AdvanceGeneration();
+        avx2Grid.AdvanceGeneration();
+
+        std::vector<gol::CellAddress> scalarCells;
+        scalarGrid.ForEachLiveCell([&](const gol::CellAddress& a) { scalarCells.push_back(a); });
+        std::vector<gol::CellAddress> avx2Cells;
+        avx2Grid.ForEachLiveCell([&](const gol::CellAddress& a) { avx2Cells.push_back(a); });
+        ASSERT_EQ(scalarCells, avx2Cells) << generation;
+    }
+}
+
+TEST(DenseGridTests, BoundedEdgesAreDead)
+{
+    //
+    // A blinker lying along the top edge loses the cells that would have
+    // been born off the board, leaving a single cell which then dies.
+    //
+    const std::vector<gol::CellAddress> Blinker = { { 4, 0 }, { 5, 0 }, { 6, 0 } };
+    gol::DenseGrid grid(Blinker, MakeBounds(0, 0, 10, 10, gol::DenseTopology::Bounded));
+
+    grid.AdvanceGeneration();
+    const auto LiveCells = grid.GetLiveCells();
+    ASSERT_EQ(LiveCells.size(), 2u);
+    ASSERT_EQ(LiveCells[0].Address, gol::CellAddress(5, 0));
+    ASSERT_EQ(LiveCells[1].Address, gol::CellAddress(5, 1));
+
+    grid.AdvanceGeneration();
+    ASSERT_TRUE(grid.GetLiveCells().empty());
+}
+
+TEST(DenseGridTests, RejectsCellsOutsideBoard)
+{
+    const auto Bounds = MakeBounds(-5, -5, 10, 10, gol::DenseTopology::Bounded);
+    ASSERT_NO_THROW(gol::DenseGrid({ { -5, -5 }, { 4, 4 } }, Bounds));
+    ASSERT_THROW(gol::DenseGrid({ { 5, 0 } }, Bounds), std::out_of_range);
+    ASSERT_THROW(gol::DenseGrid({ { 0, -6 } }, Bounds), std::out_of_range);
+    ASSERT_THROW(
+        gol::DenseGrid({}, MakeBounds(0, 0, 0, 10, gol::DenseTopology::Bounded)),
+        std::invalid_argument);
+}
+
+TEST(DenseGridTests, ParsesBounds)
+{
+    gol::DenseBounds bounds;
+    std::string error;
+
+    ASSERT_TRUE(gol::ParseDenseBounds("256x128", gol::DenseTopology::Torus, bounds, error));
+    ASSERT_EQ(bounds.Width, 256);
+    ASSERT_EQ(bounds.Height, 128);
+    ASSERT_EQ(bounds.Origin, gol::CellAddress(0, 0));
+    ASSERT_EQ(bounds.Topology, gol::DenseTopology::Torus);
+
+    ASSERT_TRUE(gol::ParseDenseBounds("10x20@-5,7", gol::DenseTopology::Bounded, bounds, error));
+    ASSERT_EQ(bounds.Width, 10);
+    ASSERT_EQ(bounds.Height, 20);
+    ASSERT_EQ(bounds.Origin, gol::CellAddress(-5, 7));
+    ASSERT_EQ(bounds.Topology, gol::DenseTopology::Bounded);
+
+    for (const char* pText : { "", "10", "10x", "x10", "0x10", "10x-1", "10x10@", "10x10@1", "10x10@1,", "10 x10" })
+    {
+        ASSERT_FALSE(gol::ParseDenseBounds(pText, gol::DenseTopology::Bounded, bounds, error)) << pText;
+        ASSERT_FALSE(error.empty());
+    }
+}
+
+TEST(DenseGridTests, FindsLiveBounds)
+{
+    gol::DenseGrid grid(
+        { { 70, -3 }, { -2, 5 }, { 130, 9 } },
+        MakeBounds(-10, -10, 150, 30, gol::DenseTopology::Bounded));
+
+    gol::CellAddress min;
+    gol::CellAddress max;
+    ASSERT_TRUE(grid.GetLiveBounds(min, max));
+    ASSERT_EQ(min, gol::CellAddress(-2, -3));
+    ASSERT_EQ(max, gol::CellAddress(130, 9));
+
+    grid.AdvanceGeneration();
+    ASSERT_FALSE(grid.GetLiveBounds(min, max));
+}
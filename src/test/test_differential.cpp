@@ -0,0 +1,372 @@
+//
+// Differential tests: every engine runs each pattern of the corpus in inputs/
+// for thousands of generations, and its live cells must match the reference,
+// a plain single-threaded GOLGrid stepped one generation at a time, at
+// regular checkpoints along the way.
+//
+
+#include <gtest/gtest.h>
+
+#include <lib/Cell.h>
+#include <lib/ClusteredGrid.h>
+#include <lib/DenseGrid.h>
+#include <lib/GOLGrid.h>
+#include <lib/HashLifeGrid.h>
+#include <lib/LifeParser.h>
+#include <lib/Sharded.h>
+#include <lib/TiledGrid.h>
+
+#include "TestPatterns.h"
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+    constexpr uint64_t NumCheckpoints{8};
+    constexpr uint64_t CheckpointInterval{250};
+    constexpr uint64_t NumGenerations{NumCheckpoints * CheckpointInterval};
+
+    //
+    // The dense engine gives every far-apart group of cells its own board,
+    // which must be no wider or higher than this.
+    //
+    constexpr uint64_t MaxDenseSide{4096};
+
+    //
+    // Cells in buckets of this many columns and rows which aren't next to
+    // each other are too far apart to affect one another within
+    // NumGenerations: patterns spread by at most a cell per generation.
+    //
+    constexpr int64_t GroupBucketShift{12};
+    static_assert((int64_t(1) << GroupBucketShift) > 2 * NumGenerations + 2);
+
+    struct Reference
+    {
+        std::vector<gol::CellAddress> InitialCells;
+
+        //
+        // The sorted live cells after each checkpoint interval.
+        //
+        std::vector<std::vector<gol::CellAddress>> Checkpoints;
+
+        //
+        // Covers every live cell of every generation; false if the pattern
+        // died out straight away.
+        //
+        bool             HasBounds = false;
+        gol::CellAddress Min;
+        gol::CellAddress Max;
+    };
+
+    void Include(Reference& reference, const gol::CellAddress& min, const gol::CellAddress& max)
+    {
+        if (!reference.HasBounds)
+        {
+            reference.HasBounds = true;
+            reference.Min = min;
+            reference.Max = max;
+            return;
+        }
+
+        reference.Min.first = std::min(reference.Min.first, min.first);
+        reference.Min.second = std::min(reference.Min.second, min.second);
+        reference.Max.first = std::max(reference.Max.first, max.first);
+        reference.Max.second = std::max(reference.Max.second, max.second);
+    }
+
+    Reference ComputeReference(const std::string& pattern)
+    {
+        Reference reference;
+        const std::string Path{std::string(GOL_TEST_INPUTS_DIR) + "/" + pattern + ".life"};
+        gol::LifeParseError error;
+        EXPECT_TRUE(gol::ParseLifeFile(Path, reference.InitialCells, error))
+            << Path << ": " << error.Message;
+
+        gol::GOLGrid grid(reference.InitialCells);
+        gol::CellAddress min;
+        gol::CellAddress max;
+        for (uint64_t generation = 1; generation <= NumGenerations; ++generation)
+        {
+            if (grid.GetBoundingBox(min, max)) { Include(reference, min, max); }
+            grid.AdvanceGeneration();
+            if (generation % CheckpointInterval == 0)
+            {
+                reference.Checkpoints.push_back(SortedLiveCells(grid));
+            }
+        }
+        if (grid.GetBoundingBox(min, max)) { Include(reference, min, max); }
+
+        return reference;
+    }
+
+    //
+    // Every engine's test needs the same reference runs, so each pattern's
+    // is only computed once per process.
+    //
+    const Reference& RunReference(const std::string& pattern)
+    {
+        static std::map<std::string, Reference> references;
+
+        auto it = references.find(pattern);
+        if (it == references.end())
+        {
+            it = references.emplace(pattern, ComputeReference(pattern)).first;
+        }
+        return it->second;
+    }
+
+    //
+    // Engines which can skip ahead are given a whole interval at a time.
+    //
+    void Advance(gol::GOLGrid& grid, uint64_t numGenerations)
+    {
+        grid.AdvanceGenerations(numGenerations);
+    }
+
+    void Advance(gol::HashLifeGrid& grid, uint64_t numGenerations)
+    {
+        grid.AdvanceGenerations(numGenerations);
+    }
+
+    template<typename GridType>
+    void Advance(GridType& grid, uint64_t numGenerations)
+    {
+        for (uint64_t i = 0; i < numGenerations; ++i) { grid.AdvanceGeneration(); }
+    }
+
+    //
+    // The dense engine on one bounded board per group of cells, each with a
+    // cell to spare around everything its group ever reaches, so that the
+    // edges never come into play.
+    //
+    class DenseBoards
+    {
+    public:
+        void AddBoard(const std::vector<gol::CellAddress>& cells, const gol::DenseBounds& bounds)
+        {
+            m_boards.push_back(std::make_unique<gol::DenseGrid>(cells, bounds));
+        }
+
+        void AdvanceGenerations(uint64_t numGenerations)
+        {
+            for (auto& pBoard : m_boards) { pBoard->AdvanceGenerations(numGenerations); }
+        }
+
+        template<typename Visitor>
+        void ForEachLiveCell(Visitor&& visitor) const
+        {
+            for (const auto& pBoard : m_boards) { pBoard->ForEachLiveCell(visitor); }
+        }
+
+    private:
+        std::vector<std::unique_ptr<gol::DenseGrid>> m_boards;
+    };
+
+    void Advance(DenseBoards& boards, uint64_t numGenerations)
+    {
+        boards.AdvanceGenerations(numGenerations);
+    }
+
+    //
+    // Splits cells into groups which can't reach each other within
+    // NumGenerations: those in neighboring buckets end up together.
+    //
+    std::vector<std::vector<gol::CellAddress>> GroupCells(const std::vector<gol::CellAddress>& cells)
+    {
+        std::map<gol::CellAddress, size_t> bucketIndexes;
+        for (const auto& Address : cells)
+        {
+            bucketIndexes.emplace(
+                gol::CellAddress(Address.first >> GroupBucketShift, Address.second >> GroupBucketShift),
+                bucketIndexes.size());
+        }
+
+        std::vector<size_t> parents(bucketIndexes.size());
+        for (size_t i = 0; i < parents.size(); ++i) { parents[i] = i; }
+        auto Find = [&parents](size_t index)
+        {
+            while (parents[index] != index) { index = parents[index] = parents[parents[index]]; }
+            return index;
+        };
+
+        //
+        // Bucket keys never reach the ends of int64_t.
+        //
+        for (const auto& [Bucket, Index] : bucketIndexes)
+        {
+            for (int64_t dy = -1; dy <= 1; ++dy)
+            {
+                for (int64_t dx = -1; dx <= 1; ++dx)
+                {
+                    const auto It = bucketIndexes.find(
+                        gol::CellAddress(Bucket.first + dx, Bucket.second + dy));
+                    if (It != bucketIndexes.end()) { parents[Find(It->second)] = Find(Index); }
+                }
+            }
+        }
+
+        std::map<size_t, std::vector<gol::CellAddress>> groups;
+        for (const auto& Address : cells)
+        {
+            const gol::CellAddress Bucket(Address.first >> GroupBucketShift, Address.second >> GroupBucketShift);
+            groups[Find(bucketIndexes[Bucket])].push_back(Address);
+        }
+
+        std::vector<std::vector<gol::CellAddress>> grouped;
+        for (auto& [Root, Group] : groups) { grouped.push_back(std::move(Group)); }
+        return grouped;
+    }
+
+    //
+    // A pattern in one piece is covered by the reference's bounds. Otherwise
+    // each group is run on its own to find how far it reaches.
+    //
+    void BuildDenseBoards(const Reference& reference, DenseBoards& boards)
+    {
+        const auto Groups = GroupCells(reference.InitialCells);
+        for (const auto& Group : Groups)
+        {
+            Reference groupReference;
+            if (Groups.size() == 1)
+            {
+                groupReference.HasBounds = reference.HasBounds;
+                groupReference.Min = reference.Min;
+                groupReference.Max = reference.Max;
+            }
+            else
+            {
+                gol::GOLGrid grid(Group);
+                gol::CellAddress min;
+                gol::CellAddress max;
+                for (uint64_t generation = 0; generation <= NumGenerations; ++generation)
+                {
+                    if (grid.GetBoundingBox(min, max)) { Include(groupReference, min, max); }
+                    grid.AdvanceGeneration();
+                }
+            }
+            ASSERT_TRUE(groupReference.HasBounds);
+
+            const uint64_t Width{static_cast<uint64_t>(groupReference.Max.first - groupReference.Min.first) + 3};
+            const uint64_t Height{static_cast<uint64_t>(groupReference.Max.second - groupReference.Min.second) + 3};
+            ASSERT_LE(Width, MaxDenseSide);
+            ASSERT_LE(Height, MaxDenseSide);
+
+            gol::DenseBounds bounds;
+            bounds.Origin = gol::CellAddress(groupReference.Min.first - 1, groupReference.Min.second - 1);
+            bounds.Width = static_cast<int64_t>(Width);
+            bounds.Height = static_cast<int64_t>(Height);
+            boards.AddBoard(Group, bounds);
+        }
+    }
+
+    template<typename GridType>
+    void ExpectMatchesReference(GridType& grid, const Reference& reference)
+    {
+        for (uint64_t checkpoint = 0; checkpoint < NumCheckpoints; ++checkpoint)
+        {
+            Advance(grid, CheckpointInterval);
+            ASSERT_EQ(SortedLiveCells(grid), reference.Checkpoints[checkpoint])
+                << "generation " << (checkpoint + 1) * CheckpointInterval;
+        }
+    }
+}
+
+class DifferentialTests : public ::testing::TestWithParam<const char*> {};
+
+TEST_P(DifferentialTests, Sparse)
+{
+    const auto& Expected = RunReference(GetParam());
+
+    //
+    // Sharded storage, with everything that lets the engine skip work.
+    //
+    gol::GOLGrid grid(Expected.InitialCells, 4);
+    grid.SetCycleDetection(true);
+    grid.SetRegionFreezing(true);
+    ExpectMatchesReference(grid, Expected);
+}
+
+TEST_P(DifferentialTests, SparseSpilling)
+{
+    const auto& Expected = RunReference(GetParam());
+
+    gol::GOLGrid grid(Expected.InitialCells);
+    grid.SetRegionFreezing(true);
+    grid.SetMemoryBudget(1);
+    ExpectMatchesReference(grid, Expected);
+}
+
+TEST_P(DifferentialTests, Tiled)
+{
+    const auto& Expected = RunReference(GetParam());
+
+    gol::TiledGrid grid(Expected.InitialCells);
+    ExpectMatchesReference(grid, Expected);
+}
+
+TEST_P(DifferentialTests, HashLife)
+{
+    const auto& Expected = RunReference(GetParam());
+
+    gol::HashLifeGrid grid(Expected.InitialCells);
+    ExpectMatchesReference(grid, Expected);
+}
+
+TEST_P(DifferentialTests, Clustered)
+{
+    const auto& Expected = RunReference(GetParam());
+
+    gol::ClusteredGrid grid(Expected.InitialCells, 2);
+    ExpectMatchesReference(grid, Expected);
+}
+
+//
+// Far-apart groups of cells, such as those of sample and clusters, can't
+// share a board, so each gets its own.
+//
+TEST_P(DifferentialTests, Dense)
+{
+    const auto& Expected = RunReference(GetParam());
+
+    DenseBoards boards;
+    BuildDenseBoards(Expected, boards);
+    if (HasFatalFailure()) { return; }
+
+    ExpectMatchesReference(boards, Expected);
+}
+
+//
+// Only the final generation comes back from the workers.
+//
+TEST_P(DifferentialTests, Sharded)
+{
+    const auto& Expected = RunReference(GetParam());
+
+    gol::ShardedSettings settings;
+    settings.NumWorkers = 3;
+    settings.NumGenerations = NumGenerations;
+    settings.RebalanceEvery = CheckpointInterval / 4;
+
+    ASSERT_EQ(
+        gol::RunSharded(Expected.InitialCells, settings).LiveCells,
+        Expected.Checkpoints.back());
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Corpus,
+    DifferentialTests,
+    ::testing::Values(
+        "sample",
+        "clusters",
+        "rpentomino",
+        "acorn",
+        "gosper_gun",
+        "switch_engine",
+        "soup_d10",
+        "soup_d30",
+        "soup_d50"),
+    [](const ::testing::TestParamInfo<const char*>& info) { return std::string(info.param); });
@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+
+#include <lib/Cell.h>
+#include <lib/GOLGrid.h>
+
+#include "TestPatterns.h"
+
+#include <algorithm>
+
+TEST(RegionFreezingTests, FreezesLoneBlinker)
+{
+    const std::vector<gol::CellAddress> Vertical = { { 8, 7 }, { 8, 8 }, { 8, 9 } };
+    const std::vector<gol::CellAddress> Horizontal = { { 7, 8 }, { 8, 8 }, { 9, 8 } };
+
+    gol::GOLGrid grid(Vertical);
+    grid.SetRegionFreezing(true);
+    for (size_t generation = 1; generation <= 21; ++generation)
+    {
+        grid.AdvanceGeneration();
+
+        const auto& Expected = generation % 2 ? Horizontal : Vertical;
+        ASSERT_EQ(AddressesOf(grid.GetLiveCells()), Expected) << generation;
+        ASSERT_EQ(SortedLiveCells(grid), Expected) << generation;
+    }
+
+    ASSERT_EQ(grid.GetFrozenRegionCount(), 1u);
+
+    //
+    // Live cells see their neighbors in the current phase too.
+    //
+    const auto Cells = grid.GetAllCells();
+    const auto CenterIt = std::find_if(
+        std::begin(Cells),
+        std::end(Cells),
+        [](const gol::Cell& cell) { return cell.Address == gol::CellAddress(8, 8); });
+    ASSERT_NE(CenterIt, std::end(Cells));
+    ASSERT_EQ(CenterIt->NeighborCount, 2u);
+
+    grid.SetRegionFreezing(false);
+    ASSERT_EQ(grid.GetFrozenRegionCount(), 0u);
+    grid.AdvanceGeneration();
+    ASSERT_EQ(AddressesOf(grid.GetLiveCells()), Vertical);
+}
+
+//
+// A glider flying into a frozen blinker has to thaw it in time for the
+// collision to play out as usual.
+//
+TEST(RegionFreezingTests, ThawsWhenDisturbed)
+{
+    std::vector<gol::CellAddress> initialCells = {
+        { 40, 39 }, { 40, 40 }, { 40, 41 },
+        { 1, 2 }, { 2, 3 }, { 3, 1 }, { 3, 2 }, { 3, 3 }
+    };
+
+    gol::GOLGrid freezingGrid(initialCells);
+    freezingGrid.SetRegionFreezing(true);
+    gol::GOLGrid steppingGrid(initialCells);
+
+    size_t maxFrozen{0};
+    for (size_t generation = 0; generation < 300; ++generation)
+    {
+        freezingGrid.AdvanceGeneration();
+        steppingGrid.AdvanceGeneration();
+        maxFrozen = std::max(maxFrozen, freezingGrid.GetFrozenRegionCount());
+
+        ASSERT_EQ(
+            AddressesOf(freezingGrid.GetLiveCells()),
+            AddressesOf(steppingGrid.GetLiveCells())) << generation;
+    }
+
+    ASSERT_GT(maxFrozen, 0u);
+}
+
+class RegionFreezingSoupTests : public ::testing::TestWithParam<size_t> {};
+
+TEST_P(RegionFreezingSoupTests, MatchesStepping)
+{
+    const size_t NumThreads{GetParam()};
+    const auto InitialCells = GenerateSoup(-40, 40, 0.35, 7);
+
+    gol::GOLGrid freezingGrid(InitialCells, NumThreads);
+    freezingGrid.SetRegionFreezing(true);
+    gol::GOLGrid steppingGrid(InitialCells);
+    for (size_t generation = 0; generation < 250; ++generation)
+    {
+        freezingGrid.AdvanceGeneration();
+        steppingGrid.AdvanceGeneration();
+
+        const auto Expected = AddressesOf(steppingGrid.GetLiveCells());
+        ASSERT_EQ(AddressesOf(freezingGrid.GetLiveCells()), Expected) << generation;
+        ASSERT_EQ(SortedLiveCells(freezingGrid), Expected) << generation;
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    ThreadCounts,
+    RegionFreezingSoupTests,
+    ::testing::Values(1, 4));
+
+TEST(RegionFreezingTests, CombinesWithCycleDetection)
+{
+    //
+    // The pi-heptomino settles into still lifes and blinkers, which freeze
+    // before the whole board is found to repeat.
+    //
+    const std::vector<gol::CellAddress> PiHeptomino = {
+        { 0, 0 }, { 1, 0 }, { 2, 0 }, { 0, 1 }, { 2, 1 }, { 0, 2 }, { 2, 2 }
+    };
+
+    gol::GOLGrid detectingGrid(PiHeptomino);
+    detectingGrid.SetRegionFreezing(true);
+    detectingGrid.SetCycleDetection(true);
+    detectingGrid.AdvanceGenerations(100001);
+
+    gol::GOLGrid steppingGrid(PiHeptomino);
+    for (size_t i = 0; i < 1001; ++i) { steppingGrid.AdvanceGeneration(); }
+
+    ASSERT_EQ(detectingGrid.GetCycle().Period, 2u);
+    ASSERT_EQ(
+        AddressesOf(detectingGrid.GetLiveCells()),
+        AddressesOf(steppingGrid.GetLiveCells()));
+}
@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+
+#include <lib/Cell.h>
+#include <lib/GOLGrid.h>
+#include <lib/HashLifeGrid.h>
+
+#include "TestPatterns.h"
+
+#include <algorithm>
+
+static 
+void ExpectSameCells(
+    const std::vector<gol::Cell>& expected,
+    const std::vector<gol::Cell>& actual)
+{
+    ASSERT_EQ(expected.size(), actual.size());
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+        ASSERT_EQ(expected[i].Address, actual[i].Address);
+        ASSERT_EQ(expected[i].NeighborCount, actual[i].NeighborCount);
+    }
+}
+
+//
+// Jumps of assorted sizes (including ones which aren't powers of two) must
+// land on the same state as stepping one generation at a time.
+//
+class HashLifeJumpFixture : public testing::TestWithParam<uint64_t> {};
+
+TEST_P(HashLifeJumpFixture, MatchesSparseGrid_Param)
+{
+    const uint64_t NumGenerations{GetParam()};
+    const auto InitialCells = GenerateSoup(-12, 12, 0.35, 7);
+
+    gol::GOLGrid sparseGrid(InitialCells);
+    for (uint64_t i = 0; i < NumGenerations; ++i)
+    {
+        sparseGrid.AdvanceGeneration();
+    }
+
+    gol::HashLifeGrid hashLifeGrid(InitialCells);
+    hashLifeGrid.AdvanceGenerations(NumGenerations);
+
+    ASSERT_EQ(hashLifeGrid.GetGeneration(), NumGenerations);
+    ExpectSameCells(sparseGrid.GetLiveCells(), hashLifeGrid.GetLiveCells());
+}
+
+INSTANTIATE_TEST_CASE_P(MatchesSparseGrid_Param,
+                        HashLifeJumpFixture,
+                        testing::Values(0, 1, 2, 7, 64, 100, 333));
+
+TEST(HashLifeTests, GliderAfterManyGenerations)
+{
+    //
+    // A glider moves (1, 1) every four generations, heading down and to the
+    // right.
+    //
+    const std::vector<gol::CellAddress> Glider = {
+        { 1, 0 }, { 2, 1 }, { 0, 2 }, { 1, 2 }, { 2, 2 }
+    };
+
+    const uint64_t NumGenerations{uint64_t(1) << 40};
+    gol::HashLifeGrid grid(Glider);
+    grid.AdvanceGenerations(NumGenerations);
+
+    const int64_t Offset{static_cast<int64_t>(NumGenerations / 4)};
+    std::vector<gol::CellAddress> expected;
+    for (const auto& Address : Glider)
+    {
+        expected.emplace_back(Address.first + Offset, Address.second + Offset);
+    }
+    std::sort(std::begin(expected), std::end(expected));
+
+    const auto LiveCells = grid.GetLiveCells();
+    ASSERT_EQ(LiveCells.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+        ASSERT_EQ(LiveCells[i].Address, expected[i]);
+    }
+}
+
+TEST(HashLifeTests, GarbageCollectionPreservesState)
+{
+    const auto InitialCells = GenerateSoup(-10, 10, 0.4, 99);
+
+    gol::HashLifeGrid reference(InitialCells);
+    gol::HashLifeGrid collected(InitialCells);
+    collected.SetNodeLimit(64);
+    for (uint64_t i = 0; i < 50; ++i)
+    {
+        reference.AdvanceGenerations(3);
+        collected.AdvanceGenerations(3);
+        ExpectSameCells(reference.GetLiveCells(), collected.GetLiveCells());
+    }
+}
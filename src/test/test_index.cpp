@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+
+#include <lib/Cell.h>
+#include <lib/GOLGrid.h>
+
+#include "TestPatterns.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+
+static
+std::vector<gol::CellAddress> LiveAddresses(const gol::GOLGrid& grid)
+{
+    std::vector<gol::CellAddress> addresses;
+    for (const auto& Cell : grid.GetLiveCells()) { addresses.push_back(Cell.Address); }
+    return addresses;
+}
+
+class SpatialIndexTests : public ::testing::TestWithParam<size_t> {};
+
+//
+// Frozen regions are out of phase with the index every other generation,
+// so the queries are checked on every generation while blinkers freeze and
+// thaw.
+//
+TEST_P(SpatialIndexTests, MatchesLiveCells)
+{
+    //
+    // Lone blinkers away from the soup freeze soon enough.
+    //
+    auto initialCells = GenerateSoup(-30, 30, 0.35, 11);
+    for (const int64_t Offset : { 200, 232 })
+    {
+        initialCells.emplace_back(Offset, Offset + 1);
+        initialCells.emplace_back(Offset + 1, Offset + 1);
+        initialCells.emplace_back(Offset + 2, Offset + 1);
+    }
+
+    gol::GOLGrid grid(initialCells, GetParam());
+    grid.SetRegionFreezing(true);
+
+    std::mt19937_64 rng(5);
+    std::uniform_int_distribution<int64_t> coordinate(-60, 260);
+    size_t maxFrozen{0};
+    for (size_t generation = 0; generation < 200; ++generation)
+    {
+        grid.AdvanceGeneration();
+        maxFrozen = std::max(maxFrozen, grid.GetFrozenRegionCount());
+
+        const auto Live = LiveAddresses(grid);
+        ASSERT_EQ(grid.GetPopulation(), Live.size()) << generation;
+
+        gol::CellAddress min;
+        gol::CellAddress max;
+        ASSERT_TRUE(grid.GetBoundingBox(min, max));
+        gol::CellAddress expectedMin(Live.front().first, INT64_MAX);
+        gol::CellAddress expectedMax(Live.back().first, INT64_MIN);
+        for (const auto& Address : Live)
+        {
+            expectedMin.second = std::min(expectedMin.second, Address.second);
+            expectedMax.second = std::max(expectedMax.second, Address.second);
+        }
+        ASSERT_EQ(min, expectedMin) << generation;
+        ASSERT_EQ(max, expectedMax) << generation;
+
+        for (size_t query = 0; query < 4; ++query)
+        {
+            const int64_t X0{coordinate(rng)};
+            const int64_t X1{coordinate(rng)};
+            const int64_t Y0{coordinate(rng)};
+            const int64_t Y1{coordinate(rng)};
+            const gol::CellAddress Min(std::min(X0, X1), std::min(Y0, Y1));
+            const gol::CellAddress Max(std::max(X0, X1), std::max(Y0, Y1));
+
+            std::vector<gol::CellAddress> expected;
+            std::copy_if(
+                std::begin(Live),
+                std::end(Live),
+                std::back_inserter(expected),
+                [&](const gol::CellAddress& address)
+                {
+                    return address.first >= Min.first && address.first <= Max.first &&
+                           address.second >= Min.second && address.second <= Max.second;
+                });
+            ASSERT_EQ(grid.GetLiveCellsInRect(Min, Max), expected) << generation;
+        }
+    }
+
+    ASSERT_GT(maxFrozen, 0u);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    ThreadCounts,
+    SpatialIndexTests,
+    ::testing::Values(1, 4));
+
+TEST(SpatialIndexTests, HandlesExtremeCoordinates)
+{
+    //
+    // Far enough apart not to be neighbors even where coordinates wrap.
+    //
+    const std::vector<gol::CellAddress> Corners = {
+        { INT64_MIN, 0 }, { INT64_MAX, INT64_MAX }, { 0, INT64_MIN },
+        { -1, 0 }, { 0, 0 }
+    };
+
+    gol::GOLGrid grid(Corners);
+    ASSERT_EQ(grid.GetPopulation(), Corners.size());
+
+    gol::CellAddress min;
+    gol::CellAddress max;
+    ASSERT_TRUE(grid.GetBoundingBox(min, max));
+    ASSERT_EQ(min, gol::CellAddress(INT64_MIN, INT64_MIN));
+    ASSERT_EQ(max, gol::CellAddress(INT64_MAX, INT64_MAX));
+
+    const std::vector<gol::CellAddress> Everything = {
+        { INT64_MIN, 0 }, { -1, 0 }, { 0, INT64_MIN }, { 0, 0 },
+        { INT64_MAX, INT64_MAX }
+    };
+    ASSERT_EQ(grid.GetLiveCellsInRect(min, max), Everything);
+
+    const std::vector<gol::CellAddress> Middle = { { -1, 0 }, { 0, 0 } };
+    ASSERT_EQ(grid.GetLiveCellsInRect({ -1000, -1000 }, { 1000, 1000 }), Middle);
+    ASSERT_TRUE(grid.GetLiveCellsInRect({ 1, 1 }, { -1, -1 }).empty());
+
+    //
+    // Every cell is isolated and dies.
+    //
+    grid.AdvanceGeneration();
+    ASSERT_EQ(grid.GetPopulation(), 0u);
+    ASSERT_FALSE(grid.GetBoundingBox(min, max));
+    ASSERT_TRUE(grid.GetLiveCellsInRect(
+        { INT64_MIN, INT64_MIN }, { INT64_MAX, INT64_MAX }).empty());
+}
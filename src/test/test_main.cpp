@@ -4,6 +4,7 @@
 #include <lib/GOLGrid.h>
 
 #include <algorithm>
+#include <list>
 
 //
 // Clockwise neighbor addresses.
@@ -263,6 +264,96 @@ TEST(MultiGenerationTests, BlinkerTest)
     }
 }
 
+//
+// Building a grid from a vector, from a forward-only range with duplicates,
+// and by inserting live cells piecemeal must all give the same state.
+//
+TEST(ConstructionTests, RangesAndDuplicates)
+{
+    using namespace gol;
+
+    const std::vector<CellAddress> Glider = {
+        { 1, 0 }, { 2, 1 }, { 0, 2 }, { 1, 2 }, { 2, 2 }
+    };
+    const std::list<CellAddress> GliderWithDuplicates = {
+        { 1, 0 }, { 2, 1 }, { 1, 0 }, { 0, 2 }, { 1, 2 }, { 2, 2 }, { 2, 2 }
+    };
+
+    GOLGrid fromVector(Glider);
+    GOLGrid fromList(
+        std::begin(GliderWithDuplicates),
+        std::end(GliderWithDuplicates));
+    GOLGrid piecemeal(std::begin(Glider), std::begin(Glider) + 2, 4);
+    piecemeal.InsertLiveCells(std::begin(Glider) + 1, std::end(Glider));
+
+    for (size_t generation = 0; generation < 8; ++generation)
+    {
+        const auto Expected = fromVector.GetAllCells();
+        for (const auto* pGrid : { &fromList, &piecemeal })
+        {
+            const auto Actual = pGrid->GetAllCells();
+            ASSERT_EQ(Expected.size(), Actual.size());
+            for (size_t i = 0; i < Expected.size(); ++i)
+            {
+                ASSERT_EQ(Expected[i].Address, Actual[i].Address);
+                ASSERT_EQ(Expected[i].Alive, Actual[i].Alive);
+                ASSERT_EQ(Expected[i].NeighborCount, Actual[i].NeighborCount);
+            }
+        }
+
+        fromVector.AdvanceGeneration();
+        fromList.AdvanceGeneration();
+        piecemeal.AdvanceGeneration();
+    }
+}
+
+//
+// Killing cells mid-run leaves the same state as never having had them, once
+// their dead neighbors have been retired.
+//
+TEST(ConstructionTests, RemoveLiveCells)
+{
+    using namespace gol;
+
+    const std::vector<CellAddress> Glider = {
+        { 1, 0 }, { 2, 1 }, { 0, 2 }, { 1, 2 }, { 2, 2 }
+    };
+    const std::vector<CellAddress> Block = {
+        { 40, 40 }, { 41, 40 }, { 40, 41 }, { 41, 41 }
+    };
+
+    std::vector<CellAddress> gliderAndBlock(Glider);
+    gliderAndBlock.insert(std::end(gliderAndBlock), std::begin(Block), std::end(Block));
+
+    GOLGrid expected(Glider, 4);
+    GOLGrid grid(gliderAndBlock, 4);
+    for (size_t generation = 0; generation < 3; ++generation)
+    {
+        expected.AdvanceGeneration();
+        grid.AdvanceGeneration();
+    }
+
+    grid.RemoveLiveCells(std::begin(Block), std::end(Block));
+    grid.RemoveLiveCells(std::begin(Block), std::begin(Block) + 1);
+    ASSERT_EQ(grid.GetPopulation(), expected.GetPopulation());
+
+    for (size_t generation = 0; generation < 8; ++generation)
+    {
+        expected.AdvanceGeneration();
+        grid.AdvanceGeneration();
+
+        const auto Expected = expected.GetAllCells();
+        const auto Actual = grid.GetAllCells();
+        ASSERT_EQ(Expected.size(), Actual.size());
+        for (size_t i = 0; i < Expected.size(); ++i)
+        {
+            ASSERT_EQ(Expected[i].Address, Actual[i].Address);
+            ASSERT_EQ(Expected[i].Alive, Actual[i].Alive);
+            ASSERT_EQ(Expected[i].NeighborCount, Actual[i].NeighborCount);
+        }
+    }
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
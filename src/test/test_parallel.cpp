@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+
+#include <lib/Cell.h>
+#include <lib/GOLGrid.h>
+#include <lib/ThreadPool.h>
+
+#include "TestPatterns.h"
+
+#include <atomic>
+
+TEST(ThreadPoolTests, RunsEveryTaskOnce)
+{
+    gol::ThreadPool pool(4);
+    for (size_t round = 0; round < 20; ++round)
+    {
+        const size_t NumTasks{round * 13 + 1};
+        std::vector<std::atomic<int>> hits(NumTasks);
+        pool.ParallelFor(NumTasks, [&hits](size_t i) { hits[i]++; });
+
+        for (const auto& Hit : hits) { ASSERT_EQ(Hit.load(), 1); }
+    }
+}
+
+//
+// Every stored cell, dead or alive, along with its neighbor count must match
+// the single-threaded grid exactly, generation after generation.
+//
+class ParallelGridFixture : public testing::TestWithParam<size_t> {};
+
+TEST_P(ParallelGridFixture, MatchesSerialGrid_Param)
+{
+    const size_t NumThreads{GetParam()};
+    const auto InitialCells = GenerateSoup(-40, 40, 0.3, 2024);
+
+    gol::GOLGrid serialGrid(InitialCells);
+    gol::GOLGrid parallelGrid(InitialCells, NumThreads);
+    for (size_t generation = 0; generation < 60; ++generation)
+    {
+        const auto Expected = serialGrid.GetAllCells();
+        const auto Actual = parallelGrid.GetAllCells();
+        ASSERT_EQ(Expected.size(), Actual.size()) << "generation " << generation;
+        for (size_t i = 0; i < Expected.size(); ++i)
+        {
+            ASSERT_EQ(Expected[i].Address, Actual[i].Address);
+            ASSERT_EQ(Expected[i].Alive, Actual[i].Alive);
+            ASSERT_EQ(Expected[i].NeighborCount, Actual[i].NeighborCount);
+        }
+
+        serialGrid.AdvanceGeneration();
+        parallelGrid.AdvanceGeneration();
+    }
+}
+
+INSTANTIATE_TEST_CASE_P(MatchesSerialGrid_Param,
+                        ParallelGridFixture,
+                        testing::Values(2, 3, 8));
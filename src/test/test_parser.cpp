@@ -0,0 +1,153 @@
+#include <gtest/gtest.h>
+
+#include <lib/Cell.h>
+#include <lib/LifeParser.h>
+
+#include <string>
+
+TEST(LifeParserTests, ParsesCellsAndSkipsBlanksAndComments)
+{
+    const std::string Text =
+        "#Life 1.06\r\n"
+        "0 1\n"
+        "\n"
+        "#D a comment\n"
+        "  -2000000000000\t-2000000000001  \r\n"
+        "3 4";
+
+    std::vector<gol::CellAddress> cells;
+    gol::LifeParseError error;
+    ASSERT_TRUE(gol::ParseLifeText(Text.data(), Text.size(), cells, error));
+
+    const std::vector<gol::CellAddress> Expected = {
+        { 0, 1 }, { -2000000000000, -2000000000001 }, { 3, 4 }
+    };
+    ASSERT_EQ(cells, Expected);
+}
+
+TEST(LifeParserTests, RejectsMissingSignature)
+{
+    const std::string Text = "0 1\n2 3\n";
+
+    std::vector<gol::CellAddress> cells;
+    gol::LifeParseError error;
+    ASSERT_FALSE(gol::ParseLifeText(Text.data(), Text.size(), cells, error));
+    ASSERT_EQ(error.Line, 1u);
+}
+
+//
+// An empty file is mapped as a null pointer and a size of 0.
+//
+TEST(LifeParserTests, RejectsEmptyInput)
+{
+    std::vector<gol::CellAddress> cells;
+    gol::LifeParseError error;
+    ASSERT_FALSE(gol::ParseLifeText(nullptr, 0, cells, error));
+    ASSERT_EQ(error.Line, 1u);
+    ASSERT_FALSE(gol::ParseLifeTextInChunks(
+        nullptr,
+        0,
+        [](const std::vector<gol::CellAddress>&) {},
+        error));
+    ASSERT_EQ(error.Line, 1u);
+}
+
+TEST(LifeParserTests, ReportsMalformedLine)
+{
+    for (const std::string BadLine : { "1", "1 2 3", "1,2", "x 2", "12" "\t" })
+    {
+        const std::string Text = "#Life 1.06\n0 0\n1 1\n" + BadLine + "\n4 4\n";
+
+        std::vector<gol::CellAddress> cells;
+        gol::LifeParseError error;
+        ASSERT_FALSE(gol::ParseLifeText(Text.data(), Text.size(), cells, error))
+            << BadLine;
+        ASSERT_EQ(error.Line, 4u) << BadLine;
+        ASSERT_TRUE(cells.empty());
+    }
+}
+
+//
+// Large enough to be split into several chunks; cells must come out in file
+// order and errors must carry file-relative line numbers.
+//
+TEST(LifeParserTests, ChunkedParseMatchesSerial)
+{
+    std::string text = "#Life 1.06\n";
+    std::vector<gol::CellAddress> expected;
+    for (int64_t i = 0; i < 400000; ++i)
+    {
+        expected.emplace_back(i * 7 - 3, -i);
+        text += std::to_string(i * 7 - 3) + " " + std::to_string(-i) + "\n";
+    }
+
+    std::vector<gol::CellAddress> cells;
+    gol::LifeParseError error;
+    ASSERT_TRUE(gol::ParseLifeText(text.data(), text.size(), cells, error, 4));
+    ASSERT_EQ(cells, expected);
+
+    const size_t BadLineNumber{300001};
+    size_t offset{0};
+    for (size_t line = 1; line < BadLineNumber; ++line)
+    {
+        offset = text.find('\n', offset) + 1;
+    }
+    text.insert(offset, "oops\n");
+
+    cells.clear();
+    ASSERT_FALSE(gol::ParseLifeText(text.data(), text.size(), cells, error, 4));
+    ASSERT_EQ(error.Line, BadLineNumber);
+}
+
+//
+// Chunks must arrive in file order, whichever finishes parsing first, and
+// a malformed line stops the handover at its chunk.
+//
+TEST(LifeParserTests, StreamedChunksMatchWholeParse)
+{
+    std::string text = "#Life 1.06\n";
+    std::vector<gol::CellAddress> expected;
+    for (int64_t i = 0; i < 400000; ++i)
+    {
+        expected.emplace_back(-i, i * 5 + 1);
+        text += std::to_string(-i) + " " + std::to_string(i * 5 + 1) + "\n";
+    }
+
+    for (const size_t NumThreads : { 1, 4 })
+    {
+        std::vector<gol::CellAddress> cells;
+        size_t numChunks{0};
+        gol::LifeParseError error;
+        ASSERT_TRUE(gol::ParseLifeTextInChunks(
+            text.data(),
+            text.size(),
+            [&](const std::vector<gol::CellAddress>& chunk)
+            {
+                ++numChunks;
+                cells.insert(std::end(cells), std::begin(chunk), std::end(chunk));
+            },
+            error,
+            NumThreads));
+        ASSERT_GT(numChunks, 1u);
+        ASSERT_EQ(cells, expected);
+    }
+
+    const size_t BadLineNumber{250001};
+    size_t offset{0};
+    for (size_t line = 1; line < BadLineNumber; ++line)
+    {
+        offset = text.find('\n', offset) + 1;
+    }
+    text.insert(offset, "1 2 3\n");
+
+    size_t numCells{0};
+    gol::LifeParseError error;
+    ASSERT_FALSE(gol::ParseLifeTextInChunks(
+        text.data(),
+        text.size(),
+        [&numCells](const std::vector<gol::CellAddress>& chunk) { numCells += chunk.size(); },
+        error,
+        4));
+    ASSERT_EQ(error.Line, BadLineNumber);
+    ASSERT_LT(numCells, BadLineNumber - 1);
+}
@@ -0,0 +1,302 @@
+//
+// Throughput gate: each engine steps a fixed pattern from inputs/ for a fixed
+// number of generations, and the test fails if it has become slower than the
+// baseline in perf_baseline.txt by more than a tolerance.
+//
+// Timings are divided into the time taken by a calibration loop, a naive
+// byte-per-cell Life on a small torus compiled along with the test, so the
+// baseline holds relative speeds which carry over between runs on the same
+// kind of machine far better than raw times would. Each timing is the best
+// of a few runs.
+//
+// The tests skip unless GOL_PERF_GATE is set, which the ctest entry does, and
+// always in builds without NDEBUG: the baseline is recorded from a Release
+// build, which is what the gate runs in. Timings depend on the machine and on
+// whatever else it's doing, so the tolerance is loose, 50% by default, and can
+// be changed through GOL_PERF_TOLERANCE, e.g. GOL_PERF_TOLERANCE=0.25. Running
+// with GOL_PERF_RECORD=1 writes the measured speeds into the baseline instead
+// of checking them, for a new machine or after a deliberate change.
+//
+
+#include <gtest/gtest.h>
+
+#include <lib/Cell.h>
+#include <lib/ClusteredGrid.h>
+#include <lib/DenseGrid.h>
+#include <lib/GOLGrid.h>
+#include <lib/HashLifeGrid.h>
+#include <lib/LifeParser.h>
+#include <lib/TiledGrid.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    constexpr size_t NumRuns{5};
+    constexpr double DefaultTolerance{0.5};
+
+    using Clock = std::chrono::steady_clock;
+
+    std::vector<gol::CellAddress> LoadPattern(const std::string& pattern)
+    {
+        const std::string Path{std::string(GOL_TEST_INPUTS_DIR) + "/" + pattern + ".life"};
+        std::vector<gol::CellAddress> cells;
+        gol::LifeParseError error;
+        EXPECT_TRUE(gol::ParseLifeFile(Path, cells, error)) << Path << ": " << error.Message;
+        return cells;
+    }
+
+    //
+    // The best of NumRuns timings of run(), in seconds. setUp() is called
+    // before each and isn't timed.
+    //
+    double BestTime(const std::function<void()>& setUp, const std::function<void()>& run)
+    {
+        double best{0};
+        for (size_t i = 0; i < NumRuns; ++i)
+        {
+            setUp();
+            const auto Start = Clock::now();
+            run();
+            const double Seconds{std::chrono::duration<double>(Clock::now() - Start).count()};
+            best = i == 0 ? Seconds : std::min(best, Seconds);
+        }
+        return best;
+    }
+
+    //
+    // The yardstick everything else is measured against: 200 generations of
+    // a 256x256 torus, one byte per cell, every cell visited every time.
+    //
+    double CalibrationTime()
+    {
+        constexpr size_t Size{256};
+        constexpr size_t NumGenerations{200};
+
+        std::vector<uint8_t> board;
+        std::vector<uint8_t> next(Size * Size);
+        auto SetUp = [&board]()
+        {
+            board.assign(Size * Size, 0);
+            uint64_t state{1};
+            for (auto& cell : board)
+            {
+                state = state * 6364136223846793005ull + 1442695040888963407ull;
+                cell = (state >> 62) == 0;
+            }
+        };
+
+        auto Run = [&board, &next]()
+        {
+            for (size_t generation = 0; generation < NumGenerations; ++generation)
+            {
+                for (size_t y = 0; y < Size; ++y)
+                {
+                    const size_t Up{(y + Size - 1) % Size};
+                    const size_t Down{(y + 1) % Size};
+                    for (size_t x = 0; x < Size; ++x)
+                    {
+                        const size_t Left{(x + Size - 1) % Size};
+                        const size_t Right{(x + 1) % Size};
+                        const unsigned Neighbors =
+                            board[Up * Size + Left] + board[Up * Size + x] + board[Up * Size + Right] +
+                            board[y * Size + Left] + board[y * Size + Right] +
+                            board[Down * Size + Left] + board[Down * Size + x] + board[Down * Size + Right];
+                        next[y * Size + x] = Neighbors == 3 || (Neighbors == 2 && board[y * Size + x]);
+                    }
+                }
+                board.swap(next);
+            }
+        };
+
+        return BestTime(SetUp, Run);
+    }
+
+    //
+    // Times numGenerations of a freshly built grid, excluding construction.
+    //
+    template<typename GridType, typename... Args>
+    double StepTime(
+        const std::function<void(GridType&)>& advance,
+        const std::vector<gol::CellAddress>& cells,
+        Args... args)
+    {
+        std::unique_ptr<GridType> pGrid;
+        return BestTime(
+            [&]() { pGrid.reset(); pGrid = std::make_unique<GridType>(cells, args...); },
+            [&]() { advance(*pGrid); });
+    }
+
+    template<typename GridType>
+    std::function<void(GridType&)> Stepping(uint64_t numGenerations)
+    {
+        return [numGenerations](GridType& grid)
+        {
+            for (uint64_t i = 0; i < numGenerations; ++i) { grid.AdvanceGeneration(); }
+        };
+    }
+
+    //
+    // The 128x128 soups, centered on a torus twice their size.
+    //
+    gol::DenseBounds SoupTorus()
+    {
+        gol::DenseBounds bounds;
+        bounds.Origin = gol::CellAddress(-64, -64);
+        bounds.Width = 256;
+        bounds.Height = 256;
+        bounds.Topology = gol::DenseTopology::Torus;
+        return bounds;
+    }
+
+    //
+    // The fixed benchmarks, by the name they go by in the baseline.
+    //
+    const std::map<std::string, std::function<double()>>& Benchmarks()
+    {
+        static const std::map<std::string, std::function<double()>> Cases = {
+            { "sparse/soup_d30", []()
+                {
+                    return StepTime<gol::GOLGrid>(Stepping<gol::GOLGrid>(200), LoadPattern("soup_d30"));
+                } },
+            { "sparse/acorn", []()
+                {
+                    return StepTime<gol::GOLGrid>(Stepping<gol::GOLGrid>(1000), LoadPattern("acorn"));
+                } },
+            { "tiled/soup_d30", []()
+                {
+                    return StepTime<gol::TiledGrid>(Stepping<gol::TiledGrid>(5000), LoadPattern("soup_d30"));
+                } },
+            { "hashlife/soup_d30", []()
+                {
+                    return StepTime<gol::HashLifeGrid>(
+                        [](gol::HashLifeGrid& grid) { grid.AdvanceGenerations(uint64_t(1) << 13); },
+                        LoadPattern("soup_d30"));
+                } },
+            { "clustered/clusters", []()
+                {
+                    return StepTime<gol::ClusteredGrid>(Stepping<gol::ClusteredGrid>(6000), LoadPattern("clusters"));
+                } },
+            { "dense/soup_d30", []()
+                {
+                    return StepTime<gol::DenseGrid>(
+                        [](gol::DenseGrid& grid) { grid.AdvanceGenerations(20000); },
+                        LoadPattern("soup_d30"),
+                        SoupTorus());
+                } },
+        };
+        return Cases;
+    }
+
+    std::string BaselinePath()
+    {
+        return GOL_PERF_BASELINE;
+    }
+
+    //
+    // Lines of "<benchmark> <relative speed>"; blank lines and lines starting
+    // with '#' are skipped.
+    //
+    std::map<std::string, double> ReadBaseline(std::vector<std::string>& comments)
+    {
+        std::map<std::string, double> baseline;
+        std::ifstream in(BaselinePath());
+        std::string line;
+        while (std::getline(in, line))
+        {
+            if (line.empty() || line[0] == '#')
+            {
+                comments.push_back(line);
+                continue;
+            }
+
+            std::istringstream fields(line);
+            std::string name;
+            double speed{0};
+            if (fields >> name >> speed) { baseline[name] = speed; }
+        }
+        return baseline;
+    }
+
+    bool WriteBaseline(const std::vector<std::string>& comments, const std::map<std::string, double>& baseline)
+    {
+        std::ofstream out(BaselinePath(), std::ios::trunc);
+        for (const auto& Comment : comments) { out << Comment << "\n"; }
+        for (const auto& [Name, Speed] : baseline) { out << Name << " " << Speed << "\n"; }
+        return static_cast<bool>(out.flush());
+    }
+
+    double Tolerance()
+    {
+        const char* pValue = std::getenv("GOL_PERF_TOLERANCE");
+        return pValue ? std::atof(pValue) : DefaultTolerance;
+    }
+}
+
+class PerformanceTests : public ::testing::TestWithParam<const char*> {};
+
+TEST_P(PerformanceTests, NoSlowerThanBaseline)
+{
+#if !defined(NDEBUG)
+    GTEST_SKIP() << "Throughput is only checked in optimized builds.";
+#else
+    const bool Recording{std::getenv("GOL_PERF_RECORD") != nullptr};
+    if (!Recording && !std::getenv("GOL_PERF_GATE"))
+    {
+        GTEST_SKIP() << "Set GOL_PERF_GATE to check throughput.";
+    }
+
+    const std::string Name{GetParam()};
+    const auto BenchmarkIt = Benchmarks().find(Name);
+    ASSERT_NE(BenchmarkIt, Benchmarks().end());
+
+    const double Calibration{CalibrationTime()};
+    const double Speed{Calibration / BenchmarkIt->second()};
+
+    std::vector<std::string> comments;
+    auto baseline = ReadBaseline(comments);
+    if (Recording)
+    {
+        baseline[Name] = Speed;
+        ASSERT_TRUE(WriteBaseline(comments, baseline)) << "Failed to write " << BaselinePath();
+        return;
+    }
+
+    const auto BaselineIt = baseline.find(Name);
+    ASSERT_NE(BaselineIt, baseline.end())
+        << "No baseline for " << Name << " in " << BaselinePath()
+        << "; record one with GOL_PERF_RECORD=1.";
+
+    const double Minimum{BaselineIt->second * (1 - Tolerance())};
+    EXPECT_GE(Speed, Minimum)
+        << Name << " ran at " << Speed << "x the calibration loop, against a baseline of "
+        << BaselineIt->second << "x.";
+#endif
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Benchmarks,
+    PerformanceTests,
+    ::testing::Values(
+        "sparse/soup_d30",
+        "sparse/acorn",
+        "tiled/soup_d30",
+        "hashlife/soup_d30",
+        "clustered/clusters",
+        "dense/soup_d30"),
+    [](const ::testing::TestParamInfo<const char*>& info)
+    {
+        std::string name{info.param};
+        std::replace(std::begin(name), std::end(name), '/', '_');
+        return name;
+    });
@@ -0,0 +1,46 @@
+#include <gtest/gtest.h>
+
+#include <lib/BackgroundWriter.h>
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+TEST(BackgroundWriterTests, RunsJobsInOrderOneAtATime)
+{
+    std::vector<int> order;
+    std::atomic<int> running{0};
+    bool overlapped{false};
+    {
+        gol::BackgroundWriter writer;
+        for (int i = 0; i < 50; ++i)
+        {
+            writer.Submit([&, i]()
+            {
+                overlapped = overlapped || running++ != 0;
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+                order.push_back(i);
+                --running;
+            });
+        }
+        writer.Wait();
+        ASSERT_EQ(order.size(), 50u);
+    }
+
+    ASSERT_FALSE(overlapped);
+    for (int i = 0; i < 50; ++i) { ASSERT_EQ(order[i], i); }
+}
+
+TEST(BackgroundWriterTests, ReportsFailures)
+{
+    gol::BackgroundWriter writer;
+    writer.Submit([]() { throw std::runtime_error("disk full"); });
+    ASSERT_THROW(writer.Wait(), std::runtime_error);
+
+    bool ran{false};
+    ASSERT_THROW(writer.Submit([&ran]() { ran = true; }), std::runtime_error);
+    ASSERT_THROW(writer.Wait(), std::runtime_error);
+    ASSERT_FALSE(ran);
+}
@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+
+#include <lib/Cell.h>
+#include <lib/GOLGrid.h>
+#include <lib/Rule.h>
+
+#include "TestPatterns.h"
+
+#include <map>
+#include <set>
+#include <string>
+
+//
+// Straightforward reference: count every live cell's neighbors from scratch.
+//
+static
+std::set<gol::CellAddress> ReferenceStep(
+    const std::set<gol::CellAddress>& live,
+    const gol::Rule& rule)
+{
+    std::map<gol::CellAddress, int> counts;
+    for (const auto& Address : live)
+    {
+        for (int64_t dy = -1; dy <= 1; ++dy)
+        {
+            for (int64_t dx = -1; dx <= 1; ++dx)
+            {
+                if (dx || dy)
+                {
+                    ++counts[{ Address.first + dx, Address.second + dy }];
+                }
+            }
+        }
+    }
+
+    std::set<gol::CellAddress> next;
+    for (const auto& [Address, Count] : counts)
+    {
+        const uint16_t Mask = live.count(Address) ? rule.Survival : rule.Birth;
+        if (Mask & (1 << Count)) { next.insert(Address); }
+    }
+
+    return next;
+}
+
+TEST(RuleTests, ParsesNotation)
+{
+    gol::Rule rule;
+    std::string error;
+
+    ASSERT_TRUE(gol::ParseRule("B3/S23", rule, error));
+    ASSERT_EQ(rule, gol::ConwayRule);
+
+    ASSERT_TRUE(gol::ParseRule("s23/b36", rule, error));
+    ASSERT_EQ(rule, gol::HighLifeRule);
+
+    ASSERT_TRUE(gol::ParseRule("B2/S", rule, error));
+    ASSERT_EQ(rule, gol::SeedsRule);
+
+    ASSERT_TRUE(gol::ParseRule("DayNight", rule, error));
+    ASSERT_EQ(rule, gol::DayAndNightRule);
+    ASSERT_EQ(gol::ToString(rule), "B3678/S34678");
+
+    for (const char* pBad : { "", "B3", "B3/S23/", "B39/S23", "B3/B23", "X3/S23", "B0/S23" })
+    {
+        ASSERT_FALSE(gol::ParseRule(pBad, rule, error)) << pBad;
+        ASSERT_FALSE(error.empty());
+    }
+}
+
+TEST(RuleTests, RejectsBirthOnZero)
+{
+    gol::GOLGrid grid({ { 0, 0 } });
+    ASSERT_THROW(grid.SetRule(gol::Rule{ 1, 0 }), std::invalid_argument);
+    ASSERT_EQ(grid.GetRule(), gol::ConwayRule);
+}
+
+class RuleSoupTests : public ::testing::TestWithParam<const char*> {};
+
+//
+// Covers both the specialized kernels and the generic one (B35678/S5678).
+//
+TEST_P(RuleSoupTests, MatchesReference)
+{
+    gol::Rule rule;
+    std::string error;
+    ASSERT_TRUE(gol::ParseRule(GetParam(), rule, error)) << error;
+
+    const auto InitialCells = GenerateSoup(-20, 20, 0.4, 99);
+    std::set<gol::CellAddress> expected(std::begin(InitialCells), std::end(InitialCells));
+
+    gol::GOLGrid grid(InitialCells, 4);
+    grid.SetRule(rule);
+    for (size_t generation = 0; generation < 40; ++generation)
+    {
+        grid.AdvanceGeneration();
+        expected = ReferenceStep(expected, rule);
+
+        std::set<gol::CellAddress> actual;
+        for (const auto& Cell : grid.GetLiveCells()) { actual.insert(Cell.Address); }
+        ASSERT_EQ(actual, expected) << GetParam() << " generation " << generation;
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    LifeLikeRules,
+    RuleSoupTests,
+    ::testing::Values("B3/S23", "B36/S23", "B2/S", "B3678/S34678", "B35678/S5678"));
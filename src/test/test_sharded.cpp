@@ -0,0 +1,165 @@
+#include <gtest/gtest.h>
+
+#include <lib/Cell.h>
+#include <lib/GOLGrid.h>
+#include <lib/Sharded.h>
+#include <lib/ShardTransport.h>
+
+#include "TestPatterns.h"
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+static
+std::vector<gol::CellAddress> RunSingle(
+    const std::vector<gol::CellAddress>& initialCells,
+    uint64_t numGenerations)
+{
+    gol::GOLGrid grid(initialCells);
+    grid.AdvanceGenerations(numGenerations);
+
+    std::vector<gol::CellAddress> liveCells;
+    for (const auto& Cell : grid.GetLiveCells()) { liveCells.push_back(Cell.Address); }
+    return liveCells;
+}
+
+//
+// Passes messages through to a real channel, but fails on the given receive.
+//
+class FailingChannel : public gol::ShardChannel
+{
+public:
+    FailingChannel(std::unique_ptr<gol::ShardChannel> pChannel, size_t failOnReceive)
+        : m_pChannel(std::move(pChannel)),
+          m_failOnReceive(failOnReceive) {}
+
+    void Send(const std::vector<char>& message) override
+    {
+        m_pChannel->Send(message);
+    }
+
+    void Receive(std::vector<char>& message) override
+    {
+        if (++m_numReceived == m_failOnReceive)
+        {
+            throw std::runtime_error("injected failure");
+        }
+        m_pChannel->Receive(message);
+    }
+
+private:
+    std::unique_ptr<gol::ShardChannel> m_pChannel;
+    size_t                             m_failOnReceive;
+    size_t                             m_numReceived = 0;
+};
+
+TEST(ShardTransportTests, SocketChannelsCarryWholeMessages)
+{
+    auto channels = gol::CreateSocketChannelPair();
+
+    //
+    // Far more than a socket buffer holds, so both ends have to loop.
+    //
+    std::vector<char> large(size_t(1) << 22);
+    for (size_t i = 0; i < large.size(); ++i) { large[i] = static_cast<char>(i * 7); }
+
+    std::vector<char> received;
+    std::thread reader([&]()
+    {
+        channels.second->Receive(received);
+        channels.second->Send(std::vector<char>());
+    });
+    channels.first->Send(large);
+
+    std::vector<char> empty{ 'x' };
+    channels.first->Receive(empty);
+    reader.join();
+
+    ASSERT_EQ(received, large);
+    ASSERT_TRUE(empty.empty());
+
+    channels.second.reset();
+    ASSERT_THROW(channels.first->Receive(received), std::runtime_error);
+}
+
+//
+// A soup in the middle and a fleet of gliders heading off to the lower right,
+// so the load drifts from strip to strip and has to be rebalanced.
+//
+TEST(ShardedTests, MatchesSingleProcess)
+{
+    auto initialCells = GenerateSoup(-24, 24, 0.35, 5);
+    for (int64_t i = 0; i < 12; ++i)
+    {
+        const int64_t X{40 + 6 * i};
+        const int64_t Y{-30 + 7 * i};
+        const std::vector<gol::CellAddress> Glider = {
+            { X + 1, Y }, { X + 2, Y + 1 }, { X, Y + 2 }, { X + 1, Y + 2 }, { X + 2, Y + 2 }
+        };
+        initialCells.insert(std::end(initialCells), std::begin(Glider), std::end(Glider));
+    }
+
+    gol::ShardedSettings settings;
+    settings.NumWorkers = 3;
+    settings.NumGenerations = 400;
+    settings.RebalanceEvery = 16;
+
+    const auto Result = gol::RunSharded(initialCells, settings);
+    ASSERT_EQ(Result.LiveCells, RunSingle(initialCells, settings.NumGenerations));
+    ASSERT_GT(Result.NumRebalances, 0u);
+}
+
+TEST(ShardedTests, MoreWorkersThanColumns)
+{
+    const std::vector<gol::CellAddress> Blinker = { { 0, -1 }, { 0, 0 }, { 0, 1 } };
+
+    gol::ShardedSettings settings;
+    settings.NumWorkers = 5;
+    settings.NumGenerations = 7;
+    settings.RebalanceEvery = 2;
+
+    ASSERT_EQ(gol::RunSharded(Blinker, settings).LiveCells, RunSingle(Blinker, 7));
+}
+
+//
+// A worker's failure, and the reason for it, reach the caller, rather than
+// the broken link its neighbor runs into next.
+//
+TEST(ShardedTests, ReportsWorkerFailure)
+{
+    gol::ShardedSettings settings;
+    settings.NumWorkers = 3;
+    settings.NumGenerations = 40;
+    settings.RebalanceEvery = 4;
+
+    //
+    // Channels are made for each worker in turn, the one to the coordinator
+    // and then the link to the next worker, so the third is the middle
+    // worker's channel to the coordinator. It fails on the fourth command.
+    //
+    size_t numChannels{0};
+    settings.CreateChannels = [&numChannels]()
+    {
+        auto channels = gol::CreateSocketChannelPair();
+        if (++numChannels == 3)
+        {
+            channels.second = std::make_unique<FailingChannel>(std::move(channels.second), 4);
+        }
+        return channels;
+    };
+
+    const std::vector<gol::CellAddress> Blinker = { { 0, -1 }, { 0, 0 }, { 0, 1 } };
+    try
+    {
+        gol::RunSharded(Blinker, settings);
+        FAIL() << "The run should have failed.";
+    }
+    catch (std::runtime_error& e)
+    {
+        const std::string Message{e.what()};
+        ASSERT_EQ(Message, "Shard worker 1 failed: injected failure");
+    }
+}
@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+
+#include <lib/Cell.h>
+#include <lib/GOLGrid.h>
+#include <lib/SpillStore.h>
+
+#include "TestPatterns.h"
+
+#include <algorithm>
+#include <array>
+#include <filesystem>
+#include <stdexcept>
+
+TEST(SpillStoreTests, ReusesReleasedSlots)
+{
+    gol::SpillStore store(std::filesystem::temp_directory_path().string());
+
+    std::array<uint8_t, gol::SpillStore::SlotSize> data;
+    std::vector<size_t> slots;
+    for (size_t i = 0; i < 100; ++i)
+    {
+        std::fill(std::begin(data), std::end(data), static_cast<uint8_t>(i));
+        slots.push_back(store.Store(data.data()));
+    }
+    ASSERT_EQ(store.SlotsInUse(), 100u);
+
+    store.Release(slots[10]);
+    std::fill(std::begin(data), std::end(data), uint8_t(0xAB));
+    ASSERT_EQ(store.Store(data.data()), slots[10]);
+    ASSERT_EQ(store.SlotsInUse(), 100u);
+
+    for (size_t i = 0; i < 100; ++i)
+    {
+        const uint8_t Expected = i == 10 ? uint8_t(0xAB) : static_cast<uint8_t>(i);
+        const uint8_t* pSlot = store.Load(slots[i]);
+        ASSERT_TRUE(std::all_of(
+            pSlot,
+            pSlot + gol::SpillStore::SlotSize,
+            [Expected](uint8_t byte) { return byte == Expected; })) << i;
+    }
+}
+
+class SpillTests : public ::testing::TestWithParam<size_t> {};
+
+//
+// With next to no budget, every quiet region is spilled: still lifes and the
+// frozen blinker, which a glider then runs into.
+//
+TEST_P(SpillTests, MatchesUnlimitedGrid)
+{
+    auto initialCells = GenerateSoup(-30, 30, 0.35, 11);
+    const std::vector<gol::CellAddress> Extras = {
+        { 61, 60 }, { 62, 61 }, { 60, 62 }, { 61, 62 }, { 62, 62 },
+        { 120, 119 }, { 120, 120 }, { 120, 121 },
+        { 100, -40 }, { 101, -40 }, { 100, -39 }, { 101, -39 },
+        { -80, 90 }, { -79, 90 }, { -80, 91 }, { -79, 91 }
+    };
+    initialCells.insert(std::end(initialCells), std::begin(Extras), std::end(Extras));
+
+    gol::GOLGrid spillingGrid(initialCells, GetParam());
+    spillingGrid.SetRegionFreezing(true);
+    spillingGrid.SetCycleDetection(true);
+    spillingGrid.SetMemoryBudget(1);
+    gol::GOLGrid grid(initialCells, GetParam());
+    grid.SetRegionFreezing(true);
+    grid.SetCycleDetection(true);
+
+    size_t maxSpilled{0};
+    size_t numRestored{0};
+    for (size_t generation = 0; generation < 300; ++generation)
+    {
+        const size_t NumSpilled{spillingGrid.GetSpilledRegionCount()};
+        spillingGrid.AdvanceGeneration();
+        grid.AdvanceGeneration();
+        maxSpilled = std::max(maxSpilled, spillingGrid.GetSpilledRegionCount());
+        numRestored += spillingGrid.GetSpilledRegionCount() < NumSpilled;
+
+        const auto Expected = grid.GetAllCells();
+        const auto Actual = spillingGrid.GetAllCells();
+        ASSERT_EQ(Expected.size(), Actual.size()) << generation;
+        for (size_t i = 0; i < Expected.size(); ++i)
+        {
+            ASSERT_EQ(Expected[i].Address, Actual[i].Address) << generation;
+            ASSERT_EQ(Expected[i].Alive, Actual[i].Alive) << generation;
+            ASSERT_EQ(Expected[i].NeighborCount, Actual[i].NeighborCount) << generation;
+        }
+
+        ASSERT_EQ(SortedLiveCells(spillingGrid), SortedLiveCells(grid)) << generation;
+        ASSERT_EQ(spillingGrid.GetPopulation(), grid.GetPopulation()) << generation;
+    }
+
+    ASSERT_GT(maxSpilled, 0u);
+    ASSERT_GT(numRestored, 0u);
+    ASSERT_EQ(spillingGrid.GetCycle().Period, grid.GetCycle().Period);
+
+    spillingGrid.SetMemoryBudget(0);
+    ASSERT_EQ(spillingGrid.GetSpilledRegionCount(), 0u);
+    ASSERT_EQ(spillingGrid.GetStoredCellCount(), grid.GetStoredCellCount());
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    ThreadCounts,
+    SpillTests,
+    ::testing::Values(1, 4));
+
+//
+// A soup which burns out into still lifes, blinkers and a few gliders goes
+// quiet long after the first spill, and must still end up within its budget.
+//
+TEST(SpillTests, BudgetHoldsOnceSettled)
+{
+    constexpr size_t Budget{8 * 1024};
+    const auto InitialCells = GenerateSoup(-12, 12, 0.35, 10);
+
+    gol::GOLGrid spillingGrid(InitialCells);
+    spillingGrid.SetRegionFreezing(true);
+    spillingGrid.SetMemoryBudget(Budget);
+    gol::GOLGrid grid(InitialCells);
+    grid.SetRegionFreezing(true);
+
+    for (size_t generation = 0; generation < 2000; ++generation)
+    {
+        spillingGrid.AdvanceGeneration();
+        grid.AdvanceGeneration();
+        if (generation >= 1500)
+        {
+            ASSERT_LE(spillingGrid.GetStorageMemoryUsage(), Budget) << generation;
+        }
+    }
+
+    ASSERT_GT(grid.GetStorageMemoryUsage(), Budget);
+    ASSERT_EQ(SortedLiveCells(spillingGrid), SortedLiveCells(grid));
+}
+
+TEST(SpillTests, RejectsMissingDirectory)
+{
+    gol::GOLGrid grid(GenerateSoup(0, 20, 0.3, 3));
+    ASSERT_THROW(
+        grid.SetMemoryBudget(1, "/nonexistent/spill/directory"),
+        std::runtime_error);
+}
@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+
+#include <lib/Cell.h>
+#include <lib/GOLGrid.h>
+#include <lib/StatsWriter.h>
+
+#include "TestPatterns.h"
+
+#include <cstdio>
+#include <memory>
+#include <string>
+
+TEST(StepStatsTests, CountsBlinkerChanges)
+{
+    gol::GOLGrid grid({ { -1, 0 }, { 0, 0 }, { 1, 0 } });
+    grid.SetStepStats(true);
+
+    for (size_t generation = 0; generation < 4; ++generation)
+    {
+        grid.AdvanceGeneration();
+
+        //
+        // Two cells die and two are born every generation.
+        //
+        const auto& Stats = grid.GetLastStepStats();
+        ASSERT_EQ(Stats.ChangedCells, 4u);
+        ASSERT_EQ(grid.GetStoredCellCount(), grid.GetAllCells().size());
+        ASSERT_GT(grid.GetStorageMemoryUsage(), 0u);
+    }
+}
+
+TEST(StepStatsTests, CountsRetiredCells)
+{
+    //
+    // A lone cell dies, and then it and its neighbors have nothing left.
+    //
+    gol::GOLGrid grid({ { 0, 0 } });
+    grid.SetStepStats(true);
+
+    grid.AdvanceGeneration();
+    ASSERT_EQ(grid.GetLastStepStats().ChangedCells, 1u);
+
+    grid.AdvanceGeneration();
+    ASSERT_EQ(grid.GetLastStepStats().RetiredCells, 9u);
+    ASSERT_EQ(grid.GetStoredCellCount(), 0u);
+}
+
+TEST(StatsWriterTests, WritesJsonLines)
+{
+    std::unique_ptr<std::FILE, int(*)(std::FILE*)> pFile(
+        std::tmpfile(),
+        &std::fclose);
+    ASSERT_NE(pFile, nullptr);
+
+    {
+        gol::StatsWriter writer(pFile.get());
+
+        gol::GenerationStats stats;
+        stats.Generation = 7;
+        stats.pEngine = "tiled";
+        stats.WallNanoseconds = 1500;
+        stats.LiveCells = 12;
+        writer.WriteGeneration(stats);
+
+        stats.Generation = 8;
+        stats.pEngine = "sparse";
+        stats.HasPhases = true;
+        stats.ChangedCells = 3;
+        writer.WriteGeneration(stats);
+        ASSERT_TRUE(writer.Flush());
+    }
+
+    ASSERT_EQ(
+        ReadAll(pFile.get()),
+        "{\"generation\":7,\"engine\":\"tiled\",\"wall_ns\":1500,"
+        "\"live_cells\":12,\"allocations\":0,\"allocated_bytes\":0}\n"
+        "{\"generation\":8,\"engine\":\"sparse\",\"wall_ns\":1500,"
+        "\"live_cells\":12,\"allocations\":0,\"allocated_bytes\":0,"
+        "\"classify_ns\":0,\"propagate_ns\":0,\"retire_ns\":0,\"freeze_ns\":0,"
+        "\"stored_cells\":0,\"changed_cells\":3,\"retired_cells\":0,"
+        "\"storage_bytes\":0,\"frozen_regions\":0}\n");
+}
@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+
+#include <lib/Cell.h>
+#include <lib/CellStorage.h>
+#include <lib/FlatCellMap.h>
+
+#include <map>
+#include <random>
+
+//
+// Churn a flat map and a reference std::map with the same random mix of
+// inserts, lookups and removals, checking that they agree throughout.
+//
+TEST(FlatCellMapTests, MatchesReferenceUnderChurn)
+{
+    using namespace gol;
+
+    std::mt19937_64 rng(1234);
+    std::uniform_int_distribution<int64_t> coordinate(-40, 40);
+    std::uniform_int_distribution<int> operation(0, 2);
+
+    FlatCellMap flatMap;
+    std::map<CellAddress, Cell> reference;
+    for (size_t i = 0; i < 50000; ++i)
+    {
+        const CellAddress Address(coordinate(rng), coordinate(rng));
+        switch (operation(rng))
+        {
+        case 0:
+        {
+            const Cell NewCell(Address, true, static_cast<uint8_t>(i % 9));
+            flatMap[Address] = NewCell;
+            reference[Address] = NewCell;
+            break;
+        }
+        case 1:
+            ASSERT_EQ(flatMap.erase(Address), reference.erase(Address));
+            break;
+        default:
+        {
+            auto flatIt = flatMap.find(Address);
+            auto referenceIt = reference.find(Address);
+            ASSERT_EQ(flatIt == flatMap.end(), referenceIt == reference.end());
+            if (referenceIt != reference.end())
+            {
+                ASSERT_EQ(
+                    flatIt->second.NeighborCount,
+                    referenceIt->second.NeighborCount);
+            }
+            break;
+        }
+        }
+
+        ASSERT_EQ(flatMap.size(), reference.size());
+    }
+
+    size_t numVisited{0};
+    for (const auto& [Address, FlatCell] : flatMap)
+    {
+        auto referenceIt = reference.find(Address);
+        ASSERT_NE(referenceIt, reference.end());
+        ASSERT_EQ(FlatCell.Address, referenceIt->second.Address);
+        ++numVisited;
+    }
+    ASSERT_EQ(numVisited, reference.size());
+}
+
+//
+// Far-apart addresses which only differ in their high bits must still be
+// distinguishable.
+//
+TEST(FlatCellMapTests, FarApartAddresses)
+{
+    using namespace gol;
+
+    FlatCellMap flatMap;
+    const int64_t Far{-2000000000000};
+    for (int64_t i = 0; i < 1000; ++i)
+    {
+        flatMap[CellAddress(Far * i, Far * -i)].NeighborCount = 1;
+    }
+
+    ASSERT_EQ(flatMap.size(), 1000u);
+    for (int64_t i = 0; i < 1000; ++i)
+    {
+        ASSERT_NE(flatMap.find(CellAddress(Far * i, Far * -i)), flatMap.end());
+        ASSERT_EQ(flatMap.find(CellAddress(Far * i, Far * i + 1)), flatMap.end());
+    }
+}
+
+//
+// Storage keeps its contents across copies and moves, whichever backend (and
+// node pool) it's built on.
+//
+TEST(CellStorageTests, CopiesAndMoves)
+{
+    using namespace gol;
+
+    CellStorage storage;
+    for (int64_t i = 0; i < 100; ++i)
+    {
+        storage.Insert(CellAddress(i, -i), i % 2 == 0, static_cast<uint8_t>(i % 9));
+    }
+    ASSERT_GT(storage.MemoryUsage(), 0u);
+
+    CellStorage copy(storage);
+    CellStorage moved(std::move(storage));
+    CellStorage assigned;
+    assigned = copy;
+
+    for (const auto* pStorage : { &copy, &moved, &assigned })
+    {
+        ASSERT_EQ(pStorage->Size(), 100u);
+    }
+
+    for (int64_t i = 0; i < 100; ++i)
+    {
+        for (auto* pStorage : { &copy, &moved, &assigned })
+        {
+            auto it = pStorage->Find(CellAddress(i, -i));
+            ASSERT_NE(it, pStorage->end());
+            ASSERT_EQ(it->second.Alive, i % 2 == 0);
+            ASSERT_EQ(it->second.NeighborCount, i % 9);
+        }
+    }
+
+    //
+    // Removing from one leaves the others alone.
+    //
+    ASSERT_TRUE(moved.Remove(CellAddress(0, 0)));
+    ASSERT_EQ(moved.Size(), 99u);
+    ASSERT_EQ(copy.Size(), 100u);
+}
@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+
+#include <lib/Cell.h>
+#include <lib/GOLGrid.h>
+#include <lib/TiledGrid.h>
+
+#include "TestPatterns.h"
+
+#include <algorithm>
+
+//
+// Random soup straddling the tile boundaries around the origin, so that halo
+// exchange in every direction (including negative coordinates) is exercised.
+//
+TEST(TiledGridTests, MatchesSparseGridOnSoup)
+{
+    const auto InitialCells = GenerateSoup(-40, 40, 0.3, 42);
+    gol::GOLGrid sparseGrid(InitialCells);
+    gol::TiledGrid tiledGrid(InitialCells);
+
+    for (size_t generation = 0; generation < 150; ++generation)
+    {
+        const auto Expected = sparseGrid.GetLiveCells();
+        const auto Actual = tiledGrid.GetLiveCells();
+        ASSERT_EQ(Expected.size(), Actual.size()) << "generation " << generation;
+        for (size_t i = 0; i < Expected.size(); ++i)
+        {
+            ASSERT_EQ(Expected[i].Address, Actual[i].Address);
+            ASSERT_EQ(Expected[i].NeighborCount, Actual[i].NeighborCount);
+        }
+
+        sparseGrid.AdvanceGeneration();
+        tiledGrid.AdvanceGeneration();
+    }
+}
+
+TEST(TiledGridTests, GliderCrossesTileCorner)
+{
+    //
+    // A glider heading down and to the right, placed just up and to the left
+    // of the tile corner at the origin.
+    //
+    const std::vector<gol::CellAddress> Glider = {
+        { -4, -5 }, { -3, -4 }, { -5, -3 }, { -4, -3 }, { -3, -3 }
+    };
+
+    gol::TiledGrid grid(Glider);
+    for (size_t i = 0; i < 40; ++i) { grid.AdvanceGeneration(); }
+
+    //
+    // Every four generations the glider reappears shifted by (1, 1).
+    //
+    const auto LiveCells = grid.GetLiveCells();
+    ASSERT_EQ(LiveCells.size(), Glider.size());
+
+    std::vector<gol::CellAddress> expected;
+    for (const auto& Address : Glider)
+    {
+        expected.emplace_back(Address.first + 10, Address.second + 10);
+    }
+    std::sort(std::begin(expected), std::end(expected));
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+        ASSERT_EQ(LiveCells[i].Address, expected[i]);
+    }
+}
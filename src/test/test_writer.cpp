@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+
+#include <lib/Cell.h>
+#include <lib/GOLGrid.h>
+#include <lib/HashLifeGrid.h>
+#include <lib/LifeParser.h>
+#include <lib/LifeWriter.h>
+#include <lib/TiledGrid.h>
+
+#include "TestPatterns.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+
+template<typename GridType>
+static
+std::vector<gol::CellAddress> VisitLiveCells(const GridType& grid)
+{
+    std::vector<gol::CellAddress> visited;
+    grid.ForEachLiveCell([&visited](const gol::CellAddress& address)
+    {
+        visited.push_back(address);
+    });
+
+    std::sort(std::begin(visited), std::end(visited));
+    return visited;
+}
+
+TEST(LifeWriterTests, WritesLife106)
+{
+    std::FILE* pFile = std::tmpfile();
+    ASSERT_NE(pFile, nullptr);
+
+    {
+        //
+        // A tiny buffer forces several intermediate flushes.
+        //
+        gol::LifeWriter writer(pFile, 16);
+        writer.WriteSignature();
+        writer.WriteCell({ 0, 1 });
+        writer.WriteCell({ INT64_MIN, INT64_MAX });
+        writer.WriteCell({ -3, 40 });
+        ASSERT_TRUE(writer.Flush());
+    }
+
+    const std::string Expected =
+        std::string(gol::LifeSignature) + "\n"
+        "0 1\n"
+        "-9223372036854775808 9223372036854775807\n"
+        "-3 40";
+    ASSERT_EQ(ReadAll(pFile), Expected);
+
+    std::fclose(pFile);
+}
+
+TEST(LifeWriterTests, RoundTripsThroughParser)
+{
+    const auto Cells = GenerateSoup(-100, 100, 0.3, 8);
+
+    std::FILE* pFile = std::tmpfile();
+    ASSERT_NE(pFile, nullptr);
+
+    {
+        gol::LifeWriter writer(pFile, 1024);
+        writer.WriteSignature();
+        for (const auto& Address : Cells) { writer.WriteCell(Address); }
+    }
+
+    const std::string Text = ReadAll(pFile);
+    std::fclose(pFile);
+
+    std::vector<gol::CellAddress> parsed;
+    gol::LifeParseError error;
+    ASSERT_TRUE(gol::ParseLifeText(Text.data(), Text.size(), parsed, error));
+    ASSERT_EQ(parsed, Cells);
+}
+
+TEST(LifeWriterTests, VisitorsMatchLiveCells)
+{
+    const auto InitialCells = GenerateSoup(-40, 40, 0.3, 21);
+    gol::GOLGrid sparseGrid(InitialCells, 3);
+    gol::TiledGrid tiledGrid(InitialCells);
+    gol::HashLifeGrid hashLifeGrid(InitialCells);
+
+    for (size_t generation = 0; generation < 20; ++generation)
+    {
+        const auto Expected = AddressesOf(sparseGrid.GetLiveCells());
+        ASSERT_EQ(VisitLiveCells(sparseGrid), Expected) << generation;
+        ASSERT_EQ(VisitLiveCells(tiledGrid), Expected) << generation;
+        ASSERT_EQ(VisitLiveCells(hashLifeGrid), Expected) << generation;
+
+        sparseGrid.AdvanceGeneration();
+        tiledGrid.AdvanceGeneration();
+        hashLifeGrid.AdvanceGeneration();
+    }
+}